@@ -4,12 +4,16 @@
 #include <memory>
 #include <glog/logging.h>
 #include "wta/world/world_sampler.hpp"
+#include "wta/world/engine_event_bridge.hpp"
 #include "wta/exec/executor.hpp"
 #include "wta/exec/sequential_attack_test.hpp"
 #include "wta/orchestrator/orchestrator.hpp"
 #include "wta/net/solver_client.hpp"
 #include "wta/net/log_sink_zmq.hpp"
+#include "wta/net/control_server.hpp"
+#include "wta/core/runtime_params.hpp"
 #include "wta/world/event_bus.hpp"
+#include "wta/record/flight_recorder.hpp"
 
 
 int intercept::api_version() { //This is required for the plugin to work.
@@ -31,17 +35,29 @@ void intercept::pre_init() {
 using namespace intercept;
 
 namespace {
-// 测试开关：true 时启用顺序打击测试模式（不启动 Orchestrator / ZMQ 规划）
-// false 时运行正常的 Orchestrator + ZMQ 工作流
-constexpr bool kEnableSequentialAttackTest = true;
+// 飞行记录器：记录快照/事件/规划/执行指令到 wta_recordings/，用于事后回放
+constexpr bool kEnableFlightRecorder = true;
+// 影子求解器端点：非空时每个规划请求同时发往该端点，只记录延迟/适应度/一致度对比，不应用其结果
+constexpr const char* kShadowSolverEndpoint = "";
 }
 
 static std::unique_ptr<wta::net::ISolverClient> g_solver_client;
+static std::unique_ptr<wta::net::ISolverClient> g_shadow_solver_client;
+static std::unique_ptr<wta::world::EngineEventBridge> g_event_bridge;
 static std::unique_ptr<wta::world::IWorldSampler> g_sampler;
 static std::unique_ptr<wta::exec::IExecutor> g_executor;
 static std::unique_ptr<wta::orch::Orchestrator> g_orchestrator;
+static std::unique_ptr<wta::record::FlightRecorder> g_recorder;
+static std::unique_ptr<wta::world::IWorldSampler> g_rec_sampler;
+static std::unique_ptr<wta::net::ISolverClient> g_rec_solver_client;
+static std::unique_ptr<wta::exec::IExecutor> g_rec_executor;
 static wta::events::EventBus g_event_bus;
 static bool g_glog_initialized = false;
+// 测试开关（运行时参数 sequential_attack_test，在 post_init 时读取）：true 时启用顺序打击测试模式
+// （不启动 Orchestrator / ZMQ 规划），false 时运行正常的 Orchestrator + ZMQ 工作流
+static bool g_sequential_attack_test = false;
+// 运行时控制端点：任务运行中 get/set 节拍、限流、超时等参数
+static std::unique_ptr<wta::net::IControlServer> g_control_server;
 
 // 注意：不使用 on_frame() 回调，因为在该上下文中 sqf::get_pos() 可能返回缓存值
 // 采样在 Reporter 线程中进行，使用 invoker_lock 保证线程安全
@@ -82,9 +98,16 @@ void intercept::post_init() {
         g_glog_initialized = true;
     }
     LOG(INFO) << "WTA plugin post_init starting...";
+    
+    // 控制端点在两种模式下都启动，可在任务中切换下一次任务的模式
+    g_control_server = wta::net::make_zmq_control_server(wta::core::runtime_params());
+    if (!g_control_server->start()) {
+        LOG(WARNING) << "Control endpoint unavailable; runtime parameters keep their defaults";
+    }
 
     // ===== 顺序打击测试模式（仅用于验证 C++ 插件控制能力） =====
-    if (kEnableSequentialAttackTest) {
+    g_sequential_attack_test = wta::core::tunables().sequential_attack_test.load();
+    if (g_sequential_attack_test) {
         sqf::system_chat("WTA TEST: Sequential attack test mode enabled");
         sqf::diag_log("WTA TEST: Starting sequential attack test (no Orchestrator / ZMQ)");
         wta::test::start_sequential_attack_test();
@@ -134,9 +157,38 @@ void intercept::post_init() {
     wta::net::LogSinkManager::instance().enable();
     LOG(INFO) << "Log streaming enabled";
     
-    g_sampler = wta::world::make_intercept_world_sampler();
-    g_executor = wta::exec::make_intercept_executor();
-    g_orchestrator = std::make_unique<wta::orch::Orchestrator>(g_event_bus, *g_solver_client, *g_sampler, *g_executor);
+    // 引擎事件桥：采样时为平台/目标注册 Killed/Dammaged/Fired 处理器，推送事件到总线
+    g_event_bridge = wta::world::make_engine_event_bridge(g_event_bus);
+    g_event_bridge->start();
+    g_sampler = wta::world::make_intercept_world_sampler(g_event_bridge.get());
+    // 执行器的击毁通知由 Orchestrator 从它的订阅转发
+    g_executor = wta::exec::make_intercept_executor(true);
+    
+    wta::world::IWorldSampler* sampler = g_sampler.get();
+    wta::net::ISolverClient* solver_client = g_solver_client.get();
+    wta::exec::IExecutor* executor = g_executor.get();
+    if (kEnableFlightRecorder) {
+        g_recorder = std::make_unique<wta::record::FlightRecorder>();
+        if (g_recorder->open()) {
+            g_rec_sampler = wta::record::make_recording_sampler(*g_sampler, *g_recorder);
+            g_rec_solver_client = wta::record::make_recording_solver_client(*g_solver_client, *g_recorder);
+            g_rec_executor = wta::record::make_recording_executor(*g_executor, *g_recorder);
+            sampler = g_rec_sampler.get();
+            solver_client = g_rec_solver_client.get();
+            executor = g_rec_executor.get();
+            g_event_bus.set_tap([rec = g_recorder.get()](const wta::events::Event& ev) { rec->record_event(ev); });
+        } else {
+            g_recorder.reset();
+        }
+    }
+    g_orchestrator = std::make_unique<wta::orch::Orchestrator>(g_event_bus, *solver_client, *sampler, *executor);
+    if (kShadowSolverEndpoint[0] != '\0') {
+        wta::net::ZmqSolverClientOptions shadow_opts{};
+        shadow_opts.endpoint = kShadowSolverEndpoint;
+        g_shadow_solver_client = wta::net::make_zmq_solver_client(shadow_opts);
+        g_orchestrator->set_shadow_solver(g_shadow_solver_client.get());
+        LOG(INFO) << "Shadow solver enabled at " << kShadowSolverEndpoint;
+    }
     g_orchestrator->start();
     // LOG(INFO) << "WTA plugin initialized successfully";
     sqf::system_chat("WTA: Plugin initialized successfully!");
@@ -148,7 +200,7 @@ void intercept::mission_ended() {
     LOG(INFO) << "WTA plugin mission_ended - cleaning up resources...";
     
     // 1. 停止测试线程
-    if (kEnableSequentialAttackTest) {
+    if (g_sequential_attack_test) {
         wta::test::stop_sequential_attack_test();
         // 等待测试线程退出
         std::this_thread::sleep_for(std::chrono::milliseconds(500));
@@ -163,10 +215,34 @@ void intercept::mission_ended() {
     // 3. 关闭日志流
     wta::net::LogSinkManager::instance().shutdown();
     
-    // 4. 清理其他资源
+    // 4. 移除引擎事件处理器（当前在引擎线程上，无需 invoker_lock）
+    if (g_event_bridge) {
+        g_event_bridge->stop();
+        g_event_bridge->untrack_all();
+    }
+    
+    // 5. 关闭飞行记录器（先摘掉总线旁路，之后不再有写入）
+    g_event_bus.set_tap({});
+    g_rec_executor.reset();
+    g_rec_solver_client.reset();
+    g_rec_sampler.reset();
+    if (g_recorder) {
+        g_recorder->close();
+        g_recorder.reset();
+    }
+    
+    // 6. 清理其他资源
     g_executor.reset();
     g_sampler.reset();
+    g_event_bridge.reset();
     g_solver_client.reset();
+    g_shadow_solver_client.reset();
+    
+    // 7. 停止控制端点（下一次 post_init 重新绑定）
+    if (g_control_server) {
+        g_control_server->stop();
+        g_control_server.reset();
+    }
     
     LOG(INFO) << "WTA plugin cleanup complete";
 }
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+namespace wta::core {
+
+/**
+ * @brief 把引擎 Dammaged 回调给出的部位伤害等级换算为本次新增的伤害量
+ *
+ * Dammaged 的 damage 参数是被击中部位的新伤害等级（0~1），不是这次受到的伤害；
+ * 直接累加会让同一部位的多次命中无限放大。这里按部位记录上一次的等级，只返回增量
+ * （修复导致的等级下降返回 0）。槽位按载具的部位数在登记时一次分配，回调中不分配、
+ * 不加锁，只应在引擎线程中更新。
+ */
+class DamageLevels {
+public:
+    /**
+     * @param hit_points 载具的部位数（getAllHitPointsDamage 的条目数），另加一个整体伤害槽
+     */
+    explicit DamageLevels(size_t hit_points = 0) : levels_(hit_points + 1, 0.f) {}
+
+    // hit_index < 0 为整体伤害（selection ""）；超出部位数的索引没有基线可比，忽略
+    float on_level(int hit_index, float level) {
+        const size_t slot = hit_index < 0 ? 0 : static_cast<size_t>(hit_index) + 1;
+        if (slot >= levels_.size()) return 0.f;
+        const float prev = levels_[slot];
+        levels_[slot] = level;
+        return level > prev ? level - prev : 0.f;
+    }
+
+    size_t hit_points() const { return levels_.size() - 1; }
+
+private:
+    std::vector<float> levels_;
+};
+
+} // namespace wta::core
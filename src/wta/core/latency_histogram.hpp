@@ -0,0 +1,105 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+namespace wta::core {
+
+/**
+ * @brief 对数-线性延迟直方图（微秒，无锁）
+ *
+ * 0~7us 逐微秒计数；之后每个 2 的幂区间再均分 8 个子桶，相对误差约 12%。
+ * record 只做一次 relaxed 自增，可在任意线程的热路径中调用；
+ * 百分位按桶上界估算，读数与写入并发时是近似值。
+ */
+class LatencyHistogram {
+public:
+    static constexpr int kSubBits = 3;
+    static constexpr int kSub     = 1 << kSubBits;
+    static constexpr int kMaxLog2 = 36;   // 约 19 小时，更大的值计入最后一个桶
+    static constexpr size_t kBuckets = kSub + static_cast<size_t>(kMaxLog2 - kSubBits + 1) * kSub;
+
+    void record_us(uint64_t us) {
+        buckets_[bucket_of(us)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_us_.fetch_add(us, std::memory_order_relaxed);
+        uint64_t prev = max_us_.load(std::memory_order_relaxed);
+        while (us > prev && !max_us_.compare_exchange_weak(prev, us, std::memory_order_relaxed)) {}
+    }
+
+    // 负值（时钟抖动）按 0 计
+    void record_sec(double sec) {
+        record_us(sec > 0.0 ? static_cast<uint64_t>(sec * 1e6 + 0.5) : 0);
+    }
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t max_us() const { return max_us_.load(std::memory_order_relaxed); }
+    double mean_us() const {
+        const uint64_t n = count();
+        return n ? static_cast<double>(sum_us_.load(std::memory_order_relaxed)) / static_cast<double>(n) : 0.0;
+    }
+
+    /**
+     * @brief 估算百分位（p 取 0~100），返回所在桶的上界（不超过观测到的最大值）
+     */
+    uint64_t percentile_us(double p) const {
+        const uint64_t n = count();
+        if (n == 0) return 0;
+        const double clamped = std::min(std::max(p, 0.0), 100.0);
+        const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(clamped / 100.0 * static_cast<double>(n) + 0.5));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBuckets; ++i) {
+            seen += buckets_[i].load(std::memory_order_relaxed);
+            if (seen >= rank) return std::min(upper_bound_of(i), max_us());
+        }
+        return max_us();
+    }
+
+    void reset() {
+        for (auto& b : buckets_) b.store(0, std::memory_order_relaxed);
+        count_.store(0, std::memory_order_relaxed);
+        sum_us_.store(0, std::memory_order_relaxed);
+        max_us_.store(0, std::memory_order_relaxed);
+    }
+
+    // 日志用摘要："n=120 mean=85us p50=63us p90=191us p99=447us max=1203us"
+    std::string summary() const {
+        std::ostringstream os;
+        os << "n=" << count()
+           << " mean=" << static_cast<uint64_t>(mean_us() + 0.5) << "us"
+           << " p50=" << percentile_us(50) << "us"
+           << " p90=" << percentile_us(90) << "us"
+           << " p99=" << percentile_us(99) << "us"
+           << " max=" << max_us() << "us";
+        return os.str();
+    }
+
+    static size_t bucket_of(uint64_t us) {
+        if (us < static_cast<uint64_t>(kSub)) return static_cast<size_t>(us);
+        int log2 = 0;
+        for (uint64_t v = us; v > 1; v >>= 1) ++log2;
+        if (log2 > kMaxLog2) return kBuckets - 1;
+        const int shift = log2 - kSubBits;
+        const auto sub = static_cast<size_t>((us >> shift) & (kSub - 1));
+        return kSub + static_cast<size_t>(shift) * kSub + sub;
+    }
+
+    static uint64_t upper_bound_of(size_t idx) {
+        if (idx < static_cast<size_t>(kSub)) return idx;
+        const size_t shift = (idx - kSub) / kSub;
+        const uint64_t sub = (idx - kSub) % kSub;
+        const uint64_t lower = (static_cast<uint64_t>(kSub) + sub) << shift;
+        return lower + (uint64_t{1} << shift) - 1;
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, kBuckets> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_us_{0};
+    std::atomic<uint64_t> max_us_{0};
+};
+
+} // namespace wta::core
@@ -0,0 +1,44 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace wta::core {
+
+/**
+ * @brief 最新值优先的单槽邮箱（无锁）
+ *
+ * 生产者 publish() 用一次原子交换放入新对象，未被取走的旧对象直接丢弃；
+ * 消费者 take() 用一次原子交换取走所有权。对象发布后生产者不再持有，
+ * 因此消费者拿到的是不会被并发修改的完整对象。适合“只关心最新方案”的跨线程交接。
+ */
+template <class T>
+class LatestMailbox {
+public:
+    LatestMailbox() = default;
+    LatestMailbox(const LatestMailbox&) = delete;
+    LatestMailbox& operator=(const LatestMailbox&) = delete;
+    ~LatestMailbox() { delete slot_.exchange(nullptr, std::memory_order_acquire); }
+
+    // 返回 true 表示覆盖了一个尚未被取走的旧对象
+    bool publish(std::unique_ptr<T> value) {
+        T* old = slot_.exchange(value.release(), std::memory_order_acq_rel);
+        if (!old) return false;
+        delete old;
+        superseded_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    std::unique_ptr<T> take() {
+        return std::unique_ptr<T>(slot_.exchange(nullptr, std::memory_order_acq_rel));
+    }
+
+    bool pending() const { return slot_.load(std::memory_order_acquire) != nullptr; }
+    uint64_t superseded() const { return superseded_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<T*> slot_{nullptr};
+    std::atomic<uint64_t> superseded_{0};
+};
+
+} // namespace wta::core
@@ -0,0 +1,74 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace wta::core {
+
+/**
+ * @brief 有界多生产者/单消费者环形队列（无锁、无分配）
+ *
+ * 容量在构造时固定（向上取整为2的幂），push/pop 均不分配内存，
+ * 适合在引擎回调线程里投递紧凑事件。队列满时 push 返回 false。
+ * 算法参考 Vyukov 有界队列：每个槽位带序号，生产者用 CAS 抢占写位置。
+ */
+template <class T>
+class MpscRing {
+    static_assert(std::is_trivially_copyable_v<T>, "MpscRing requires trivially copyable payloads");
+
+public:
+    explicit MpscRing(size_t capacity) {
+        size_t cap = 2;
+        while (cap < capacity) cap <<= 1;
+        mask_  = cap - 1;
+        slots_ = std::make_unique<Slot[]>(cap);
+        for (size_t i = 0; i < cap; ++i) slots_[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    bool try_push(const T& v) {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot      = slots_[pos & mask_];
+            const size_t sq = slot.seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(sq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.value = v;
+                    slot.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // 已满
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // 仅允许单个消费者线程调用
+    bool try_pop(T& out) {
+        Slot& slot      = slots_[head_ & mask_];
+        const size_t sq = slot.seq.load(std::memory_order_acquire);
+        if (sq != head_ + 1) return false;
+        out = slot.value;
+        slot.seq.store(head_ + mask_ + 1, std::memory_order_release);
+        ++head_;
+        return true;
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    struct Slot {
+        std::atomic<size_t> seq{0};
+        T                   value{};
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t                  mask_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+    alignas(64) size_t head_{0};
+};
+
+} // namespace wta::core
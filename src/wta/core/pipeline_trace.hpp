@@ -0,0 +1,121 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include "latency_histogram.hpp"
+
+namespace wta::core {
+
+/**
+ * @brief 规划流水线阶段（按先后顺序）
+ *
+ * 每个阶段的耗时 = 本阶段结束时刻 - 上一个已到达阶段的结束时刻（首个阶段从触发事件发布算起）。
+ */
+enum class TraceStage : uint8_t {
+    Pickup,         // 事件发布 -> 规划线程取出
+    Trigger,        // 取出 -> 决定发出求解（去抖/节流/等待在途请求）
+    Sample,         // 获取世界快照
+    Serialize,      // 序列化请求
+    RoundTrip,      // 发送 -> 收到求解响应
+    Handoff,        // 响应 -> 执行线程校验后调用 apply_assignment
+    FirstCommand,   // apply_assignment -> 该方案的第一条 UAV 控制命令
+    Count
+};
+
+constexpr size_t kTraceStageCount = static_cast<size_t>(TraceStage::Count);
+
+inline const char* to_string(TraceStage stage) {
+    switch (stage) {
+        case TraceStage::Pickup:       return "pickup";
+        case TraceStage::Trigger:      return "trigger";
+        case TraceStage::Sample:       return "sample";
+        case TraceStage::Serialize:    return "serialize";
+        case TraceStage::RoundTrip:    return "round_trip";
+        case TraceStage::Handoff:      return "handoff";
+        case TraceStage::FirstCommand: return "first_command";
+        case TraceStage::Count:        break;
+    }
+    return "unknown";
+}
+
+// 与事件时间戳相同的时基（steady 时钟秒）
+inline double trace_now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief 随一次规划在各线程间传递的追踪上下文（值类型，随 PlanJob/PlanResult 拷贝）
+ */
+struct TraceContext {
+    uint64_t id{0};          // 0 表示不追踪（如推测求解）
+    double origin{0.0};      // 触发时刻：最早的触发事件发布时间，或 TTL 到期时间
+    std::array<double, kTraceStageCount> at{};   // 各阶段结束时刻，0 表示未经过
+
+    explicit operator bool() const { return id != 0; }
+    void mark(TraceStage stage, double t = trace_now()) { at[static_cast<size_t>(stage)] = t; }
+    bool reached(TraceStage stage) const { return at[static_cast<size_t>(stage)] > 0.0; }
+};
+
+/**
+ * @brief 当前线程正在处理的追踪（供序列化等下层代码打点，不需要改接口传参）
+ */
+inline TraceContext*& current_trace() {
+    static thread_local TraceContext* current = nullptr;
+    return current;
+}
+
+class TraceScope {
+public:
+    explicit TraceScope(TraceContext* ctx) : prev_(current_trace()) { current_trace() = ctx; }
+    ~TraceScope() { current_trace() = prev_; }
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    TraceContext* prev_;
+};
+
+// 在当前线程的追踪上打点（无追踪时为空操作）
+inline void trace_mark(TraceStage stage) {
+    if (auto* ctx = current_trace(); ctx && *ctx) ctx->mark(stage);
+}
+
+/**
+ * @brief 各阶段及端到端耗时直方图（无锁，可在任意线程 record）
+ */
+class PipelineTrace {
+public:
+    // 记录一条完成的追踪；未经过的阶段跳过，其耗时计入下一个已到达的阶段
+    void record(const TraceContext& ctx) {
+        if (!ctx) return;
+        double prev = ctx.origin;
+        for (size_t i = 0; i < kTraceStageCount; ++i) {
+            if (ctx.at[i] <= 0.0) continue;
+            stages_[i].record_sec(ctx.at[i] - prev);
+            prev = ctx.at[i];
+        }
+        total_.record_sec(prev - ctx.origin);
+    }
+
+    const LatencyHistogram& stage(TraceStage s) const { return stages_[static_cast<size_t>(s)]; }
+    const LatencyHistogram& total() const { return total_; }
+
+    // 日志用：每阶段 p50/p99 与端到端摘要
+    std::string summary() const {
+        std::ostringstream os;
+        os << "total[" << total_.summary() << "]";
+        for (size_t i = 0; i < kTraceStageCount; ++i) {
+            os << " " << to_string(static_cast<TraceStage>(i)) << "=" << stages_[i].percentile_us(50) << "/"
+               << stages_[i].percentile_us(99) << "us";
+        }
+        return os.str();
+    }
+
+private:
+    std::array<LatencyHistogram, kTraceStageCount> stages_{};
+    LatencyHistogram total_;
+};
+
+} // namespace wta::core
@@ -0,0 +1,167 @@
+#include "runtime_params.hpp"
+#include <chrono>
+#include <sstream>
+
+namespace wta::core {
+
+namespace {
+
+constexpr size_t kAuditCapacity = 64;
+
+double steady_now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool parse_bool(const std::string& s, bool& out) {
+    if (s == "1" || s == "true" || s == "on") { out = true; return true; }
+    if (s == "0" || s == "false" || s == "off") { out = false; return true; }
+    return false;
+}
+
+bool parse_int(const std::string& s, int& out) {
+    try {
+        size_t used = 0;
+        const long v = std::stol(s, &used);
+        if (used != s.size() || v < INT32_MIN || v > INT32_MAX) return false;
+        out = static_cast<int>(v);
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+} // namespace
+
+Tunables& tunables() {
+    static Tunables t;
+    return t;
+}
+
+RuntimeParams& runtime_params() {
+    static RuntimeParams p(tunables());
+    return p;
+}
+
+RuntimeParams::RuntimeParams(Tunables& t) {
+    params_ = {
+        {"sequential_attack_test", ParamType::Bool, &t.sequential_attack_test, nullptr, 0, 1,
+         "顺序打击测试模式，下一次任务开始时生效"},
+        {"exec.max_tasks_per_tick", ParamType::Int, nullptr, &t.exec_max_tasks_per_tick, 0, 1000,
+         "每个 tick 最多推进的任务数，0 不限"},
+        {"exec.tick_ms", ParamType::Int, nullptr, &t.exec_tick_ms, 5, 2000, "执行线程最小 tick 间隔"},
+        {"solve.throttle_ms", ParamType::Int, nullptr, &t.solve_throttle_ms, 0, 10000, "非推测求解最小间隔"},
+        {"solve.timeout_ms", ParamType::Int, nullptr, &t.solve_timeout_ms, 100, 60000, "规划请求超时"},
+        {"plan.max_follow_ons", ParamType::Int, nullptr, &t.plan_max_follow_ons, 0, 16,
+         "每个平台向求解器请求的后续交战数（0 为单步方案）"},
+        {"plan.local_repair", ParamType::Bool, &t.plan_local_repair, nullptr, 0, 1,
+         "目标被毁时本地改派空出的平台，不等完整求解"},
+        {"world.bulk_sample", ParamType::Bool, &t.world_bulk_sample, nullptr, 0, 1,
+         "一次 SQF 调用批量采样全部实体（关闭则逐实体查询）"},
+        {"world.slice_budget_us", ParamType::Int, nullptr, &t.world_slice_budget_us, 0, 100000,
+         "分片采样每片持锁预算（微秒），0 为整轮一次持锁"},
+        {"test.tick_ms", ParamType::Int, nullptr, &t.test_tick_ms, 10, 10000, "顺序打击测试 tick 间隔"},
+        {"test.target_delay_ms", ParamType::Int, nullptr, &t.test_target_delay_ms, 0, 60000,
+         "顺序打击测试切换目标前的等待"},
+    };
+}
+
+const RuntimeParams::Param* RuntimeParams::find(const std::string& name) const {
+    for (const auto& p : params_) {
+        if (name == p.name) return &p;
+    }
+    return nullptr;
+}
+
+std::string RuntimeParams::read(const Param& p) {
+    if (p.type == ParamType::Bool) return p.b->load() ? "true" : "false";
+    return std::to_string(p.i->load());
+}
+
+bool RuntimeParams::get(const std::string& name, std::string& value) const {
+    const auto* p = find(name);
+    if (!p) return false;
+    value = read(*p);
+    return true;
+}
+
+std::string RuntimeParams::set(const std::string& name, const std::string& value, const std::string& source) {
+    const auto* p = find(name);
+    if (!p) return "unknown parameter " + name;
+
+    ParamChange change;
+    AuditSink sink;
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        change.old_value = read(*p);
+        if (p->type == ParamType::Bool) {
+            bool v = false;
+            if (!parse_bool(value, v)) return "expected bool for " + name;
+            p->b->store(v);
+        } else {
+            int v = 0;
+            if (!parse_int(value, v)) return "expected int for " + name;
+            if (v < p->min || v > p->max) {
+                return name + " out of range [" + std::to_string(p->min) + "," + std::to_string(p->max) + "]";
+            }
+            p->i->store(v);
+        }
+        change.timestamp = steady_now();
+        change.name = name;
+        change.new_value = read(*p);
+        change.source = source;
+        audit_.push_back(change);
+        if (audit_.size() > kAuditCapacity) audit_.pop_front();
+        sink = sink_;
+    }
+    if (sink) sink(change);
+    return {};
+}
+
+std::string RuntimeParams::execute(const std::string& command, const std::string& source) {
+    std::istringstream in(command);
+    std::string verb, name, value;
+    in >> verb >> name >> value;
+    std::ostringstream out;
+
+    if (verb == "get") {
+        std::string v;
+        if (!get(name, v)) return "error unknown parameter " + name;
+        out << "ok " << name << "=" << v;
+    } else if (verb == "set") {
+        if (name.empty() || value.empty()) return "error usage: set <name> <value>";
+        std::string old;
+        get(name, old);
+        const auto err = set(name, value, source);
+        if (!err.empty()) return "error " + err;
+        std::string now;
+        get(name, now);
+        out << "ok " << name << "=" << now << " (was " << old << ")";
+    } else if (verb == "list") {
+        out << "ok";
+        for (const auto& p : params_) {
+            out << "\n" << p.name << "=" << read(p) << " " << (p.type == ParamType::Bool ? "bool" : "int")
+                << " [" << p.min << "," << p.max << "] " << p.doc;
+        }
+    } else if (verb == "audit") {
+        out << "ok";
+        for (const auto& c : audit()) {
+            out << "\n" << c.timestamp << " " << c.source << " " << c.name << ": " << c.old_value << " -> "
+                << c.new_value;
+        }
+    } else {
+        return "error unknown command '" + verb + "' (get/set/list/audit)";
+    }
+    return out.str();
+}
+
+std::vector<ParamChange> RuntimeParams::audit() const {
+    std::lock_guard<std::mutex> lk(m_);
+    return {audit_.begin(), audit_.end()};
+}
+
+void RuntimeParams::set_audit_sink(AuditSink sink) {
+    std::lock_guard<std::mutex> lk(m_);
+    sink_ = std::move(sink);
+}
+
+} // namespace wta::core
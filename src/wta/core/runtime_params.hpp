@@ -0,0 +1,93 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace wta::core {
+
+/**
+ * @brief 可在任务运行中调整的参数（各组件每次使用时读取，修改立即生效）
+ *
+ * 只放需要在线调优的节拍/限流/超时类参数；单个值的读写是原子的，
+ * 组件不应缓存读到的值。sequential_attack_test 只在下一次任务开始时生效。
+ */
+struct Tunables {
+    std::atomic<bool> sequential_attack_test{true};   // 顺序打击测试模式（下一次 post_init 生效）
+    std::atomic<int>  exec_max_tasks_per_tick{2};     // 执行器每个 tick 最多推进的任务数（<=0 不限）
+    std::atomic<int>  exec_tick_ms{50};               // 执行线程有进行中任务时的最小 tick 间隔
+    std::atomic<int>  solve_throttle_ms{500};         // 两次非推测求解之间的最小间隔
+    std::atomic<int>  solve_timeout_ms{1000};         // 规划请求超时
+    std::atomic<int>  plan_max_follow_ons{3};         // 每个平台请求的后续交战数（多步方案）
+    std::atomic<bool> plan_local_repair{true};        // 目标被毁时在执行线程本地改派空出的平台
+    std::atomic<bool> world_bulk_sample{true};        // 采样用一次预编译 SQF 调用取回全部实体状态
+    std::atomic<int>  world_slice_budget_us{0};       // >0 时分片采样，每次持 invoker_lock 不超过该时长
+    std::atomic<int>  test_tick_ms{500};              // 顺序打击测试：tick 间隔
+    std::atomic<int>  test_target_delay_ms{1000};     // 顺序打击测试：切换目标前的等待
+};
+
+Tunables& tunables();
+
+enum class ParamType : uint8_t { Bool, Int };
+
+/**
+ * @brief 一次参数修改的审计记录
+ */
+struct ParamChange {
+    double timestamp{0.0};    // steady 时钟秒，与事件时间戳一致
+    std::string name;
+    std::string old_value;
+    std::string new_value;
+    std::string source;       // 修改来源（如控制端点的对端标识）
+};
+
+/**
+ * @brief 运行时参数表：按名字对 Tunables 做带类型与范围检查的读写，并记录审计
+ *
+ * 文本命令（控制端点逐条转交）：
+ *   get <name>           -> "ok <name>=<value>"
+ *   set <name> <value>   -> "ok <name>=<value> (was <old>)"
+ *   list                 -> 每行 "<name>=<value> <type> [min,max] <说明>"
+ *   audit                -> 最近的修改记录
+ * 失败时返回 "error <原因>"。
+ */
+class RuntimeParams {
+public:
+    using AuditSink = std::function<void(const ParamChange&)>;
+
+    explicit RuntimeParams(Tunables& t);
+
+    bool get(const std::string& name, std::string& value) const;
+    // 成功返回空串，否则返回错误原因
+    std::string set(const std::string& name, const std::string& value, const std::string& source);
+    std::string execute(const std::string& command, const std::string& source);
+
+    std::vector<ParamChange> audit() const;
+    void set_audit_sink(AuditSink sink);
+
+private:
+    struct Param {
+        const char* name;
+        ParamType type;
+        std::atomic<bool>* b;
+        std::atomic<int>* i;
+        int min;
+        int max;
+        const char* doc;
+    };
+
+    const Param* find(const std::string& name) const;
+    static std::string read(const Param& p);
+
+    std::vector<Param> params_;
+    mutable std::mutex m_;            // 串行化 set 与审计，读参数本身不需要锁
+    std::deque<ParamChange> audit_;
+    AuditSink sink_;
+};
+
+RuntimeParams& runtime_params();
+
+} // namespace wta::core
@@ -0,0 +1,52 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+namespace wta::core {
+
+/**
+ * @brief 分片处理的时间预算：判断当前片能否再处理一项而不超出预算
+ *
+ * 每片开始调用 begin()，每处理完一项调用 next()。按每项耗时的指数滑动平均估算下一项，
+ * 预计会超出预算时返回 false，调用方结束本片（释放锁）后再开始下一片。
+ * 估算跨片保留；每片至少处理一项以保证进度，单项本身超出预算时由调用方统计。
+ * 只在一个线程中使用。
+ */
+class SliceBudget {
+public:
+    using clock = std::chrono::steady_clock;
+
+    explicit SliceBudget(std::chrono::microseconds budget) : budget_us_(static_cast<double>(budget.count())) {}
+
+    void set_budget(std::chrono::microseconds budget) { budget_us_ = static_cast<double>(budget.count()); }
+
+    void begin(clock::time_point now) {
+        start_ = now;
+        last_ = now;
+        items_ = 0;
+    }
+
+    // 本片刚处理完一项：返回 true 表示下一项预计仍在预算内
+    bool next(clock::time_point now) {
+        const double cost = std::chrono::duration<double, std::micro>(now - last_).count();
+        estimate_us_ = estimate_us_ > 0.0 ? estimate_us_ + kAlpha * (cost - estimate_us_) : cost;
+        last_ = now;
+        ++items_;
+        const double elapsed = std::chrono::duration<double, std::micro>(now - start_).count();
+        return elapsed + estimate_us_ <= budget_us_;
+    }
+
+    uint32_t items() const { return items_; }
+    double estimate_us() const { return estimate_us_; }
+
+private:
+    static constexpr double kAlpha = 0.25;
+
+    double budget_us_;
+    double estimate_us_{0.0};   // 每项耗时估算
+    clock::time_point start_{};
+    clock::time_point last_{};
+    uint32_t items_{0};
+};
+
+} // namespace wta::core
@@ -48,6 +48,8 @@ struct StatusReportEvent {
     double timestamp{0.0};
     std::vector<wta::types::PlatformState> platforms;
     std::vector<wta::types::TargetState> targets;
+    double report_interval_sec{0.0};  // 当前自适应上报间隔
+    std::string report_reason;        // 间隔取值原因
 };
 
 // 单位击毁事件
@@ -101,6 +103,9 @@ struct PlanRequest {
     wta::config::SolveConfig config{};
     std::vector<wta::types::PlatformState> platforms;
     std::vector<wta::types::TargetState> targets;
+    uint64_t snapshot_version{0};  // 采样快照版本
+    int max_follow_ons{0};         // 每个平台最多返回的后续交战数，0 表示只要单步分配
+    int cluster_index{-1};         // 分区求解时的簇序号，-1 表示整体请求（仅本地使用，不发给求解器）
 };
 
 // 规划统计
@@ -111,6 +116,18 @@ struct PlanStats {
     double coverage_rate{0.0};
 };
 
+// 后续交战：平台结束当前交战后由执行器本地推进，无需回到求解器
+struct FollowOnEngagement {
+    wta::types::TargetId target_id{0};
+    wta::types::TargetId after_target_id{0};  // 该目标被摧毁后才开始；0 表示前一项结束即开始
+};
+
+// 单个平台的后续交战队列（排在 assignment 给出的当前目标之后）
+struct EngagementQueue {
+    wta::types::PlatformId platform_id{0};
+    std::vector<FollowOnEngagement> steps;
+};
+
 // WTA规划响应
 struct PlanResponse {
     std::string type{"plan_response"};
@@ -123,6 +140,8 @@ struct PlanResponse {
     PlanStats stats{};
     double ttl_sec{2.0};  // 规划有效期（秒）
     std::string error_msg;  // 错误信息（如果有）
+    uint64_t snapshot_version{0};  // 方案所基于的快照版本（0 表示求解器未回填）
+    std::vector<EngagementQueue> follow_ons;  // 多步方案（平台/目标为实体 ID）；为空时为单步分配
 };
 
 // ==================== 兼容旧接口（废弃） ====================
@@ -0,0 +1,65 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace wta::core {
+
+using InternId = uint32_t;
+
+constexpr InternId kInvalidInternId = 0;
+
+/**
+ * @brief 字符串驻留表 - 把重复出现的名称（武器、弹药类名）映射为紧凑整数ID
+ *
+ * 只有首次出现的字符串会分配内存；之后的查找以 string_view 为键，不分配。
+ * ID 从 1 开始，0 保留为无效值。ID 在进程生命周期内稳定。
+ */
+class StringInterner {
+public:
+    InternId intern(std::string_view s) {
+        if (s.empty()) return kInvalidInternId;
+        {
+            std::shared_lock<std::shared_mutex> lk(m_);
+            auto it = ids_.find(s);
+            if (it != ids_.end()) return it->second;
+        }
+        std::unique_lock<std::shared_mutex> lk(m_);
+        auto it = ids_.find(s);
+        if (it != ids_.end()) return it->second;
+        // deque 保证已存储字符串地址稳定，string_view 键始终有效
+        const auto& stored = names_.emplace_back(s);
+        const auto id = static_cast<InternId>(names_.size());
+        ids_.emplace(std::string_view(stored), id);
+        return id;
+    }
+
+    // 未知 ID 返回空字符串
+    std::string_view lookup(InternId id) const {
+        std::shared_lock<std::shared_mutex> lk(m_);
+        if (id == kInvalidInternId || id > names_.size()) return {};
+        return names_[id - 1];
+    }
+
+    size_t size() const {
+        std::shared_lock<std::shared_mutex> lk(m_);
+        return names_.size();
+    }
+
+private:
+    mutable std::shared_mutex m_;
+    std::deque<std::string> names_;
+    std::unordered_map<std::string_view, InternId> ids_;
+};
+
+// 全局武器名称表（FiredEvent 只携带 ID）
+inline StringInterner& weapon_names() {
+    static StringInterner table;
+    return table;
+}
+
+} // namespace wta::core
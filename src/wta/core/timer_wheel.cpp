@@ -0,0 +1,313 @@
+#include "timer_wheel.hpp"
+
+#include <algorithm>
+
+namespace wta::core {
+
+namespace {
+// 最高层能表达的最大延迟（tick）
+constexpr uint64_t kMaxDelta = (uint64_t(1) << (8 + 3 * 6)) - 1;
+} // namespace
+
+TimerWheel::TimerWheel() : origin_(clock::now()) {
+    root_.fill(kNil);
+    for (auto& level : levels_) level.fill(kNil);
+}
+
+TimerWheel::~TimerWheel() {
+    stop();
+}
+
+void TimerWheel::start() {
+    std::lock_guard<std::mutex> lk(m_);
+    if (running_) return;
+    running_ = true;
+    th_ = std::thread(&TimerWheel::thread_loop, this);
+}
+
+// 不可在定时器回调内调用（会 join 自身）
+void TimerWheel::stop() {
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        if (!running_) return;
+        running_ = false;
+    }
+    cv_.notify_all();
+    if (th_.joinable()) th_.join();
+}
+
+TimerId TimerWheel::schedule_after(std::chrono::milliseconds delay, Callback cb) {
+    return schedule_at(clock::now() + std::max(delay, std::chrono::milliseconds(0)), std::move(cb));
+}
+
+TimerId TimerWheel::schedule_at(clock::time_point when, Callback cb) {
+    TimerId id;
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        id = arm_locked(to_tick(when), 0, std::move(cb));
+    }
+    cv_.notify_one();
+    return id;
+}
+
+TimerId TimerWheel::schedule_every(std::chrono::milliseconds period,
+                                   Callback cb,
+                                   std::chrono::milliseconds first_delay) {
+    const auto p = std::max(period, std::chrono::milliseconds(1));
+    const auto first = first_delay.count() < 0 ? p : first_delay;
+    TimerId id;
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        id = arm_locked(to_tick(clock::now() + first), static_cast<uint64_t>(p.count()), std::move(cb));
+    }
+    cv_.notify_one();
+    return id;
+}
+
+bool TimerWheel::cancel(TimerId id) {
+    if (id == kInvalidTimer) return false;
+    const auto idx = static_cast<uint32_t>(id & 0xFFFFFFFFu);
+    const auto gen = static_cast<uint32_t>(id >> 32);
+
+    std::lock_guard<std::mutex> lk(m_);
+    if (idx >= nodes_.size()) return false;
+    Node& n = nodes_[idx];
+    if (n.generation != gen) return false;
+
+    if (n.state == NodeState::Armed) {
+        unlink_locked(static_cast<int32_t>(idx));
+        --armed_;
+        free_node_locked(static_cast<int32_t>(idx));
+        return true;
+    }
+    if (n.state == NodeState::Firing) {
+        n.cancel_requested = true;
+        return n.period != 0;
+    }
+    return false;
+}
+
+size_t TimerWheel::advance_to(clock::time_point now) {
+    std::vector<Expired> expired;
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        if (now < origin_) return 0;
+        collect_expired_locked(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(now - origin_).count()), expired);
+    }
+    return run_expired(expired);
+}
+
+size_t TimerWheel::pending() const {
+    std::lock_guard<std::mutex> lk(m_);
+    return armed_;
+}
+
+TimerWheel::clock::time_point TimerWheel::next_wakeup() const {
+    std::lock_guard<std::mutex> lk(m_);
+    return next_wakeup_locked();
+}
+
+// 向上取整，保证回调不会早于请求的时间点触发
+uint64_t TimerWheel::to_tick(clock::time_point t) const {
+    if (t <= origin_) return 0;
+    const auto us = std::chrono::duration_cast<std::chrono::microseconds>(t - origin_).count();
+    return static_cast<uint64_t>((us + 999) / 1000);
+}
+
+TimerWheel::clock::time_point TimerWheel::to_time(uint64_t tick) const {
+    return origin_ + std::chrono::milliseconds(static_cast<int64_t>(tick));
+}
+
+TimerId TimerWheel::arm_locked(uint64_t expires, uint64_t period, Callback cb) {
+    const int32_t idx = alloc_node_locked();
+    Node& n = nodes_[idx];
+    n.expires = std::max(expires, current_);
+    n.period = period;
+    n.cb = std::move(cb);
+    n.state = NodeState::Armed;
+    n.cancel_requested = false;
+    link_locked(idx);
+    ++armed_;
+    return (static_cast<uint64_t>(n.generation) << 32) | static_cast<uint32_t>(idx);
+}
+
+int32_t TimerWheel::alloc_node_locked() {
+    if (free_head_ != kNil) {
+        const int32_t idx = free_head_;
+        free_head_ = nodes_[idx].next;
+        nodes_[idx].next = kNil;
+        return idx;
+    }
+    nodes_.emplace_back();
+    return static_cast<int32_t>(nodes_.size() - 1);
+}
+
+void TimerWheel::free_node_locked(int32_t idx) {
+    Node& n = nodes_[idx];
+    n.cb = nullptr;
+    n.state = NodeState::Free;
+    n.cancel_requested = false;
+    n.level = -1;
+    n.slot = -1;
+    n.prev = kNil;
+    if (++n.generation == 0) n.generation = 1;   // 代数 0 保留给无效ID
+    n.next = free_head_;
+    free_head_ = idx;
+}
+
+int32_t& TimerWheel::head(int level, uint32_t slot) {
+    return level == 0 ? root_[slot] : levels_[level - 1][slot];
+}
+
+void TimerWheel::link_locked(int32_t idx) {
+    Node& n = nodes_[idx];
+    if (n.expires < current_) n.expires = current_;
+    uint64_t delta = n.expires - current_;
+    if (delta > kMaxDelta) {
+        delta = kMaxDelta;
+        n.expires = current_ + kMaxDelta;
+    }
+
+    int level = 0;
+    uint32_t slot;
+    if (delta < kRootSlots) {
+        slot = static_cast<uint32_t>(n.expires & (kRootSlots - 1));
+    } else {
+        level = 1;
+        while (level < kLevels - 1 && delta >= (uint64_t(1) << (kRootBits + level * kLevelBits))) ++level;
+        slot = static_cast<uint32_t>((n.expires >> (kRootBits + (level - 1) * kLevelBits)) & (kLevelSlots - 1));
+    }
+
+    int32_t& h = head(level, slot);
+    n.level = static_cast<int16_t>(level);
+    n.slot = static_cast<int16_t>(slot);
+    n.prev = kNil;
+    n.next = h;
+    if (h != kNil) nodes_[h].prev = idx;
+    h = idx;
+}
+
+void TimerWheel::unlink_locked(int32_t idx) {
+    Node& n = nodes_[idx];
+    if (n.prev != kNil) {
+        nodes_[n.prev].next = n.next;
+    } else {
+        head(n.level, static_cast<uint32_t>(n.slot)) = n.next;
+    }
+    if (n.next != kNil) nodes_[n.next].prev = n.prev;
+    n.prev = n.next = kNil;
+    n.level = -1;
+    n.slot = -1;
+}
+
+// 把上层当前槽的定时器重新挂到下层，返回该槽下标（为 0 时需继续级联更上一层）
+uint32_t TimerWheel::cascade_locked(int level) {
+    const uint32_t slot = static_cast<uint32_t>(
+        (current_ >> (kRootBits + (level - 1) * kLevelBits)) & (kLevelSlots - 1));
+    int32_t i = head(level, slot);
+    head(level, slot) = kNil;
+    while (i != kNil) {
+        const int32_t next = nodes_[i].next;
+        link_locked(i);
+        i = next;
+    }
+    return slot;
+}
+
+void TimerWheel::collect_expired_locked(uint64_t now_tick, std::vector<Expired>& out) {
+    while (current_ <= now_tick) {
+        if (armed_ == 0) {
+            // 没有定时器时直接跳过空闲时间
+            current_ = now_tick + 1;
+            return;
+        }
+        const uint32_t index = static_cast<uint32_t>(current_ & (kRootSlots - 1));
+        if (index == 0) {
+            for (int level = 1; level < kLevels; ++level) {
+                if (cascade_locked(level) != 0) break;
+            }
+        }
+
+        int32_t i = root_[index];
+        root_[index] = kNil;
+        while (i != kNil) {
+            Node& n = nodes_[i];
+            const int32_t next = n.next;
+            n.prev = n.next = kNil;
+            n.level = -1;
+            n.slot = -1;
+            n.state = NodeState::Firing;
+            --armed_;
+            out.push_back(Expired{i, n.generation, std::move(n.cb)});
+            i = next;
+        }
+        ++current_;
+    }
+}
+
+void TimerWheel::finish_fired_locked(Expired& e) {
+    Node& n = nodes_[e.index];
+    if (n.generation != e.generation || n.state != NodeState::Firing) return;
+    if (n.period == 0 || n.cancel_requested) {
+        free_node_locked(e.index);
+        return;
+    }
+    // 周期定时器：按原节拍重新挂入，落后时从当前 tick 开始
+    n.cb = std::move(e.cb);
+    n.expires += n.period;
+    n.state = NodeState::Armed;
+    link_locked(e.index);
+    ++armed_;
+}
+
+size_t TimerWheel::run_expired(std::vector<Expired>& expired) {
+    if (expired.empty()) return 0;
+    for (auto& e : expired) {
+        if (e.cb) e.cb();
+    }
+    const size_t fired = expired.size();
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        for (auto& e : expired) finish_fired_locked(e);
+    }
+    expired.clear();
+    return fired;
+}
+
+TimerWheel::clock::time_point TimerWheel::next_wakeup_locked() const {
+    if (armed_ == 0) return clock::time_point::max();
+    const uint32_t base = static_cast<uint32_t>(current_ & (kRootSlots - 1));
+    // 处于级联点时必须先处理该 tick，上层的定时器才会落到根层
+    if (base == 0) return to_time(current_);
+    for (uint32_t i = 0; base + i < kRootSlots; ++i) {
+        if (root_[base + i] != kNil) return to_time(current_ + i);
+    }
+    return to_time(current_ + (kRootSlots - base));
+}
+
+void TimerWheel::thread_loop() {
+    std::vector<Expired> expired;
+    std::unique_lock<std::mutex> lk(m_);
+    while (running_) {
+        const auto now = clock::now();
+        if (now >= origin_) {
+            collect_expired_locked(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::milliseconds>(now - origin_).count()), expired);
+        }
+        if (!expired.empty()) {
+            lk.unlock();
+            run_expired(expired);
+            lk.lock();
+            continue;
+        }
+        const auto wake = next_wakeup_locked();
+        if (wake == clock::time_point::max()) {
+            cv_.wait(lk);
+        } else {
+            cv_.wait_until(lk, wake);
+        }
+    }
+}
+
+} // namespace wta::core
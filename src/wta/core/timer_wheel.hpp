@@ -0,0 +1,144 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace wta::core {
+
+// 高32位为代数（generation），低32位为节点下标；0 为无效ID
+using TimerId = uint64_t;
+
+constexpr TimerId kInvalidTimer = 0;
+
+/**
+ * @brief 分层时间轮 - 毫秒精度的一次性/周期性定时器
+ *
+ * - 4 层：256 槽 × 1ms，其余 3 层各 64 槽（覆盖约 18 小时，更远的到期时间会被截断）
+ * - 插入、取消均为 O(1)（槽内为侵入式双向链表，节点按下标寻址）
+ * - 两种驱动方式：
+ *   1. start() 启动内部线程，睡眠到下一个到期点（无周期扫描），回调在该线程执行
+ *   2. 不启动线程，由调用方在自己的线程里调用 advance_to()，回调同步执行
+ * - 回调在锁外执行，回调中可以安全地 schedule/cancel
+ */
+class TimerWheel {
+public:
+    using clock    = std::chrono::steady_clock;
+    using Callback = std::function<void()>;
+
+    TimerWheel();
+    ~TimerWheel();
+
+    TimerWheel(const TimerWheel&)            = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    void start();
+    void stop();
+    bool running() const { return running_; }
+
+    TimerId schedule_after(std::chrono::milliseconds delay, Callback cb);
+    TimerId schedule_at(clock::time_point when, Callback cb);
+
+    /**
+     * @brief 周期性定时器
+     * @param period 周期（至少 1ms）
+     * @param first_delay 首次触发延迟，负值表示等于 period
+     */
+    TimerId schedule_every(std::chrono::milliseconds period,
+                           Callback cb,
+                           std::chrono::milliseconds first_delay = std::chrono::milliseconds(-1));
+
+    // 到期时把事件发布到总线（Bus 需提供 publish(Ev)）
+    template <class Bus, class Ev>
+    TimerId publish_after(std::chrono::milliseconds delay, Bus& bus, Ev ev) {
+        return schedule_after(delay, [&bus, ev]() { bus.publish(ev); });
+    }
+
+    /**
+     * @brief 取消定时器（O(1)）
+     * @return 定时器仍处于等待状态并被取消时返回 true；正在执行的周期定时器会在本次回调后停止
+     */
+    bool cancel(TimerId id);
+
+    /**
+     * @brief 推进时间轮并同步执行所有到期回调（手动驱动模式）
+     * @return 执行的回调数量
+     */
+    size_t advance_to(clock::time_point now);
+
+    size_t pending() const;
+
+    // 下一个需要醒来处理的时间点（可能是层间级联点）；无定时器时返回 time_point::max()
+    clock::time_point next_wakeup() const;
+
+private:
+    static constexpr int      kLevels     = 4;
+    static constexpr uint32_t kRootBits   = 8;
+    static constexpr uint32_t kLevelBits  = 6;
+    static constexpr uint32_t kRootSlots  = 1u << kRootBits;
+    static constexpr uint32_t kLevelSlots = 1u << kLevelBits;
+    static constexpr int32_t  kNil        = -1;
+
+    enum class NodeState : uint8_t
+    {
+        Free,
+        Armed,
+        Firing
+    };
+
+    struct Node {
+        uint64_t  expires{0};
+        uint64_t  period{0};   // 0 = 一次性
+        Callback  cb;
+        uint32_t  generation{1};
+        int32_t   prev{kNil};
+        int32_t   next{kNil};
+        int16_t   level{-1};
+        int16_t   slot{-1};
+        NodeState state{NodeState::Free};
+        bool      cancel_requested{false};
+    };
+
+    struct Expired {
+        int32_t  index;
+        uint32_t generation;
+        Callback cb;
+    };
+
+    uint64_t to_tick(clock::time_point t) const;
+    clock::time_point to_time(uint64_t tick) const;
+
+    TimerId arm_locked(uint64_t expires, uint64_t period, Callback cb);
+    int32_t alloc_node_locked();
+    void free_node_locked(int32_t idx);
+    void link_locked(int32_t idx);
+    void unlink_locked(int32_t idx);
+    uint32_t cascade_locked(int level);
+    void collect_expired_locked(uint64_t now_tick, std::vector<Expired>& out);
+    void finish_fired_locked(Expired& e);
+    size_t run_expired(std::vector<Expired>& expired);
+    clock::time_point next_wakeup_locked() const;
+    void thread_loop();
+
+    int32_t& head(int level, uint32_t slot);
+
+    mutable std::mutex m_;
+    std::condition_variable cv_;
+    std::thread th_;
+    bool running_{false};
+
+    const clock::time_point origin_;
+    uint64_t current_{0};   // 下一个待处理的 tick
+    size_t armed_{0};
+
+    std::array<int32_t, kRootSlots> root_{};
+    std::array<std::array<int32_t, kLevelSlots>, kLevels - 1> levels_{};
+    std::vector<Node> nodes_;
+    int32_t free_head_{kNil};
+};
+
+} // namespace wta::core
@@ -1,6 +1,10 @@
 #pragma once
+#include <chrono>
+#include <functional>
 #include <memory>
+#include <unordered_map>
 #include "../core/solver_messages.hpp"
+#include "../core/timer_wheel.hpp"
 
 namespace wta::exec {
 
@@ -14,12 +18,52 @@ struct EngagementAction {
     int retries{0};
 };
 
+// 增量应用方案的累计统计（每个方案只对变化的平台下发指令）
+struct PlanChangeStats {
+    uint64_t plans{0};          // 已应用的方案数
+    uint64_t kept{0};           // 累计保留的任务
+    uint64_t added{0};
+    uint64_t removed{0};
+    uint64_t retargeted{0};
+    uint32_t last_changes{0};   // 最近一个方案的变化数（新增 + 撤销 + 改派）
+    uint64_t follow_ons{0};     // 执行器本地推进开始的后续交战（每个都省去一次求解往返）
+    
+    double changes_per_plan() const {
+        return plans ? static_cast<double>(added + removed + retargeted) / static_cast<double>(plans) : 0.0;
+    }
+};
+
 struct IExecutor {
+    using clock = std::chrono::steady_clock;
     virtual ~IExecutor() = default;
+    // 只在执行线程上调用（与 tick() 同一线程）；跨线程交接由编排器的方案邮箱完成
     virtual void apply_assignment(const wta::proto::PlanResponse& resp) = 0;
     virtual void tick() = 0;
+    // 下一次需要 tick 的时间点；time_point::max() 表示空闲，只在新分配或击毁事件到达时才需要 tick
+    virtual clock::time_point next_tick() const { return clock::now(); }
+    // 击毁事件通知：只在执行线程、下一次 tick() 之前调用（由 Orchestrator 从它的击毁订阅转发）
+    virtual void on_entity_killed(wta::types::Id entity_id, bool is_platform) {
+        (void)entity_id;
+        (void)is_platform;
+    }
+    // 改用共享时间轮安排阶段等待（到期时调用 wake 唤醒执行线程）；nullptr 退回实现自己的计时方式。
+    // 只在执行线程不 tick 时调用
+    virtual void use_timer_wheel(wta::core::TimerWheel* wheel, std::function<void()> wake) {
+        (void)wheel;
+        (void)wake;
+    }
+    virtual PlanChangeStats plan_change_stats() const { return {}; }
+    // 已下发第一条命令的方案数（命令发给方案新增或改派的平台；用于测量方案到第一条命令的延迟）
+    virtual uint64_t plans_commanded() const { return 0; }
+    // 本地修复：只在执行线程调用，把空闲（或目标已毁）的平台立即改派，不影响其他任务；返回实际改派数
+    virtual size_t reassign(const std::unordered_map<wta::types::PlatformId, wta::types::TargetId>& moves) {
+        (void)moves;
+        return 0;
+    }
 };
 
-std::unique_ptr<IExecutor> make_intercept_executor();
+// kill_notifications 为 true 时，调用方负责通过 on_entity_killed() 转发击毁事件，
+// 执行器仅在收到通知（或兜底周期到期）时才刷新实体存活状态；否则每次 tick 都刷新
+std::unique_ptr<IExecutor> make_intercept_executor(bool kill_notifications = false);
 
 } // namespace wta::exec
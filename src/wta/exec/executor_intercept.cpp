@@ -2,8 +2,10 @@
 #include "task_executor.hpp"
 #include "entity_registry.hpp"
 #include <intercept.hpp>
+#include <chrono>
 #include <mutex>
 #include <memory>
+#include <unordered_map>
 
 namespace wta::exec {
 
@@ -14,15 +16,69 @@ using namespace intercept;
  */
 class InterceptExecutor final : public IExecutor {
 public:
-    InterceptExecutor() {
+    explicit InterceptExecutor(bool kill_notifications) : kill_notifications_(kill_notifications) {
         // 初始化组件
         task_executor_ = std::make_unique<TaskExecutor>();
         entity_registry_ = std::make_unique<EntityRegistry>();
     }
     
+    // 由执行线程在 tick() 之前调用（编排器已从规划线程的邮箱取走最新方案），直接应用
     void apply_assignment(const wta::proto::PlanResponse& resp) override {
         std::lock_guard<std::mutex> lk(m_);
+        apply_plan(resp);
+    }
+    
+    // 击毁通知：由事件驱动刷新实体状态，代替每帧轮询存活
+    void on_entity_killed(wta::types::Id, bool) override {
+        std::lock_guard<std::mutex> lk(m_);
+        kill_pending_ = true;
+    }
+    
+    void tick() override {
+        std::lock_guard<std::mutex> lk(m_);
+        
+        // 更新实体状态（移除已摧毁的）
+        // 有击毁通知时只在收到通知或兜底周期到期时才全量检查
+        if (entity_registry_ && should_refresh_entities()) {
+            entity_registry_->update();
+        }
         
+        // 执行任务
+        if (task_executor_) {
+            task_executor_->tick();
+        }
+    }
+    
+    void use_timer_wheel(wta::core::TimerWheel* wheel, std::function<void()> wake) override {
+        std::lock_guard<std::mutex> lk(m_);
+        if (task_executor_) task_executor_->use_timer_wheel(wheel, std::move(wake));
+    }
+    
+    PlanChangeStats plan_change_stats() const override {
+        std::lock_guard<std::mutex> lk(m_);
+        auto stats = change_stats_;
+        if (task_executor_) stats.follow_ons = task_executor_->follow_ons_started();
+        return stats;
+    }
+    
+    uint64_t plans_commanded() const override {
+        std::lock_guard<std::mutex> lk(m_);
+        return task_executor_ ? task_executor_->plans_commanded() : 0;
+    }
+    
+    size_t reassign(const std::unordered_map<wta::types::PlatformId, wta::types::TargetId>& moves) override {
+        std::lock_guard<std::mutex> lk(m_);
+        return task_executor_ ? task_executor_->reassign(moves) : 0;
+    }
+    
+    clock::time_point next_tick() const override {
+        std::lock_guard<std::mutex> lk(m_);
+        return task_executor_ ? task_executor_->next_deadline() : clock::time_point::max();
+    }
+    
+private:
+    // 实体发现与任务差异都在执行线程上完成，规划线程不会阻塞 tick（调用方已持有 m_）
+    void apply_plan(const wta::proto::PlanResponse& resp) {
         // 发现并注册所有实体
         if (entity_registry_->discover_entities()) {
             // 将实体注册到任务执行器
@@ -34,51 +90,69 @@ public:
             }
         }
         
-        // 清空旧任务
-        task_executor_->clear_all_tasks();
-        
-        // 解析分配矩阵并创建任务
+        // 解析分配矩阵：每个平台取第一个被分配的目标
         const size_t n_plat = resp.n_platforms;
         const size_t n_tgt = resp.n_targets;
+        std::unordered_map<wta::types::PlatformId, wta::types::TargetId> assignment;
         
         for (size_t i = 0; i < n_plat; ++i) {
             for (size_t j = 0; j < n_tgt; ++j) {
                 const size_t idx = i * n_tgt + j;
                 if (idx < resp.assignment.size() && resp.assignment[idx] > 0) {
-                    // 创建攻击任务
-                    AttackTask task;
-                    task.platform_id = static_cast<wta::types::PlatformId>(i + 1);
-                    task.target_id = static_cast<wta::types::TargetId>(j + 1);
-                    // 目标位置会在任务执行时动态更新
-                    
-                    task_executor_->add_attack_task(task);
+                    assignment.emplace(static_cast<wta::types::PlatformId>(i + 1),
+                                       static_cast<wta::types::TargetId>(j + 1));
+                    break;
                 }
             }
         }
-    }
-    
-    void tick() override {
-        std::lock_guard<std::mutex> lk(m_);
         
-        // 更新实体状态（移除已摧毁的）
-        if (entity_registry_) {
-            entity_registry_->update();
+        // 与现有任务做差异：未变化的平台->目标保留进行中的任务，只对变化部分下发指令
+        // 多步方案的后续交战队列随分配一起替换，平台完成当前目标后在本地推进
+        const PlanDiff diff = task_executor_->reconcile(assignment, resp.follow_ons);
+        change_stats_.plans++;
+        change_stats_.kept += diff.kept;
+        change_stats_.added += diff.added;
+        change_stats_.removed += diff.removed;
+        change_stats_.retargeted += diff.retargeted;
+        change_stats_.last_changes = static_cast<uint32_t>(diff.changes());
+        {
+            client::invoker_lock lock;
+            sqf::diag_log("[WTA][EXEC] plan applied: kept=" + std::to_string(diff.kept) +
+                          " added=" + std::to_string(diff.added) +
+                          " removed=" + std::to_string(diff.removed) +
+                          " retargeted=" + std::to_string(diff.retargeted) +
+                          " queued=" + std::to_string(diff.queued));
         }
+    }
+    
+    // 兜底周期：防止事件丢失（如实体被直接删除而未触发 Killed）
+    static constexpr std::chrono::seconds kFallbackRefresh{2};
+    
+    bool should_refresh_entities() {
+        if (!kill_notifications_) return true;
         
-        // 执行任务
-        if (task_executor_) {
-            task_executor_->tick();
+        const bool killed = kill_pending_;
+        kill_pending_ = false;
+        const auto now = clock::now();
+        if (killed || now - last_refresh_ >= kFallbackRefresh) {
+            last_refresh_ = now;
+            return true;
         }
+        return false;
     }
     
-private:
-    std::mutex m_;
+    mutable std::mutex m_;
     std::unique_ptr<TaskExecutor> task_executor_;
     std::unique_ptr<EntityRegistry> entity_registry_;
+    
+    const bool kill_notifications_;
+    bool kill_pending_{false};
+    clock::time_point last_refresh_{};
+    PlanChangeStats change_stats_{};
 };
 
-std::unique_ptr<IExecutor> make_intercept_executor() {
-    return std::make_unique<InterceptExecutor>();
+std::unique_ptr<IExecutor> make_intercept_executor(bool kill_notifications) {
+    return std::make_unique<InterceptExecutor>(kill_notifications);
 }
 
 } // namespace wta::exec
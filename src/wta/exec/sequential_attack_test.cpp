@@ -1,4 +1,5 @@
 #include "sequential_attack_test.hpp"
+#include "../core/runtime_params.hpp"
 #include <intercept.hpp>
 #include <thread>
 #include <atomic>
@@ -171,12 +172,14 @@ void run_test_loop() {
                 break;  // 跳出内循环，重新分配任务
             }
             
-            // 控制 tick 频率
-            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+            // 控制 tick 频率（运行时参数 test.tick_ms）
+            std::this_thread::sleep_for(std::chrono::milliseconds(
+                wta::core::tunables().test_tick_ms.load(std::memory_order_relaxed)));
         }
         
-        // 短暂延迟再处理下一个目标
-        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+        // 短暂延迟再处理下一个目标（运行时参数 test.target_delay_ms）
+        std::this_thread::sleep_for(std::chrono::milliseconds(
+            wta::core::tunables().test_target_delay_ms.load(std::memory_order_relaxed)));
     }
 
     {
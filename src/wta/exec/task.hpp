@@ -2,6 +2,7 @@
 #include <string>
 #include <chrono>
 #include "../core/types.hpp"
+#include "../core/timer_wheel.hpp"
 
 namespace wta::exec {
 
@@ -49,6 +50,12 @@ struct AttackTask {
     
     // 【新增】仿照 fn_execution.sqf 的弹药跟踪
     int ammo_before_fire{0};                // 开火前弹药数量
+    float verify_wait_sec{5.f};             // 开火后等待 AI 射击再验证的时间（秒）
+    
+    // 定时等待：waiting 期间任务不参与轮询，由 TaskExecutor 的时间轮到期后恢复
+    bool waiting{false};
+    wta::core::TimerId wait_timer{wta::core::kInvalidTimer};
+    uint64_t wait_seq{0};                   // 本次等待的序号，丢弃已被替换的等待的到期通知
     
     // 时间戳
     using clock = std::chrono::steady_clock;
@@ -98,11 +105,13 @@ struct TaskStatistics {
     int total_tasks{0};
     int completed_tasks{0};
     int failed_tasks{0};
+    int cancelled_tasks{0};   // 被新方案撤销/改派的任务
     int active_tasks{0};
     
     void on_task_created() { total_tasks++; active_tasks++; }
     void on_task_completed() { completed_tasks++; active_tasks--; }
     void on_task_failed() { failed_tasks++; active_tasks--; }
+    void on_task_cancelled() { cancelled_tasks++; active_tasks--; }
     
     float success_rate() const {
         if (total_tasks == 0) return 0.f;
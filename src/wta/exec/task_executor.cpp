@@ -1,6 +1,7 @@
 #include "task_executor.hpp"
 #include <intercept.hpp>
 #include <algorithm>
+#include <unordered_set>
 
 namespace wta::exec {
 
@@ -8,6 +9,26 @@ using namespace intercept;
 
 TaskExecutor::TaskExecutor() = default;
 
+TaskExecutor::~TaskExecutor() {
+    // 共享时间轮上的回调引用 this
+    for (auto& [pid, task] : active_tasks_) timers_->cancel(task.wait_timer);
+}
+
+void TaskExecutor::use_timer_wheel(wta::core::TimerWheel* wheel, std::function<void()> wake) {
+    if (!wheel) wheel = &local_timers_;
+    if (wheel != timers_) {
+        for (auto& [pid, task] : active_tasks_) {
+            timers_->cancel(task.wait_timer);
+            task.wait_timer = wta::core::kInvalidTimer;
+            task.waiting = false;
+        }
+        timers_ = wheel;
+    }
+    wake_ = wheel == &local_timers_ ? std::function<void()>{} : std::move(wake);
+    std::lock_guard<std::mutex> lk(expired_m_);
+    expired_.clear();
+}
+
 bool TaskExecutor::add_attack_task(const AttackTask& task) {
     // 检查 UAV 是否存在
     auto* uav = find_uav(task.platform_id);
@@ -48,32 +69,48 @@ bool TaskExecutor::cancel_task(wta::types::PlatformId platform_id) {
         uav->clear_task();
     }
     
-    // 移除任务
+    // 移除任务（后续交战一并作废）
+    timers_->cancel(it->second.wait_timer);
     active_tasks_.erase(it);
+    follow_ons_.erase(platform_id);
     stats_.on_task_failed();
     
     return true;
 }
 
 int TaskExecutor::tick() {
+    // 触发到期的阶段等待（例如 Verify 的开火等待）；共享时间轮由它自己的线程推进
+    if (timers_ == &local_timers_) local_timers_.advance_to(AttackTask::clock::now());
+    resume_expired_waits();
+    
+    // 等待前置目标被摧毁的平台：条件满足后开始下一项后续交战
+    if (!follow_ons_.empty()) {
+        resume_follow_ons();
+    }
     if (active_tasks_.empty()) {
         return 0;
     }
     
     std::vector<wta::types::PlatformId> completed_tasks;
     
-    // 【限流机制】将map转为vector以便轮询
+    // 【限流机制】将map转为vector以便轮询；等待中的任务不占用本帧配额
     std::vector<wta::types::PlatformId> task_ids;
     task_ids.reserve(active_tasks_.size());
-    for (const auto& [pid, _] : active_tasks_) {
-        task_ids.push_back(pid);
+    for (const auto& [pid, task] : active_tasks_) {
+        if (!task.waiting) task_ids.push_back(pid);
+    }
+    if (task_ids.empty()) {
+        return static_cast<int>(active_tasks_.size());
     }
     
     // 【限流机制】确定本帧处理的任务范围
     size_t total_tasks = task_ids.size();
     size_t start_index = task_process_index_ % total_tasks;
-    size_t tasks_to_process = (max_tasks_per_tick_ > 0) 
-        ? std::min<size_t>(max_tasks_per_tick_, total_tasks)
+    const int max_tasks = max_tasks_per_tick_ >= 0
+        ? max_tasks_per_tick_
+        : wta::core::tunables().exec_max_tasks_per_tick.load(std::memory_order_relaxed);
+    size_t tasks_to_process = (max_tasks > 0) 
+        ? std::min<size_t>(max_tasks, total_tasks)
         : total_tasks;
     
     // 【限流机制】轮询处理任务（避免总是处理前N个）
@@ -112,7 +149,17 @@ int TaskExecutor::tick() {
     
     // 清理完成的任务
     for (auto pid : completed_tasks) {
-        active_tasks_.erase(pid);
+        auto it = active_tasks_.find(pid);
+        if (it == active_tasks_.end()) continue;
+        timers_->cancel(it->second.wait_timer);
+        const bool completed = it->second.stage == TaskStage::Completed;
+        active_tasks_.erase(it);
+        // 完成后本地推进到下一项后续交战；失败（平台损失等）时队列作废，留给重规划
+        if (completed) {
+            start_follow_on(pid);
+        } else {
+            follow_ons_.erase(pid);
+        }
     }
     
     return static_cast<int>(active_tasks_.size());
@@ -133,6 +180,7 @@ void TaskExecutor::register_target(std::shared_ptr<TargetEntity> target) {
 void TaskExecutor::clear_all_tasks() {
     // 停止所有 UAV
     for (auto& [pid, task] : active_tasks_) {
+        timers_->cancel(task.wait_timer);
         auto* uav = find_uav(pid);
         if (uav) {
             controller_.stop(*uav);
@@ -142,6 +190,105 @@ void TaskExecutor::clear_all_tasks() {
     }
     
     active_tasks_.clear();
+    follow_ons_.clear();
+}
+
+PlanDiff TaskExecutor::reconcile(
+    const std::unordered_map<wta::types::PlatformId, wta::types::TargetId>& assignment,
+    const std::vector<wta::proto::EngagementQueue>& follow_ons) {
+    PlanDiff diff;
+    std::unordered_set<wta::types::PlatformId> retargeted;
+    std::unordered_set<wta::types::PlatformId> changed;   // 新增或改派的平台
+    
+    // 新方案的后续交战整体替换旧队列（已本地推进的部分由新方案重新决定）
+    follow_ons_.clear();
+    for (const auto& queue : follow_ons) {
+        if (queue.steps.empty()) continue;
+        follow_ons_[queue.platform_id].assign(queue.steps.begin(), queue.steps.end());
+    }
+    diff.queued = static_cast<int>(follow_ons_.size());
+    
+    // 先处理现有任务：保留、改派或撤销
+    for (auto it = active_tasks_.begin(); it != active_tasks_.end();) {
+        const auto pid = it->first;
+        const auto want = assignment.find(pid);
+        if (want != assignment.end() && want->second == it->second.target_id) {
+            ++diff.kept;
+            ++it;
+            continue;
+        }
+        
+        timers_->cancel(it->second.wait_timer);
+        auto* uav = find_uav(pid);
+        if (want == assignment.end()) {
+            // 不再分配：停止 UAV
+            if (uav) {
+                controller_.stop(*uav);
+                uav->set_status(UavStatus::Idle);
+                uav->clear_task();
+            }
+            ++diff.removed;
+        } else {
+            // 改派：无需先停止，新任务的导航指令会覆盖原航路
+            if (uav) uav->clear_task();
+            retargeted.insert(pid);
+        }
+        stats_.on_task_cancelled();
+        it = active_tasks_.erase(it);
+    }
+    
+    // 再为没有任务的平台创建任务（改派的平台也在这里拿到新任务）
+    for (const auto& [pid, tid] : assignment) {
+        if (active_tasks_.count(pid)) continue;
+        AttackTask task;
+        task.platform_id = pid;
+        task.target_id = tid;
+        // 目标位置会在任务执行时动态更新
+        const bool is_retarget = retargeted.count(pid) > 0;
+        if (!add_attack_task(task)) {
+            // 新任务建不起来：改派退化为撤销，像撤销路径一样停止 UAV，否则它会继续飞向原目标
+            if (is_retarget) {
+                if (auto* uav = find_uav(pid)) {
+                    controller_.stop(*uav);
+                    uav->set_status(UavStatus::Idle);
+                }
+                ++diff.removed;
+            }
+            continue;
+        }
+        ++(is_retarget ? diff.retargeted : diff.added);
+        changed.insert(pid);
+    }
+    // 方案到第一条命令的延迟只看变化的平台：保留的任务每个节拍都会重发导航
+    controller_.watch_first_command(std::move(changed));
+    
+    // 当前目标已失效（校验时被剔除）但有后续交战的平台直接从队列开始
+    resume_follow_ons();
+    
+    return diff;
+}
+
+size_t TaskExecutor::reassign(
+    const std::unordered_map<wta::types::PlatformId, wta::types::TargetId>& moves) {
+    size_t applied = 0;
+    for (const auto& [pid, tid] : moves) {
+        if (follow_ons_.count(pid)) continue;  // 后续交战在本地推进
+        auto it = active_tasks_.find(pid);
+        if (it != active_tasks_.end()) {
+            if (!is_target_destroyed(find_target(it->second.target_id))) continue;  // 仍在执行有效任务
+            // 目标已毁但本帧限流尚未轮到：目标不一定是本平台摧毁的，按撤销结算（完成只由 tick 的正常路径计），
+            // 直接接上新任务。有后续交战的平台已在上面跳过，无需推进队列
+            timers_->cancel(it->second.wait_timer);
+            stats_.on_task_cancelled();
+            if (auto* uav = find_uav(pid)) uav->clear_task();
+            active_tasks_.erase(it);
+        }
+        AttackTask task;
+        task.platform_id = pid;
+        task.target_id = tid;
+        if (add_attack_task(task)) ++applied;
+    }
+    return applied;
 }
 
 void TaskExecutor::process_task(AttackTask& task) {
@@ -319,6 +466,7 @@ void TaskExecutor::handle_firing_stage(AttackTask& task) {
         task.fire_command_time = AttackTask::clock::now();
         task.stage = TaskStage::Verify;
         uav->set_status(UavStatus::Firing);
+        wait_then_resume(task, task.verify_wait_sec);
         
         {
             client::invoker_lock lock;
@@ -345,12 +493,7 @@ void TaskExecutor::handle_verify_stage(AttackTask& task) {
     
     // 【仿照 fn_execution.sqf】等待更长时间让 AI 开火
     // fn_execution.sqf 等待了 sleep 5 + sleep 3 = 8 秒
-    auto elapsed = std::chrono::duration<double>(
-        AttackTask::clock::now() - task.fire_command_time).count();
-    
-    if (elapsed < 5.0) {
-        return;  // 还没到验证时间，继续等待 AI 开火
-    }
+    // 进入 Verify 时已挂起 verify_wait_sec，定时器到期后才会执行到这里
     
     // 目标已被摧毁
     if (is_target_destroyed(target)) {
@@ -445,4 +588,113 @@ bool TaskExecutor::is_target_destroyed(const TargetEntity* target) {
     return !target->is_alive();
 }
 
+AttackTask::clock::time_point TaskExecutor::next_deadline() const {
+    const auto now = AttackTask::clock::now();
+    for (const auto& [pid, task] : active_tasks_) {
+        if (!task.waiting) return now;
+    }
+    {
+        std::lock_guard<std::mutex> lk(expired_m_);
+        if (!expired_.empty()) return now;
+    }
+    // 共享时间轮到期时会唤醒执行线程，不需要按它的下一个到期点 tick
+    auto next = active_tasks_.empty() || timers_ != &local_timers_ ? AttackTask::clock::time_point::max()
+                                                                   : local_timers_.next_wakeup();
+    if (has_parked_follow_ons()) {
+        next = std::min(next, now + kFollowOnPoll);
+    }
+    return next;
+}
+
+bool TaskExecutor::start_follow_on(wta::types::PlatformId pid) {
+    auto it = follow_ons_.find(pid);
+    if (it == follow_ons_.end()) return false;
+    
+    auto* uav = find_uav(pid);
+    if (!uav || !uav->is_alive()) {
+        follow_ons_.erase(it);
+        return false;
+    }
+    
+    auto& queue = it->second;
+    while (!queue.empty()) {
+        const auto step = queue.front();
+        auto* target = find_target(step.target_id);
+        if (!target || !target->is_alive()) {
+            queue.pop_front();  // 已被其他平台摧毁，跳过
+            continue;
+        }
+        if (step.after_target_id != 0 && !is_target_destroyed(find_target(step.after_target_id))) {
+            return false;  // 前置目标仍存活：保留队列，平台原地等待
+        }
+        queue.pop_front();
+        
+        AttackTask task;
+        task.platform_id = pid;
+        task.target_id = step.target_id;
+        if (!add_attack_task(task)) break;
+        ++follow_ons_started_;
+        {
+            client::invoker_lock lock;
+            sqf::diag_log("[WTA][TASK] UAV " + std::to_string(pid) + " follow-on engagement -> target " +
+                          std::to_string(step.target_id) + " (" + std::to_string(queue.size()) + " queued)");
+        }
+        if (queue.empty()) follow_ons_.erase(it);
+        return true;
+    }
+    follow_ons_.erase(it);
+    return false;
+}
+
+void TaskExecutor::resume_follow_ons() {
+    std::vector<wta::types::PlatformId> parked;
+    for (const auto& [pid, queue] : follow_ons_) {
+        if (!active_tasks_.count(pid)) parked.push_back(pid);
+    }
+    for (auto pid : parked) {
+        start_follow_on(pid);
+    }
+}
+
+bool TaskExecutor::has_parked_follow_ons() const {
+    for (const auto& [pid, queue] : follow_ons_) {
+        if (!active_tasks_.count(pid)) return true;
+    }
+    return false;
+}
+
+void TaskExecutor::wait_then_resume(AttackTask& task, float seconds) {
+    timers_->cancel(task.wait_timer);
+    task.waiting = true;
+    task.wait_seq = ++wait_seq_;
+    const auto pid = task.platform_id;
+    const auto seq = task.wait_seq;
+    task.wait_timer = timers_->schedule_after(
+        std::chrono::milliseconds(static_cast<int64_t>(seconds * 1000.f)),
+        [this, pid, seq]() { on_wait_expired(pid, seq); });
+}
+
+void TaskExecutor::on_wait_expired(wta::types::PlatformId pid, uint64_t seq) {
+    {
+        std::lock_guard<std::mutex> lk(expired_m_);
+        expired_.emplace_back(pid, seq);
+    }
+    if (wake_) wake_();
+}
+
+void TaskExecutor::resume_expired_waits() {
+    std::vector<std::pair<wta::types::PlatformId, uint64_t>> expired;
+    {
+        std::lock_guard<std::mutex> lk(expired_m_);
+        expired.swap(expired_);
+    }
+    for (const auto& [pid, seq] : expired) {
+        auto it = active_tasks_.find(pid);
+        // 等待已被取消或替换（回调与取消竞争时可能仍会登记）
+        if (it == active_tasks_.end() || it->second.wait_seq != seq) continue;
+        it->second.waiting = false;
+        it->second.wait_timer = wta::core::kInvalidTimer;
+    }
+}
+
 } // namespace wta::exec
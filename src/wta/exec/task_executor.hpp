@@ -2,18 +2,46 @@
 #include "uav_entity.hpp"
 #include "task.hpp"
 #include "uav_controller.hpp"
+#include "../core/runtime_params.hpp"
+#include "../core/solver_messages.hpp"
+#include <deque>
+#include <functional>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 #include <memory>
 
 namespace wta::exec {
 
+/**
+ * @brief 一次增量应用方案的变化统计
+ */
+struct PlanDiff {
+    int kept{0};         // 平台->目标未变，保留现有任务（阶段与重试状态不丢失）
+    int added{0};        // 新分配的平台
+    int removed{0};      // 新方案中不再有任务的平台
+    int retargeted{0};   // 改派到其他目标的平台
+    int queued{0};       // 带后续交战队列的平台
+    
+    int changes() const { return added + removed + retargeted; }
+};
+
 /**
  * @brief 任务执行器 - 实现任务状态机和执行逻辑
  */
 class TaskExecutor {
 public:
     TaskExecutor();
+    ~TaskExecutor();
+    
+    /**
+     * @brief 改用共享时间轮（由其线程驱动）安排阶段等待
+     * @param wheel 共享时间轮；nullptr 表示退回内部时间轮，由 tick() 手动推进
+     * @param wake 等待到期时调用（在时间轮线程上），应唤醒执行线程尽快 tick
+     *
+     * 只在执行线程不运行 tick() 时调用。切换时已安排的等待在旧时间轮上取消，相应任务下一次 tick 恢复。
+     */
+    void use_timer_wheel(wta::core::TimerWheel* wheel, std::function<void()> wake);
     
     /**
      * @brief 添加新的攻击任务
@@ -52,16 +80,49 @@ public:
      */
     const TaskStatistics& statistics() const { return stats_; }
     
+    /**
+     * @brief 已下发第一条命令的方案数：命令发给了该方案新增或改派的平台（没有变化的方案不计）
+     */
+    uint64_t plans_commanded() const { return controller_.first_commands(); }
+    
     /**
      * @brief 清空所有任务
      */
     void clear_all_tasks();
     
+    /**
+     * @brief 按新分配增量更新任务，只对新增/移除/改派的平台下发引擎指令
+     * @param assignment 平台 -> 目标（每个平台一个目标）
+     * @param follow_ons 每个平台在当前目标之后的后续交战，整体替换旧方案的队列
+     * @return 本次变化统计
+     */
+    PlanDiff reconcile(const std::unordered_map<wta::types::PlatformId, wta::types::TargetId>& assignment,
+                       const std::vector<wta::proto::EngagementQueue>& follow_ons = {});
+    
+    /**
+     * @brief 本地修复：为空闲或当前目标已毁的平台直接创建新任务，其他任务不受影响
+     * @param moves 平台 -> 新目标；仍在执行有效任务或有后续交战队列的平台被跳过
+     * @return 实际改派的平台数
+     */
+    size_t reassign(const std::unordered_map<wta::types::PlatformId, wta::types::TargetId>& moves);
+    
     /**
      * @brief 获取活跃任务数量
      */
     int active_task_count() const { return static_cast<int>(active_tasks_.size()); }
     
+    /**
+     * @brief 本地推进开始的后续交战数（每一个都省去一次求解往返）
+     */
+    uint64_t follow_ons_started() const { return follow_ons_started_; }
+    
+    /**
+     * @brief 下一次需要 tick 的时间点
+     * @return 有未挂起的任务时为 now()；全部挂起时为最近的阶段截止（有平台等待后续交战条件时
+     *         至多 kFollowOnPoll 后）；无任务时为 time_point::max()
+     */
+    AttackTask::clock::time_point next_deadline() const;
+    
     /**
      * @brief 设置每帧最大处理任务数（限流）
      * @param max_tasks 最大任务数，0表示不限制
@@ -84,16 +145,37 @@ private:
     UavEntity* find_uav(wta::types::PlatformId id);
     TargetEntity* find_target(wta::types::TargetId id);
     bool is_target_destroyed(const TargetEntity* target);
+    void wait_then_resume(AttackTask& task, float seconds);  // 挂起任务直到定时器到期
+    bool start_follow_on(wta::types::PlatformId pid);        // 从队列取下一项后续交战，条件未满足时保留等待
+    void resume_follow_ons();                                 // 无任务且有队列的平台重新检查条件
+    bool has_parked_follow_ons() const;
+    
+    // 等待前置目标被摧毁的平台：击毁事件会唤醒执行线程，这里只是防事件丢失的兜底
+    static constexpr std::chrono::seconds kFollowOnPoll{1};
     
     // 数据成员
     UavController controller_;
     std::unordered_map<wta::types::PlatformId, std::shared_ptr<UavEntity>> uavs_;
     std::unordered_map<wta::types::TargetId, std::shared_ptr<TargetEntity>> targets_;
     std::unordered_map<wta::types::PlatformId, AttackTask> active_tasks_;
+    // 多步方案：平台完成当前任务后本地推进的后续交战
+    std::unordered_map<wta::types::PlatformId, std::deque<wta::proto::FollowOnEngagement>> follow_ons_;
+    uint64_t follow_ons_started_{0};
     TaskStatistics stats_;
     
+    // 阶段等待的截止时间：默认用内部时间轮（tick() 手动推进）；Orchestrator 注入它的时间轮后由轮线程驱动，
+    // 回调只登记到期的等待并唤醒执行线程，任务状态仍只在 tick() 中修改
+    void on_wait_expired(wta::types::PlatformId pid, uint64_t seq);
+    void resume_expired_waits();
+    wta::core::TimerWheel local_timers_;
+    wta::core::TimerWheel* timers_{&local_timers_};
+    std::function<void()> wake_;
+    uint64_t wait_seq_{0};
+    mutable std::mutex expired_m_;
+    std::vector<std::pair<wta::types::PlatformId, uint64_t>> expired_;
+    
     // 限流机制：防止同时处理过多UAV导致引擎崩溃
-    int max_tasks_per_tick_ = 2;  // 每帧最多处理2个任务（更安全）
+    int max_tasks_per_tick_ = -1;  // <0 时取运行时参数 exec.max_tasks_per_tick（默认每帧 2 个，更安全）
     size_t task_process_index_ = 0;  // 轮询索引
 };
 
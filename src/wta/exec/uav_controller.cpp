@@ -63,6 +63,7 @@ bool UavController::navigate_to(UavEntity& uav, const wta::types::Vec2& target_p
     
     try {
         client::invoker_lock lock;
+        note_command(uav);
         
         // 构造 3D 目标位置
         vector3 pos_3d(target_pos.x, target_pos.y, altitude);
@@ -100,6 +101,7 @@ bool UavController::aim_at(UavEntity& uav, const TargetEntity& target) {
     
     try {
         client::invoker_lock lock;
+        note_command(uav);
         
         // 【仿照 fn_execution.sqf】同时使用 doTarget 和 commandTarget
         try {
@@ -250,6 +252,7 @@ bool UavController::fire_at(UavEntity& uav, const TargetEntity& target, const st
             return false;
         }
         
+        note_command(uav);
         sqf::diag_log("[WTA][FIRE] ===== FULL AI ATTACK SETUP =====");
         sqf::diag_log("[WTA][FIRE] UAV " + std::to_string(uav.id()) + " -> Target " + std::to_string(target.id()));
         
@@ -427,6 +430,7 @@ bool UavController::egress_to_safe(UavEntity& uav, const wta::types::Vec2* safe_
     
     try {
         client::invoker_lock lock;
+        note_command(uav);
         
         wta::types::Vec2 egress_pos;
         if (safe_pos) {
@@ -453,6 +457,7 @@ bool UavController::return_to_base(UavEntity& uav) {
     
     try {
         client::invoker_lock lock;
+        note_command(uav);
         
         // 命令 UAV 返回基地
         // 这里简化处理，实际应该从配置中获取基地位置
@@ -486,6 +491,7 @@ void UavController::stop(UavEntity& uav) {
     
     try {
         client::invoker_lock lock;
+        note_command(uav);
         sqf::do_stop(uav.game_object());
     } catch (...) {
         // Ignore
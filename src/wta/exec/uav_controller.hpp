@@ -2,6 +2,7 @@
 #include "uav_entity.hpp"
 #include "task.hpp"
 #include <memory>
+#include <unordered_set>
 
 namespace wta::exec {
 
@@ -124,7 +125,28 @@ public:
      */
     void remove_laser_target(const TargetEntity& target);
     
+    /**
+     * @brief 等待这些平台中任意一个的下一条命令；命中后清空等待集合，first_commands() 加一
+     * @param platforms 新方案新增或改派的平台；为空时不等待（没有需要追踪的命令）
+     */
+    void watch_first_command(std::unordered_set<wta::types::PlatformId> platforms) { watched_ = std::move(platforms); }
+    
+    /**
+     * @brief 等待集合被命中的累计次数（即已下发第一条命令的方案数）
+     */
+    uint64_t first_commands() const { return first_commands_; }
+    
 private:
+    void note_command(const UavEntity& uav) {
+        if (!watched_.empty() && watched_.count(uav.id())) {
+            watched_.clear();
+            ++first_commands_;
+        }
+    }
+    
+    std::unordered_set<wta::types::PlatformId> watched_;
+    uint64_t first_commands_{0};
+    
     // 计算两点之间的距离
     float distance(const wta::types::Vec2& a, const wta::types::Vec2& b) const;
     
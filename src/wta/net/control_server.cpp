@@ -0,0 +1,124 @@
+#include "control_server.hpp"
+#include <atomic>
+#include <thread>
+
+#ifdef WTA_HAVE_GLOG
+#include <glog/logging.h>
+#define WTA_LOG(level) LOG(level)
+#else
+#include <iostream>
+#define WTA_LOG(level) if(false) std::cout
+#endif
+
+#ifdef WTA_HAVE_ZMQ
+#include <zmq.h>
+#endif
+
+namespace wta::net {
+
+#ifdef WTA_HAVE_ZMQ
+
+namespace {
+
+class ZmqControlServer final : public IControlServer {
+public:
+    ZmqControlServer(wta::core::RuntimeParams& params, const ControlServerOptions& opts)
+    : params_(params), opts_(opts) {}
+    ~ZmqControlServer() override { stop(); }
+
+    bool start() override {
+        if (running_.exchange(true)) return true;
+        ctx_ = zmq_ctx_new();
+        sock_ = ctx_ ? zmq_socket(ctx_, ZMQ_REP) : nullptr;
+        const int linger = 0;
+        if (!sock_ || zmq_setsockopt(sock_, ZMQ_LINGER, &linger, sizeof(linger)) != 0 ||
+            zmq_bind(sock_, opts_.endpoint.c_str()) != 0) {
+            WTA_LOG(ERROR) << "Control endpoint failed to bind " << opts_.endpoint << ": " << zmq_strerror(zmq_errno());
+            close_socket();
+            running_ = false;
+            return false;
+        }
+        params_.set_audit_sink([](const wta::core::ParamChange& c) {
+            WTA_LOG(INFO) << "Param " << c.name << ": " << c.old_value << " -> " << c.new_value
+                          << " (by " << c.source << ")";
+        });
+        th_ = std::thread(&ZmqControlServer::loop, this);
+        WTA_LOG(INFO) << "Control endpoint listening on " << opts_.endpoint;
+        return true;
+    }
+
+    void stop() override {
+        if (!running_.exchange(false)) return;
+        if (th_.joinable()) th_.join();
+        params_.set_audit_sink({});
+        close_socket();
+    }
+
+    bool running() const override { return running_; }
+
+private:
+    void loop() {
+        while (running_) {
+            zmq_pollitem_t item{sock_, 0, ZMQ_POLLIN, 0};
+            if (zmq_poll(&item, 1, opts_.poll_ms) <= 0 || !(item.revents & ZMQ_POLLIN)) continue;
+
+            zmq_msg_t req;
+            zmq_msg_init(&req);
+            if (zmq_msg_recv(&req, sock_, 0) < 0) {
+                zmq_msg_close(&req);
+                continue;
+            }
+            const std::string command(static_cast<char*>(zmq_msg_data(&req)), zmq_msg_size(&req));
+            // 以消息元数据中的对端地址标识来源（审计日志用）；传输层不提供时（如 ipc/inproc）退回端点名。
+            // 元数据随消息释放，关闭前先拷贝
+            const char* peer_addr = zmq_msg_gets(&req, "Peer-Address");
+            const std::string peer = peer_addr ? peer_addr : opts_.endpoint;
+            zmq_msg_close(&req);
+
+            const std::string reply = params_.execute(command, peer);
+            zmq_send(sock_, reply.data(), reply.size(), 0);
+        }
+    }
+
+    void close_socket() {
+        if (sock_) zmq_close(sock_);
+        if (ctx_) zmq_ctx_term(ctx_);
+        sock_ = nullptr;
+        ctx_ = nullptr;
+    }
+
+    wta::core::RuntimeParams& params_;
+    ControlServerOptions opts_;
+    std::atomic<bool> running_{false};
+    std::thread th_;
+    void* ctx_{nullptr};
+    void* sock_{nullptr};
+};
+
+} // namespace
+
+std::unique_ptr<IControlServer> make_zmq_control_server(wta::core::RuntimeParams& params,
+                                                        const ControlServerOptions& opts) {
+    return std::make_unique<ZmqControlServer>(params, opts);
+}
+
+#else
+
+namespace {
+
+class ControlServerStub final : public IControlServer {
+public:
+    bool start() override { return false; }
+    void stop() override {}
+    bool running() const override { return false; }
+};
+
+} // namespace
+
+std::unique_ptr<IControlServer> make_zmq_control_server(wta::core::RuntimeParams&, const ControlServerOptions&) {
+    return std::make_unique<ControlServerStub>();
+}
+
+#endif
+
+} // namespace wta::net
@@ -0,0 +1,30 @@
+#pragma once
+#include <memory>
+#include <string>
+#include "../core/runtime_params.hpp"
+
+namespace wta::net {
+
+struct ControlServerOptions {
+    std::string endpoint{"tcp://127.0.0.1:5556"};   // 与求解器端口分开，插件侧 bind
+    int poll_ms{200};                                // 检查停止标志的间隔
+};
+
+/**
+ * @brief 运行时控制端点
+ *
+ * 独立线程上的 REP 套接字，每条请求是一条 RuntimeParams 文本命令（get/set/list/audit），
+ * 应答为命令结果。修改直接写入 Tunables 原子变量，各组件下一次读取即生效。
+ */
+struct IControlServer {
+    virtual ~IControlServer() = default;
+    virtual bool start() = 0;
+    virtual void stop() = 0;
+    virtual bool running() const = 0;
+};
+
+// 未启用 ZMQ 时返回的实现 start() 恒为 false
+std::unique_ptr<IControlServer> make_zmq_control_server(wta::core::RuntimeParams& params,
+                                                        const ControlServerOptions& opts = {});
+
+} // namespace wta::net
@@ -131,6 +131,8 @@ inline wta::types::TargetKind from_proto_kind(wta::pb::TargetKind kind) {
 
 inline void to_proto(const wta::proto::StatusReportEvent& from, wta::pb::StatusReportEvent* to) {
     to->set_timestamp(from.timestamp);
+    to->set_report_interval_sec(from.report_interval_sec);
+    to->set_report_reason(from.report_reason);
     for (const auto& platform : from.platforms) {
         auto* pb_platform = to->add_platforms();
         to_proto(platform, pb_platform);
@@ -164,9 +166,32 @@ inline void to_proto(const wta::proto::FiredEvent& from, wta::pb::FiredEvent* to
     to->set_ammo_left(from.ammo_left);
 }
 
+inline void to_proto(const wta::config::SolveConfig& from, wta::pb::SolveConfig* to) {
+    auto* bpso = to->mutable_bpso();
+    bpso->set_n_particles(from.bpso.n_particles);
+    bpso->set_n_iterations(from.bpso.n_iterations);
+    bpso->set_w_max(from.bpso.w_max);
+    bpso->set_w_min(from.bpso.w_min);
+    bpso->set_c1(from.bpso.c1);
+    bpso->set_c2(from.bpso.c2);
+    bpso->set_v_max(from.bpso.v_max);
+    bpso->set_use_gpu(from.bpso.use_gpu);
+    if (from.bpso.seed) bpso->set_seed(*from.bpso.seed);
+    
+    auto* model = to->mutable_model();
+    model->set_enable_tier_constraint(from.model.enable_tier_constraint);
+    model->set_enable_coverage_constraint(from.model.enable_coverage_constraint);
+    model->set_enable_distance_constraint(from.model.enable_distance_constraint);
+    model->mutable_weights()->set_value(from.model.weights.value);
+    model->mutable_weights()->set_cost(from.model.weights.cost);
+}
+
 inline void to_proto(const wta::proto::PlanRequest& from, wta::pb::PlanRequest* to) {
     to->set_timestamp(from.timestamp);
     to->set_reason(from.reason);
+    to->set_snapshot_version(from.snapshot_version);
+    to->set_max_follow_ons(from.max_follow_ons);
+    to_proto(from.config, to->mutable_config());
     for (const auto& platform : from.platforms) {
         auto* pb_platform = to->add_platforms();
         to_proto(platform, pb_platform);
@@ -203,6 +228,19 @@ inline void from_proto(const wta::pb::PlanResponse& from, wta::proto::PlanRespon
     from_proto(from.stats(), to.stats);
     to.ttl_sec = from.ttl_sec();
     to.error_msg = from.error_msg();
+    to.snapshot_version = from.snapshot_version();
+    
+    to.follow_ons.clear();
+    to.follow_ons.reserve(from.follow_ons_size());
+    for (const auto& q : from.follow_ons()) {
+        wta::proto::EngagementQueue queue;
+        queue.platform_id = q.platform_id();
+        queue.steps.reserve(q.steps_size());
+        for (const auto& s : q.steps()) {
+            queue.steps.push_back({s.target_id(), s.after_target_id()});
+        }
+        to.follow_ons.push_back(std::move(queue));
+    }
 }
 
 // ==================== 序列化/反序列化辅助函数 ====================
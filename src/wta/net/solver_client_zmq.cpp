@@ -1,5 +1,6 @@
 #include "solver_client.hpp"
 #include "protobuf_adapter.hpp"
+#include "../core/pipeline_trace.hpp"
 #include "wta_messages.pb.h"
 #include <memory>
 #include <string>
@@ -132,6 +133,7 @@ public:
                       << " platforms, " << req.targets.size() << " targets, reason=" << req.reason;
         
         std::string payload = wta::net::serialize_plan_request(req);
+        wta::core::trace_mark(wta::core::TraceStage::Serialize);
         std::string response;
         
         if (!send_zmq_message(opts_.endpoint, payload, &response, timeout)) {
@@ -1,6 +1,10 @@
 #include "orchestrator.hpp"
 #include "../net/log_sink_zmq.hpp"
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <future>
+#include <sstream>
 
 namespace wta::orch {
 
@@ -10,6 +14,33 @@ static inline double now_sec() {
     return std::chrono::duration<double>(clock::now().time_since_epoch()).count();
 }
 
+static inline std::chrono::milliseconds solve_timeout() {
+    return std::chrono::milliseconds(wta::core::tunables().solve_timeout_ms.load(std::memory_order_relaxed));
+}
+
+static inline clock::time_point to_time_point(double sec) {
+    return clock::time_point(std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(sec)));
+}
+
+// 删除击毁时间早于 t 的记录
+template <class Map>
+static void erase_killed_before(Map& killed_at, double t) {
+    for (auto it = killed_at.begin(); it != killed_at.end();) {
+        it = it->second < t ? killed_at.erase(it) : std::next(it);
+    }
+}
+
+// 统计摘要的输出周期
+static constexpr auto kStatsLogInterval = std::chrono::seconds(30);
+// 快照复用窗口：上报可以接受稍旧的快照，规划需要更新的快照（且不早于触发事件）
+static constexpr auto kReportSnapshotMaxAge = std::chrono::milliseconds(250);
+static constexpr auto kSolveSnapshotMaxAge = std::chrono::milliseconds(100);
+// 推测求解：样本不足时的求解耗时估计、预测分位与额外余量
+static constexpr double kDefaultSolveGuessSec = 0.3;
+static constexpr double kSolvePredictPercentile = 90.0;
+static constexpr double kSpeculationMarginSec = 0.05;
+static constexpr uint64_t kMinSolveSamples = 5;
+
 void Orchestrator::start() {
     if (running_.exchange(true)) return;
     
@@ -17,119 +48,754 @@ void Orchestrator::start() {
     // 因为 Orchestrator 只保存引用，无法传递给 LogSinkManager
     LOG(INFO) << "Orchestrator starting";
     
+    // 规划线程只关心会触发重规划的事件，独立队列不会抢占其他订阅者
+    solver_sub_ = bus_.subscribe({wta::events::EventType::EntityKilled,
+                                  wta::events::EventType::HandleDamage,
+                                  wta::events::EventType::Fired,
+                                  wta::events::EventType::ReplanRequest});
+    reporter_sub_ = bus_.subscribe({wta::events::EventType::EntityKilled,
+                                    wta::events::EventType::HandleDamage,
+                                    wta::events::EventType::Fired});
+    exec_sub_ = bus_.subscribe({wta::events::EventType::EntityKilled});
+    
+    // 状态上报节拍：启动后立即上报一次，之后由上报线程按自适应间隔重新预约
+    report_due_ = true;
+    // 上一次运行遗留的上报定时器先取消再清空句柄，否则重启后它仍会触发
+    timers_.cancel(report_timer_);
+    report_timer_ = wta::core::kInvalidTimer;
+    last_reported_.reset();
+    timers_.start();
+    // 执行器的阶段等待也排在这个时间轮上，到期时唤醒执行线程
+    exec_.use_timer_wheel(&timers_, [sub = exec_sub_]() { sub->wake(); });
+    
+    if (shadow_) shadow_->start();
     th_reporter_ = std::thread(&Orchestrator::loop_reporter, this);
     th_solver_ = std::thread(&Orchestrator::loop_solver, this);
     th_executor_ = std::thread(&Orchestrator::loop_executor, this);
+    th_planner_ = std::thread(&Orchestrator::loop_planner, this);
 }
 
 void Orchestrator::stop() {
     if (!running_.exchange(false)) return;
+    // 关闭订阅以立即唤醒阻塞等待事件的规划线程
+    if (solver_sub_) solver_sub_->close();
+    if (reporter_sub_) reporter_sub_->close();
+    if (exec_sub_) exec_sub_->close();
+    {
+        // 与通信线程的谓词检查同步，避免 running_ 置位与 wait 之间丢失唤醒
+        std::lock_guard<std::mutex> lk(plan_m_);
+    }
+    plan_cv_.notify_all();
     if (th_reporter_.joinable()) th_reporter_.join();
     if (th_solver_.joinable()) th_solver_.join();
     if (th_executor_.joinable()) th_executor_.join();
+    if (th_planner_.joinable()) th_planner_.join();
+    // 定时器句柄由规划/上报线程写入，等它们退出后再取消并停轮（回调持有订阅的引用，期间触发也无害）
+    timers_.cancel(ttl_timer_);
+    timers_.cancel(spec_timer_);
+    timers_.cancel(report_timer_);
+    timers_.stop();
+    // 执行器可能比 Orchestrator 活得久：退回它自己的计时方式，不再引用这个时间轮
+    exec_.use_timer_wheel(nullptr, {});
+    ttl_timer_ = spec_timer_ = report_timer_ = wta::core::kInvalidTimer;
+    if (shadow_) shadow_->stop();
+    bus_.unsubscribe(solver_sub_);
+    bus_.unsubscribe(reporter_sub_);
+    bus_.unsubscribe(exec_sub_);
+    solver_sub_.reset();
+    reporter_sub_.reset();
+    exec_sub_.reset();
+    log_stats();
 }
 
-bool Orchestrator::need_replan(double now) const {
+bool Orchestrator::need_replan() const {
     if (pending_replan_) return true;
-    if (last_resp_) {
-        const double age = now - last_solve_ts_;
-        if (age >= ttl_sec_) return true;
-    } else {
-        return true;
+    // 尚无方案时持续重试，但已有请求在途就等它返回
+    if (!last_resp_ && !plan_outstanding_) return true;
+    // 到期时推测请求仍在途：等它返回直接采纳，不再另发
+    return ttl_expired_.load() && !speculating_;
+}
+
+double Orchestrator::predicted_solve_sec() const {
+    if (solve_latency_.count() < kMinSolveSamples) return kDefaultSolveGuessSec;
+    return static_cast<double>(solve_latency_.percentile_us(kSolvePredictPercentile)) * 1e-6;
+}
+
+void Orchestrator::arm_ttl_timer(double ttl_sec) {
+    timers_.cancel(ttl_timer_);
+    timers_.cancel(spec_timer_);
+    spec_timer_ = wta::core::kInvalidTimer;
+    ttl_expired_ = false;
+    speculate_due_ = false;
+    const auto ttl = std::chrono::milliseconds(static_cast<int64_t>(ttl_sec * 1000.0));
+    const double deadline = now_sec() + ttl_sec;
+    plan_expiry_ts_ = deadline;
+    ttl_timer_ = timers_.schedule_after(ttl, [this, deadline, sub = solver_sub_]() {
+        ttl_deadline_ts_ = deadline;
+        ttl_expired_ = true;
+        sub->wake();
+    });
+    
+    // 按预测的求解耗时提前发出推测请求，使新方案在到期前就绪
+    const double lead = predicted_solve_sec() + kSpeculationMarginSec;
+    if (ttl_sec > lead) {
+        const auto delay = std::chrono::milliseconds(static_cast<int64_t>((ttl_sec - lead) * 1000.0));
+        spec_timer_ = timers_.schedule_after(delay, [this, sub = solver_sub_]() {
+            speculate_due_ = true;
+            sub->wake();
+        });
     }
-    if (now < next_allowed_solve_ts_) return false;
-    return false;
 }
 
-// 数据上报循环：持续采样并发送数据给前端
+void Orchestrator::schedule_report(std::chrono::milliseconds delay) {
+    timers_.cancel(report_timer_);
+    next_report_at_ = clock::now() + delay;
+    report_timer_ = timers_.schedule_after(delay, [this, sub = reporter_sub_]() {
+        report_due_ = true;
+        sub->wake();
+    });
+}
+
+void Orchestrator::publish_cadence() {
+    report_interval_ms_.store(static_cast<uint32_t>(cadence_.interval().count()), std::memory_order_relaxed);
+    report_reason_.store(cadence_.reason(), std::memory_order_relaxed);
+}
+
+void Orchestrator::log_stats() {
+    LOG(INFO) << "Wake latency solver[" << solver_wake_.summary() << "]"
+              << " reporter[" << reporter_wake_.summary() << "]"
+              << " executor[" << executor_wake_.summary() << "]";
+    LOG(INFO) << "Report cadence interval=" << report_interval().count() << "ms reason=" << to_string(report_reason());
+    LOG(INFO) << "Snapshots sampled=" << snapshots_.samples() << " reused=" << snapshots_.reuses()
+              << " sample_time[" << snapshots_.sample_time().summary() << "]";
+    const auto sampler = snapshots_.sampler_stats();
+    LOG(INFO) << "Sampler cache hits=" << sampler.cache_hits << " misses=" << sampler.cache_misses
+              << " hit_rate=" << sampler.hit_rate() << " cached=" << sampler.cached_objects
+              << " engine_calls/sample=" << sampler.calls_per_sample() << " last=" << sampler.last_engine_calls;
+    if (const auto* hold = snapshots_.sampler_lock_hold()) {
+        LOG(INFO) << "Sampler lock_hold[" << hold->summary() << "] slices=" << sampler.last_slices
+                  << " budget_us=" << wta::core::tunables().world_slice_budget_us.load(std::memory_order_relaxed)
+                  << " overruns=" << sampler.budget_overruns;
+    }
+    const auto changes = exec_.plan_change_stats();
+    LOG(INFO) << "Speculative issued=" << speculative_issued() << " swapped=" << speculative_swapped()
+              << " discarded=" << speculative_discarded() << " predicted_solve=" << predicted_solve_sec() << "s"
+              << " staleness[" << plan_staleness_.summary() << "]"
+              << " solve_latency[" << solve_latency_.summary() << "]";
+    LOG(INFO) << "Replan trigger solves=" << solves_triggered() << " avoided=" << solves_avoided()
+              << " plans_kept=" << plans_kept() << " threshold=" << trigger_.options().threshold << " debounce=" << trigger_.options().debounce_sec << "s";
+    LOG(INFO) << "Partitioned solves=" << partitioned_solves() << " cluster_requests=" << cluster_requests()
+              << " cluster_solve_time[" << cluster_solve_.summary() << "]";
+    const uint64_t lookups = plan_cache_hits() + plan_cache_misses();
+    LOG(INFO) << "Plan cache hits=" << plan_cache_hits() << " misses=" << plan_cache_misses() << " hit_rate="
+              << (lookups ? static_cast<double>(plan_cache_hits()) / static_cast<double>(lookups) : 0.0);
+    LOG(INFO) << "Follow-on engagements started=" << changes.follow_ons
+              << " kills_handled_locally=" << kills_handled_locally()
+              << " max_follow_ons=" << wta::core::tunables().plan_max_follow_ons.load(std::memory_order_relaxed);
+    LOG(INFO) << "Local repair platforms=" << repaired_platforms() << " time[" << repair_time_.summary() << "]";
+    if (shadow_) LOG(INFO) << "Shadow solver " << shadow_->summary();
+    LOG(INFO) << "Reaction time " << pipeline_trace_.summary();
+    LOG(INFO) << "Plans applied=" << plans_applied() << " partial=" << plans_partial()
+              << " rejected=" << plans_rejected() << " superseded=" << plan_mailbox_.superseded()
+              << " changes/plan=" << changes.changes_per_plan() << " last_changes=" << changes.last_changes
+              << " kept=" << changes.kept;
+}
+
+// 数据上报循环：持续采样并发送数据给前端，同时转发引擎事件
 void Orchestrator::loop_reporter() {
     using namespace std::chrono_literals;
+    std::vector<wta::events::EventPtr> batch;
     while (running_) {
-        const double t = now_sec();
-        
-        // 在Reporter线程中采样
-        // 注意：sampler_.sample()内部使用invoker_lock保证线程安全
-        wta::proto::StatusReportEvent event{};
-        event.timestamp = t;
-        
-        // 使用临时request来采样
-        wta::proto::SolveRequest temp_req{};
-        temp_req.timestamp = t;
-        sampler_.sample(temp_req);  // 内部有invoker_lock
-        
-        // 转换为StatusReport格式
-        event.platforms = std::move(temp_req.platforms);
-        event.targets = std::move(temp_req.targets);
+        // 转发击毁/伤害/开火事件（由引擎事件桥推送，无需轮询发现）
+        batch.clear();
+        reporter_sub_->drain_into(batch);
+        const double woke = now_sec();
+        for (const auto& ev : batch) {
+            reporter_wake_.record_sec(woke - ev->timestamp);
+            forward_event(*ev);
+        }
+        // 击毁/伤害/开火意味着交战：若下一次上报还远，提前到最快节拍
+        if (!batch.empty()) {
+            const auto interval = cadence_.on_engagement_event();
+            if (next_report_at_ > clock::now() + interval) schedule_report(interval);
+            publish_cadence();
+        }
         
-        // 上报状态（fire-and-forget）
-        client_.report_status(event, 500ms);
+        if (report_due_.exchange(false)) {
+            const double t = now_sec();
+            
+            // 从快照服务取快照：规划线程刚采样过就直接复用，否则在此采样一次（内部有invoker_lock）
+            const auto snap = snapshots_.acquire(kReportSnapshotMaxAge);
+            
+            // 转换为StatusReport格式（快照不可变，只能复制）
+            wta::proto::StatusReportEvent event{};
+            event.timestamp = t;
+            event.platforms = snap->platforms;
+            event.targets = snap->targets;
+            event.report_interval_sec = std::chrono::duration<double>(cadence_.interval()).count();
+            event.report_reason = to_string(cadence_.reason());
+            
+            // 上报状态（fire-and-forget），发送结果与耗时作为消费端拥塞的反馈
+            const auto send_start = clock::now();
+            const bool sent = client_.report_status(event, 500ms);
+            const auto send_time = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - send_start);
+            
+            // 按世界变化与发送反馈决定下一次上报时间
+            const WorldDelta delta = last_reported_
+                ? diff_worlds(*last_reported_, *snap, cadence_.options().move_epsilon)
+                : WorldDelta{};
+            last_reported_ = snap;
+            schedule_report(cadence_.on_report(delta, sent, send_time));
+            publish_cadence();
+            
+            if (clock::now() - last_stats_log_ >= kStatsLogInterval) {
+                last_stats_log_ = clock::now();
+                log_stats();
+            }
+        }
         
-        // 每秒上报一次
-        std::this_thread::sleep_for(1000ms);
+        // 有事件时醒来转发；上报时刻由时间轮唤醒
+        reporter_sub_->wait();
+    }
+}
+
+void Orchestrator::forward_event(const wta::events::Event& ev) {
+    using namespace std::chrono_literals;
+    switch (ev.type) {
+        case wta::events::EventType::EntityKilled: {
+            const auto& killed = std::get<wta::events::EntityKilledEvent>(ev.payload);
+            wta::proto::EntityKilledEvent msg{};
+            msg.timestamp = ev.timestamp;
+            msg.entity_id = killed.entity_id;
+            msg.entity_type = killed.is_platform ? "platform" : "target";
+            client_.report_killed(msg, 200ms);
+            break;
+        }
+        case wta::events::EventType::HandleDamage: {
+            const auto& dmg = std::get<wta::events::DamageEvent>(ev.payload);
+            wta::proto::DamageEvent msg{};
+            msg.timestamp = ev.timestamp;
+            msg.entity_id = dmg.entity_id;
+            msg.entity_type = dmg.is_platform ? "platform" : "target";
+            msg.damage_amount = dmg.damage;
+            client_.report_damage(msg, 200ms);
+            break;
+        }
+        case wta::events::EventType::Fired: {
+            const auto& fired = std::get<wta::events::FiredEvent>(ev.payload);
+            wta::proto::FiredEvent msg{};
+            msg.timestamp = ev.timestamp;
+            msg.platform_id = fired.platform_id;
+            msg.weapon = std::string(wta::core::weapon_names().lookup(fired.weapon));
+            client_.report_fired(msg, 200ms);
+            break;
+        }
+        default:
+            break;
     }
 }
 
 // 规划循环：根据事件和TTL决定是否重新规划任务
+// 请求在途时本线程继续收事件、采样并暂存下一请求，通信线程收到响应后立即发出暂存的请求
 void Orchestrator::loop_solver() {
-    using namespace std::chrono_literals;
+    std::vector<wta::events::EventPtr> batch;
+    batch.reserve(128);
     while (running_) {
-        // Drain events quickly and mark replan when needed
+        // Drain events in one batch and mark replan when needed
         {
-            wta::events::Event ev{};
-            int drained = 0;
-            while (bus_.try_pop(ev) && drained < 128) {
-                switch (ev.type) {
+            batch.clear();
+            solver_sub_->drain_into(batch, 128);
+            const double woke = now_sec();
+            // 事件按最新快照中的目标价值/层级打分，累计越过阈值并去抖后才重规划
+            const auto world = batch.empty() ? nullptr : snapshots_.latest();
+            for (const auto& ev : batch) {
+                solver_wake_.record_sec(woke - ev->timestamp);
+                // 执行器会按后续交战队列把空出的平台转入下一目标，无需为该击毁求解
+                if (handled_by_follow_on(*ev)) continue;
+                switch (ev->type) {
                     case wta::events::EventType::EntityKilled:
                     case wta::events::EventType::HandleDamage:
                     case wta::events::EventType::Fired:
                     case wta::events::EventType::ReplanRequest:
-                        pending_replan_ = true; break;
+                        trigger_.on_event(*ev, world.get(), woke);
+                        replan_trigger_ts_ = std::max(replan_trigger_ts_, ev->timestamp);
+                        if (trace_origin_ == 0.0) {
+                            trace_origin_ = ev->timestamp;
+                            trace_pickup_ = woke;
+                        }
+                        break;
                     default: break;
                 }
-                ++drained;
             }
+            if (trigger_.due(woke)) pending_replan_ = true;
+            const double ttl_deadline = ttl_deadline_ts_.exchange(0.0);
+            if (ttl_deadline > 0.0) solver_wake_.record_sec(woke - ttl_deadline);
+        }
+
+        handle_result();
+        
+        // 到期时已有提前就绪的推测方案：直接切换，无需求解
+        if (ttl_expired_ && held_plan_) {
+            auto held = std::move(*held_plan_);
+            held_plan_.reset();
+            spec_swapped_.fetch_add(1, std::memory_order_relaxed);
+            commit_plan(std::move(held));
         }
 
         const double t = now_sec();
-        if (need_replan(t) && t >= next_allowed_solve_ts_) {
-            // 采样当前状态
-            wta::proto::SolveRequest temp_req{};
-            temp_req.timestamp = t;
-            sampler_.sample(temp_req);
-            
-            // 构建规划请求
-            wta::proto::PlanRequest plan_req{};
-            plan_req.timestamp = t;
-            plan_req.reason = pending_replan_ ? "event_triggered" : "ttl_expired";
-            plan_req.platforms = std::move(temp_req.platforms);
-            plan_req.targets = std::move(temp_req.targets);
-
-            wta::proto::PlanResponse plan_resp{};
-            const auto ok = client_.request_plan(plan_req, plan_resp, 1000ms);
-            if (ok && plan_resp.status == "ok") {
-                // 保存规划结果
-                last_resp_ = plan_resp;
-                last_solve_ts_ = t;
-                ttl_sec_ = plan_resp.ttl_sec;
-                next_allowed_solve_ts_ = t + 0.5; // 节流窗口
-                pending_replan_ = false;
-                
-                // 应用分配方案（executor 应该接受 PlanResponse）
-                exec_.apply_assignment(plan_resp);
-            } else {
-                // 失败：维持旧解，稍后重试
-                next_allowed_solve_ts_ = t + 0.5;
+        if (speculate_due_.exchange(false) && !pending_replan_ && !plan_outstanding_ && !held_plan_) {
+            stage_request(t, true);
+        }
+        if (need_replan() && t >= next_allowed_solve_ts_) {
+            stage_request(t, false);
+        }
+        // 需要重规划但处于节流窗口：等到窗口结束；去抖中等到窗口结束；否则只由事件、TTL 定时器或求解完成唤醒
+        if (need_replan()) {
+            solver_sub_->wait_until(to_time_point(next_allowed_solve_ts_));
+        } else if (std::isfinite(trigger_.due_at())) {
+            solver_sub_->wait_until(to_time_point(trigger_.due_at()));
+        } else {
+            solver_sub_->wait();
+        }
+    }
+}
+
+void Orchestrator::stage_request(double t, bool speculative) {
+    // 推测求解不是对触发的反应，不追踪
+    wta::core::TraceContext trace;
+    if (!speculative) {
+        trace.id = ++trace_seq_;
+        if (trace_origin_ > 0.0) {
+            trace.origin = trace_origin_;
+            trace.mark(wta::core::TraceStage::Pickup, trace_pickup_);
+        } else {
+            trace.origin = (ttl_expired_ && plan_expiry_ts_ > 0.0) ? plan_expiry_ts_ : t;
+        }
+        trace.mark(wta::core::TraceStage::Trigger, t);
+    }
+    
+    // 取不早于触发事件的快照；上报线程刚采样过时无需再次持有引擎锁
+    const auto snap = snapshots_.acquire(kSolveSnapshotMaxAge, replan_trigger_ts_);
+    if (trace) trace.mark(wta::core::TraceStage::Sample);
+    
+    // 构建规划请求
+    PlanJob job;
+    job.snap = snap;
+    job.trace = trace;
+    job.req.timestamp = t;
+    job.req.reason = speculative ? "speculative" : (pending_replan_ ? "event_triggered" : "ttl_expired");
+    job.req.platforms = snap->platforms;
+    job.req.targets = snap->targets;
+    job.req.snapshot_version = snap->version;
+    job.req.max_follow_ons = wta::core::tunables().plan_max_follow_ons.load(std::memory_order_relaxed);
+    job.speculative = speculative;
+    // 非推测请求开启新纪元，之前发出的推测请求随之作废
+    job.epoch = speculative ? plan_epoch_ : ++plan_epoch_;
+    job.input_key = hash_plan_inputs(job.req, plan_cache_.options().grid);
+    
+    // 量化后的输入与近期某次求解相同：复用该方案并重新计 TTL，不访问求解器。
+    // 有请求在途时不复用，避免较旧的在途结果随后覆盖
+    std::optional<PlanResult> cached;
+    if (!plan_outstanding_) {
+        if (const auto* hit = plan_cache_.find(job.input_key, t)) {
+            cached.emplace();
+            cached->ok = true;
+            cached->resp = *hit;
+            cached->resp.timestamp = t;
+            cached->resp.snapshot_version = snap->version;
+            cached->snap = snap;
+            cached->trace = job.trace;
+            cached->input_key = job.input_key;
+            cached->from_cache = true;
+        }
+        cache_hits_.store(plan_cache_.hits(), std::memory_order_relaxed);
+        cache_misses_.store(plan_cache_.misses(), std::memory_order_relaxed);
+    }
+    if (!cached) {
+        {
+            std::lock_guard<std::mutex> lk(plan_m_);
+            staged_ = std::move(job);
+        }
+        plan_cv_.notify_one();
+        plan_outstanding_ = true;
+    }
+    
+    if (speculative) {
+        if (cached) {
+            // 缓存命中的推测方案同样留到到期时切换
+            held_plan_ = std::move(cached);
+            return;
+        }
+        // 推测请求不占用节流窗口，也不影响当前方案的 TTL
+        speculating_ = true;
+        spec_issued_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    
+    // 本次请求已覆盖这些触发原因；在途期间的新事件会再暂存一个更新的请求
+    trigger_.on_solve(t, trigger_.due(t));
+    solves_triggered_.store(trigger_.stats().triggered, std::memory_order_relaxed);
+    solves_avoided_.store(trigger_.stats().absorbed, std::memory_order_relaxed);
+    pending_replan_ = false;
+    replan_trigger_ts_ = 0.0;
+    trace_origin_ = 0.0;
+    timers_.cancel(ttl_timer_);
+    timers_.cancel(spec_timer_);
+    ttl_expired_ = false;
+    speculate_due_ = false;
+    if (speculating_ || held_plan_) {
+        spec_discarded_.fetch_add(1, std::memory_order_relaxed);
+    }
+    speculating_ = false;
+    held_plan_.reset();
+    // 节流窗口（运行时参数 solve.throttle_ms）
+    next_allowed_solve_ts_ = t + wta::core::tunables().solve_throttle_ms.load(std::memory_order_relaxed) * 1e-3;
+    if (cached) commit_plan(std::move(*cached));
+}
+
+void Orchestrator::handle_result() {
+    std::optional<PlanResult> result;
+    bool outstanding = false;
+    {
+        std::lock_guard<std::mutex> lk(plan_m_);
+        result.swap(completed_);
+        outstanding = staged_.has_value() || planner_busy_;
+    }
+    plan_outstanding_ = outstanding;
+    if (!result) return;
+    const bool ok = result->ok && result->resp.status == "ok";
+    
+    if (result->speculative) {
+        // 已被事件触发的重规划取代（作废计数在暂存新请求时已记录）
+        if (result->epoch != plan_epoch_) return;
+        speculating_ = false;
+        // 推测失败：到期后走普通流程
+        if (!ok) return;
+        if (ttl_expired_) {
+            // 到期后才返回：立即采纳
+            spec_swapped_.fetch_add(1, std::memory_order_relaxed);
+            commit_plan(std::move(*result));
+        } else {
+            held_plan_ = std::move(result);
+        }
+        return;
+    }
+    
+    if (ok) {
+        commit_plan(std::move(*result));
+    } else if (!outstanding) {
+        // 失败：维持旧解，节流窗口结束后重试
+        pending_replan_ = true;
+    }
+}
+
+void Orchestrator::commit_plan(PlanResult&& result) {
+    const double t = now_sec();
+    if (ttl_expired_ && plan_expiry_ts_ > 0.0) {
+        plan_staleness_.record_sec(t - plan_expiry_ts_);
+    }
+    
+    if (result.input_key != 0 && !result.from_cache) {
+        plan_cache_.insert(result.input_key, result.resp, t);
+    }
+    
+    // 不论是否替换，新结果都确认了当前局面下的方案，按它续期
+    last_solve_ts_ = t;
+    ttl_sec_ = result.resp.ttl_sec;
+    if (!plan_outstanding_) {
+        arm_ttl_timer(ttl_sec_);
+    } else {
+        ttl_expired_ = false;
+    }
+    
+    // 最小改进滞回：同一规模下提升不足的新方案不下发，执行中的任务保持不变
+    if (last_resp_ && !trigger_.should_replace(*last_resp_, result.resp)) {
+        plans_kept_.store(trigger_.stats().kept, std::memory_order_relaxed);
+        return;
+    }
+    
+    // 后续交战覆盖的目标：有队列的平台当前所打击的目标，以及各步骤的前置目标
+    follow_on_covered_.clear();
+    const auto& resp = result.resp;
+    for (const auto& queue : resp.follow_ons) {
+        if (queue.steps.empty()) continue;
+        const size_t row = static_cast<size_t>(queue.platform_id - 1);
+        for (size_t j = 0; row < resp.n_platforms && j < resp.n_targets; ++j) {
+            const size_t idx = wta::types::idx_row_major(row, j, resp.n_targets);
+            if (idx < resp.assignment.size() && resp.assignment[idx] > 0) {
+                follow_on_covered_.insert(static_cast<wta::types::TargetId>(j + 1));
+                break;
             }
         }
-        std::this_thread::sleep_for(50ms);
+        for (const auto& step : queue.steps) {
+            if (step.after_target_id != 0) follow_on_covered_.insert(step.after_target_id);
+        }
     }
+    
+    // 保存规划结果
+    last_resp_ = result.resp;
+    
+    // 经邮箱转交执行线程校验并应用（仅保留最新方案），立即唤醒执行线程
+    plan_mailbox_.publish(std::make_unique<PlanResult>(std::move(result)));
+    plan_ready_ts_ = now_sec();
+    exec_sub_->wake();
+}
+
+bool Orchestrator::handled_by_follow_on(const wta::events::Event& ev) {
+    if (ev.type != wta::events::EventType::EntityKilled || follow_on_covered_.empty()) return false;
+    const auto& killed = std::get<wta::events::EntityKilledEvent>(ev.payload);
+    if (killed.is_platform || follow_on_covered_.erase(killed.entity_id) == 0) return false;
+    kills_local_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+// 求解通信循环：取出最新暂存的请求发送，完成后交回规划线程；同一时刻只有一个请求在途
+void Orchestrator::loop_planner() {
+    while (running_) {
+        PlanJob job;
+        {
+            std::unique_lock<std::mutex> lk(plan_m_);
+            plan_cv_.wait(lk, [&]{ return staged_.has_value() || !running_; });
+            if (!running_) break;
+            job = std::move(*staged_);
+            staged_.reset();
+            planner_busy_ = true;
+        }
+        
+        PlanResult result;
+        result.snap = std::move(job.snap);
+        result.speculative = job.speculative;
+        result.epoch = job.epoch;
+        result.input_key = job.input_key;
+        const auto sent = clock::now();
+        {
+            // 序列化在客户端内部完成，经线程局部的当前追踪打点
+            wta::core::TraceScope scope(&job.trace);
+            result.ok = solve_plan(job.req, result.resp);
+        }
+        if (job.trace) job.trace.mark(wta::core::TraceStage::RoundTrip);
+        result.trace = job.trace;
+        if (result.ok) {
+            solve_latency_.record_sec(std::chrono::duration<double>(clock::now() - sent).count());
+        }
+        // 求解器未回填版本时按请求补上（REQ/REP 一问一答，响应必然对应本请求）
+        if (result.resp.snapshot_version == 0) result.resp.snapshot_version = job.req.snapshot_version;
+        {
+            std::lock_guard<std::mutex> lk(plan_m_);
+            completed_ = std::move(result);
+            planner_busy_ = false;
+        }
+        solver_sub_->wake();
+    }
+}
+
+void Orchestrator::tune_request(wta::proto::PlanRequest& req) {
+    const auto d = tuner_.apply(req.config.bpso, req.platforms.size(), req.targets.size());
+    LOG(INFO) << "Solve tuner: " << req.platforms.size() << "x" << req.targets.size()
+              << " -> particles=" << d.n_particles << " iterations=" << d.n_iterations
+              << " predicted=" << static_cast<int>(d.predicted_sec * 1000.0) << "ms"
+              << " deadline=" << static_cast<int>(tuner_.options().deadline_sec * 1000.0) << "ms"
+              << (d.clamped ? " (clamped)" : "")
+              << " model[a=" << tuner_.intercept() * 1000.0 << "ms b=" << tuner_.slope() << "s/unit]";
 }
 
+void Orchestrator::observe_solve(const wta::proto::PlanRequest& req, const wta::proto::PlanResponse& resp) {
+    if (resp.status != "ok") return;
+    tuner_.observe(req.platforms.size(), req.targets.size(), req.config.bpso.n_particles,
+                   req.config.bpso.n_iterations, resp.stats.computation_time);
+}
+
+void Orchestrator::set_shadow_solver(wta::net::ISolverClient* shadow) {
+    if (running_) return;
+    if (!shadow) {
+        shadow_.reset();
+        return;
+    }
+    shadow_ = std::make_unique<ShadowSolver>(*shadow, [](const ShadowComparison& c) {
+        LOG(INFO) << "Shadow solve #" << c.id << ": primary=" << static_cast<int>(c.primary_sec * 1000.0) << "ms"
+                  << (c.primary_ok ? "" : " failed") << " fitness=" << c.primary_fitness
+                  << " | shadow=" << static_cast<int>(c.shadow_sec * 1000.0) << "ms"
+                  << (c.shadow_ok ? "" : " failed") << " fitness=" << c.shadow_fitness
+                  << " | agreement=" << static_cast<int>(c.agreement * 100.0 + 0.5) << "%";
+    });
+}
+
+bool Orchestrator::solve_plan(wta::proto::PlanRequest& req, wta::proto::PlanResponse& out) {
+    if (!shadow_) return solve_primary(req, out);
+    
+    // 影子求解器收到同一整体请求（按整体规模调参），与主求解并行；主路径不等待影子结果
+    auto whole = req;
+    tuner_.apply(whole.config.bpso, whole.platforms.size(), whole.targets.size());
+    const uint64_t shadow_id = shadow_->submit(std::move(whole), solve_timeout());
+    const auto t0 = clock::now();
+    const bool ok = solve_primary(req, out);
+    shadow_->primary_done(shadow_id, ok, out, std::chrono::duration<double>(clock::now() - t0).count());
+    return ok;
+}
+
+bool Orchestrator::solve_primary(wta::proto::PlanRequest& req, wta::proto::PlanResponse& out) {
+    const size_t pairs = req.platforms.size() * req.targets.size();
+    const auto clusters = (!partition_opts_.enabled || pairs < partition_opts_.min_split_pairs)
+        ? std::vector<Cluster>{}
+        : pack_clusters(partition_world(req), partition_opts_.max_parallel);
+    if (clusters.size() <= 1) {
+        tune_request(req);
+        const bool ok = client_.request_plan(req, out, solve_timeout());
+        if (ok) observe_solve(req, out);
+        return ok;
+    }
+    
+    // 每个子请求独立建连，可以并行在途；本线程负责第一个簇。调参与模型更新都留在本线程
+    const size_t n = clusters.size();
+    std::vector<wta::proto::PlanRequest> subs;
+    subs.reserve(n);
+    for (const auto& c : clusters) {
+        subs.push_back(make_cluster_request(req, c));
+        subs.back().cluster_index = static_cast<int>(subs.size() - 1);
+        tune_request(subs.back());
+    }
+    std::vector<wta::proto::PlanResponse> parts(n);
+    std::vector<char> oks(n, 0);
+    std::vector<double> secs(n, 0.0);
+    const auto timeout = solve_timeout();
+    auto solve_one = [&](size_t k) {
+        const auto t0 = clock::now();
+        oks[k] = client_.request_plan(subs[k], parts[k], timeout) ? 1 : 0;
+        secs[k] = std::chrono::duration<double>(clock::now() - t0).count();
+    };
+    std::vector<std::future<void>> pending;
+    pending.reserve(n - 1);
+    for (size_t k = 1; k < n; ++k) pending.push_back(std::async(std::launch::async, solve_one, k));
+    solve_one(0);
+    for (auto& f : pending) f.get();
+    
+    partitioned_solves_.fetch_add(1, std::memory_order_relaxed);
+    cluster_requests_.fetch_add(n, std::memory_order_relaxed);
+    std::ostringstream detail;
+    bool all_ok = true;
+    for (size_t k = 0; k < n; ++k) {
+        cluster_solve_.record_sec(secs[k]);
+        all_ok = all_ok && oks[k];
+        if (oks[k]) observe_solve(subs[k], parts[k]);
+        detail << " [" << clusters[k].platforms.size() << "x" << clusters[k].targets.size() << " "
+               << static_cast<int>(secs[k] * 1000.0) << "ms" << (oks[k] ? "" : " failed") << "]";
+    }
+    LOG(INFO) << "Partitioned solve: " << n << " clusters for " << req.platforms.size() << "x"
+              << req.targets.size() << detail.str();
+    return all_ok && stitch_plans(req, clusters, parts, out);
+}
+
+void Orchestrator::apply_pending_plan() {
+    const auto plan = plan_mailbox_.take();
+    if (!plan) return;
+    
+    // 快照之后收到击毁事件的实体
+    const double planned_at = plan->snap->timestamp;
+    std::unordered_set<wta::types::PlatformId> dead_platforms;
+    std::unordered_set<wta::types::TargetId> dead_targets;
+    for (const auto& [id, ts] : killed_platforms_) {
+        if (ts >= planned_at) dead_platforms.insert(id);
+    }
+    for (const auto& [id, ts] : killed_targets_) {
+        if (ts >= planned_at) dead_targets.insert(id);
+    }
+    
+    const auto check = validate_plan(plan->resp, *plan->snap, *snapshots_.latest(), dead_platforms, dead_targets);
+    if (check.rejected) {
+        plans_rejected_.fetch_add(1, std::memory_order_relaxed);
+        LOG(INFO) << "Plan v" << plan->resp.snapshot_version << " rejected: " << check.dropped << "/"
+                  << check.assigned << " engagements stale";
+        return;
+    }
+    if (check.dropped > 0) {
+        plans_partial_.fetch_add(1, std::memory_order_relaxed);
+        LOG(INFO) << "Plan v" << plan->resp.snapshot_version << " partially applied: dropped "
+                  << check.dropped << "/" << check.assigned << " stale engagements";
+    } else {
+        plans_applied_.fetch_add(1, std::memory_order_relaxed);
+    }
+    // 快照之前的击毁已反映在该快照中，之后的方案基于同样新或更新的快照，不会再用到
+    erase_killed_before(killed_platforms_, planned_at);
+    erase_killed_before(killed_targets_, planned_at);
+    // 之前的方案还没等到命令就被替换：放弃那条追踪
+    active_trace_.reset();
+    if (plan->trace) {
+        plan->trace.mark(wta::core::TraceStage::Handoff);
+        active_trace_ = plan->trace;
+        plans_commanded_at_apply_ = exec_.plans_commanded();
+    }
+    exec_.apply_assignment(plan->resp);
+    
+    // 本地修复模型随方案重建；快照之后已失效的实体直接标记
+    repair_.reset(plan->resp, *snapshots_.latest());
+    for (auto id : dead_platforms) repair_.on_platform_killed(id);
+    for (auto id : dead_targets) repair_.on_target_killed(id);
+}
+
+void Orchestrator::repair_after_kills(const std::vector<wta::types::TargetId>& killed) {
+    if (repair_.empty() || !wta::core::tunables().plan_local_repair.load(std::memory_order_relaxed)) return;
+    const auto t0 = clock::now();
+    std::unordered_map<wta::types::PlatformId, wta::types::TargetId> moves;
+    for (auto tid : killed) {
+        for (const auto& m : repair_.on_target_killed(tid)) moves[m.platform] = m.target;
+    }
+    if (moves.empty()) return;
+    const size_t applied = exec_.reassign(moves);
+    const double took = std::chrono::duration<double>(clock::now() - t0).count();
+    repair_time_.record_sec(took);
+    repaired_platforms_.fetch_add(applied, std::memory_order_relaxed);
+    LOG(INFO) << "Local repair: reassigned " << applied << "/" << moves.size() << " freed platforms in "
+              << static_cast<int64_t>(took * 1e6) << "us";
+}
+
+// 执行循环：有进行中的任务时按控制节拍推进；任务全部挂起时睡到最近的阶段截止；
+// 空闲时只由击毁事件或新分配唤醒
 void Orchestrator::loop_executor() {
-    using namespace std::chrono_literals;
+    std::vector<wta::events::EventPtr> batch;
+    std::vector<wta::types::TargetId> killed_now;
     while (running_) {
+        batch.clear();
+        killed_now.clear();
+        exec_sub_->drain_into(batch);
+        const double woke = now_sec();
+        for (const auto& ev : batch) {
+            executor_wake_.record_sec(woke - ev->timestamp);
+            if (ev->type != wta::events::EventType::EntityKilled) continue;
+            const auto& killed = std::get<wta::events::EntityKilledEvent>(ev->payload);
+            auto& killed_at = killed.is_platform ? killed_platforms_ : killed_targets_;
+            killed_at[killed.entity_id] = ev->timestamp;
+            // 执行器不单独订阅击毁事件，由这里转发（下一次 tick 据此刷新实体状态）
+            exec_.on_entity_killed(killed.entity_id, killed.is_platform);
+            if (killed.is_platform) {
+                repair_.on_platform_killed(killed.entity_id);
+            } else {
+                killed_now.push_back(killed.entity_id);
+            }
+        }
+        const double plan_ts = plan_ready_ts_.exchange(0.0);
+        if (plan_ts > 0.0) executor_wake_.record_sec(woke - plan_ts);
+        
+        apply_pending_plan();
         exec_.tick();
-        std::this_thread::sleep_for(50ms);
+        // tick 已按击毁事件刷新实体状态；空出的平台立即改派，不等下一次完整求解
+        if (!killed_now.empty()) repair_after_kills(killed_now);
+        const auto ticked = clock::now();
+        // 只有发给新增/改派平台的命令才算；没有变化的方案不产生追踪记录，等下一个方案替换
+        if (active_trace_ && exec_.plans_commanded() > plans_commanded_at_apply_) {
+            active_trace_->mark(wta::core::TraceStage::FirstCommand);
+            pipeline_trace_.record(*active_trace_);
+            active_trace_.reset();
+        }
+        
+        const auto next = exec_.next_tick();
+        if (next == clock::time_point::max()) {
+            exec_sub_->wait();
+        } else {
+            // 有进行中的任务时按最小节拍 tick（运行时参数 exec.tick_ms），事件/新分配可提前唤醒
+            const auto min_tick = std::chrono::milliseconds(
+                wta::core::tunables().exec_tick_ms.load(std::memory_order_relaxed));
+            exec_sub_->wait_until(std::max(next, ticked + min_tick));
+        }
     }
 }
 
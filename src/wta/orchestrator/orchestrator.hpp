@@ -1,11 +1,30 @@
 #pragma once
 #include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include "../core/latency_histogram.hpp"
+#include "../core/latest_mailbox.hpp"
+#include "../core/pipeline_trace.hpp"
+#include "../core/runtime_params.hpp"
+#include "../core/timer_wheel.hpp"
 #include "../world/event_bus.hpp"
 #include "../net/solver_client.hpp"
 #include "../world/world_sampler.hpp"
+#include "../world/snapshot_service.hpp"
 #include "../exec/executor.hpp"
+#include "partitioner.hpp"
+#include "plan_cache.hpp"
+#include "plan_repair.hpp"
+#include "plan_validation.hpp"
+#include "replan_trigger.hpp"
+#include "report_cadence.hpp"
+#include "shadow_solver.hpp"
+#include "solve_tuner.hpp"
 
 namespace wta::orch {
 
@@ -14,33 +33,214 @@ public:
     Orchestrator(wta::events::EventBus& bus,
                  wta::net::ISolverClient& client,
                  wta::world::IWorldSampler& sampler,
-                 wta::exec::IExecutor& executor)
-    : bus_(bus), client_(client), sampler_(sampler), exec_(executor) {}
+                 wta::exec::IExecutor& executor,
+                 ReplanTriggerOptions trigger_opts = {},
+                 PartitionOptions partition_opts = {},
+                 SolveTunerOptions tuner_opts = {},
+                 PlanCacheOptions cache_opts = {})
+    : bus_(bus), client_(client), snapshots_(sampler), exec_(executor), trigger_(trigger_opts),
+      partition_opts_(partition_opts), tuner_(tuner_opts), plan_cache_(cache_opts) {}
+    ~Orchestrator() { stop(); }
 
     void start();
     void stop();
 
+    /**
+     * @brief 影子模式：每个规划请求同时发往 shadow，只记录延迟/适应度/分配一致度对比，结果不应用
+     * @param shadow 候选求解器（如第二个端点），nullptr 关闭；须在 start() 之前设置，生命周期长于本对象
+     */
+    void set_shadow_solver(wta::net::ISolverClient* shadow);
+    const ShadowSolver* shadow_solver() const { return shadow_.get(); }
+
+    // 唤醒延迟：触发源（事件时间戳/定时器截止/分配下发）到线程开始处理的时间
+    const wta::core::LatencyHistogram& solver_wake_latency() const { return solver_wake_; }
+    const wta::core::LatencyHistogram& reporter_wake_latency() const { return reporter_wake_; }
+    const wta::core::LatencyHistogram& executor_wake_latency() const { return executor_wake_; }
+    const wta::world::SnapshotService& snapshots() const { return snapshots_; }
+
+    // 当前自适应上报间隔及原因（可在任意线程读取）
+    std::chrono::milliseconds report_interval() const {
+        return std::chrono::milliseconds(report_interval_ms_.load(std::memory_order_relaxed));
+    }
+    CadenceReason report_reason() const { return report_reason_.load(std::memory_order_relaxed); }
+
+    // 流水线统计：下发的方案中完整应用/部分应用/拒绝的数量
+    uint64_t plans_applied() const { return plans_applied_.load(std::memory_order_relaxed); }
+    uint64_t plans_partial() const { return plans_partial_.load(std::memory_order_relaxed); }
+    uint64_t plans_rejected() const { return plans_rejected_.load(std::memory_order_relaxed); }
+
+    // 推测求解：发出数/在到期时切换的数量/因事件重规划而作废的数量；方案过期时长分布
+    uint64_t speculative_issued() const { return spec_issued_.load(std::memory_order_relaxed); }
+    uint64_t speculative_swapped() const { return spec_swapped_.load(std::memory_order_relaxed); }
+    uint64_t speculative_discarded() const { return spec_discarded_.load(std::memory_order_relaxed); }
+    const wta::core::LatencyHistogram& plan_staleness() const { return plan_staleness_; }
+    const wta::core::LatencyHistogram& solve_latency() const { return solve_latency_; }
+
+    // 触发策略：事件触发的求解次数，以及未单独触发求解的事件数（旧策略下每个事件都会重规划）
+    uint64_t solves_triggered() const { return solves_triggered_.load(std::memory_order_relaxed); }
+    uint64_t solves_avoided() const { return solves_avoided_.load(std::memory_order_relaxed); }
+    // 适应度提升不足 min_improvement、保留当前方案的求解结果数
+    uint64_t plans_kept() const { return plans_kept_.load(std::memory_order_relaxed); }
+
+    // 分簇求解：拆分求解的次数、子请求数及单个子请求耗时
+    uint64_t partitioned_solves() const { return partitioned_solves_.load(std::memory_order_relaxed); }
+    uint64_t cluster_requests() const { return cluster_requests_.load(std::memory_order_relaxed); }
+    const wta::core::LatencyHistogram& cluster_solve_time() const { return cluster_solve_; }
+
+    // 方案缓存：量化输入与近期求解相同而直接复用的次数/需要求解的次数
+    uint64_t plan_cache_hits() const { return cache_hits_.load(std::memory_order_relaxed); }
+    uint64_t plan_cache_misses() const { return cache_misses_.load(std::memory_order_relaxed); }
+
+    // 多步方案：由执行器按后续交战队列本地处理、不再触发重规划的目标击毁事件数
+    uint64_t kills_handled_locally() const { return kills_local_.load(std::memory_order_relaxed); }
+
+    // 本地修复：目标被毁后不经求解器直接改派的平台数，及每次修复（打分 + 下发）耗时
+    uint64_t repaired_platforms() const { return repaired_platforms_.load(std::memory_order_relaxed); }
+    const wta::core::LatencyHistogram& repair_time() const { return repair_time_; }
+
+    // 反应时间：触发事件 -> 第一条 UAV 控制命令，按流水线阶段分解
+    const wta::core::PipelineTrace& pipeline_trace() const { return pipeline_trace_; }
+
 private:
+    // 规划流水线：规划线程采样并暂存请求 -> 通信线程发送并等待 -> 规划线程收取 -> 执行线程校验应用
+    struct PlanJob {
+        wta::proto::PlanRequest req;
+        wta::world::WorldSnapshotPtr snap;
+        bool speculative{false};
+        uint64_t epoch{0};
+        wta::core::TraceContext trace;
+        uint64_t input_key{0};
+    };
+    struct PlanResult {
+        bool ok{false};
+        wta::proto::PlanResponse resp;
+        wta::world::WorldSnapshotPtr snap;   // 方案所基于的快照
+        bool speculative{false};             // TTL 到期前提前发出的推测求解
+        uint64_t epoch{0};                   // 发出时的方案纪元，之后有事件触发的重规划则作废
+        wta::core::TraceContext trace;       // 触发 -> 第一条控制命令的分阶段时间
+        uint64_t input_key{0};               // 量化输入哈希（方案缓存键）
+        bool from_cache{false};              // 复用的缓存方案，未经求解器
+    };
+
     void loop_reporter();   // 持续上报数据给前端
     void loop_solver();     // 规划任务分配
     void loop_executor();   // 执行任务
-    bool need_replan(double now) const;
+    void loop_planner();    // 与求解器通信（请求在途时规划线程继续采样、准备下一请求）
+    bool need_replan() const;
+    void stage_request(double t, bool speculative);  // 采样并放入待发送槽（新请求覆盖未发出的旧请求）
+    void handle_result();                            // 处理求解完成的方案，转交执行线程
+    bool solve_plan(wta::proto::PlanRequest& req, wta::proto::PlanResponse& out);     // 通信线程：主求解（影子模式下并行发往影子）
+    bool solve_primary(wta::proto::PlanRequest& req, wta::proto::PlanResponse& out);  // 通信线程：按簇拆分并行求解后拼接
+    void tune_request(wta::proto::PlanRequest& req);                                   // 通信线程：按规模与截止时间设定 BPSO 参数
+    void observe_solve(const wta::proto::PlanRequest& req, const wta::proto::PlanResponse& resp);
+    void commit_plan(PlanResult&& result);           // 采纳方案：重置 TTL 并经邮箱交给执行线程
+    double predicted_solve_sec() const;              // 按实测求解往返耗时预测下一次求解需要多久
+    void apply_pending_plan();                       // 执行线程：校验并应用最新方案
+    void repair_after_kills(const std::vector<wta::types::TargetId>& killed);  // 执行线程：为空出的平台本地改派
+    void arm_ttl_timer(double ttl_sec);              // 规划成功后重置 TTL 到期定时器
+    void schedule_report(std::chrono::milliseconds delay);  // 上报线程：按自适应间隔预约下一次上报
+    void publish_cadence();                          // 上报线程：对外发布当前间隔与原因
+    void log_stats();                                // 周期性输出唤醒延迟/快照/流水线统计
+    void forward_event(const wta::events::Event& ev);  // 引擎事件 -> report_killed/report_damage/report_fired
+    bool handled_by_follow_on(const wta::events::Event& ev);  // 规划线程：击毁事件已由当前方案的后续交战覆盖
 
     std::atomic<bool> running_{false};
     std::thread th_reporter_;   // 数据上报线程
     std::thread th_solver_;     // 规划线程
     std::thread th_executor_;   // 执行线程
+    std::thread th_planner_;    // 求解通信线程
 
     wta::events::EventBus& bus_;
     wta::net::ISolverClient& client_;
-    wta::world::IWorldSampler& sampler_;
+    wta::world::SnapshotService snapshots_;      // 上报与规划共享的版本化世界快照
     wta::exec::IExecutor& exec_;
+    wta::events::SubscriptionPtr solver_sub_;   // 规划线程的事件订阅（start 时创建）
+    wta::events::SubscriptionPtr reporter_sub_; // 上报线程的事件订阅（转发给前端/求解器）
+    wta::events::SubscriptionPtr exec_sub_;     // 执行线程的事件订阅（击毁事件；新分配下发时 wake）
+
+    // TTL 到期、上报节拍与执行器的阶段等待共用一个时间轮，到期时唤醒对应订阅，线程无需轮询
+    wta::core::TimerWheel timers_;
+    wta::core::TimerId ttl_timer_{wta::core::kInvalidTimer};
+    wta::core::TimerId report_timer_{wta::core::kInvalidTimer};
+    wta::core::TimerId spec_timer_{wta::core::kInvalidTimer};
+    std::atomic<bool> ttl_expired_{false};
+    std::atomic<bool> report_due_{true};
+    std::atomic<bool> speculate_due_{false};
+    std::atomic<double> ttl_deadline_ts_{0.0};   // TTL 定时器触发时写入截止时间，规划线程取走后计入延迟
+    std::atomic<double> plan_ready_ts_{0.0};     // 新分配下发时间，执行线程取走后计入延迟
+
+    wta::core::LatencyHistogram solver_wake_;
+    wta::core::LatencyHistogram reporter_wake_;
+    wta::core::LatencyHistogram executor_wake_;
+    std::chrono::steady_clock::time_point last_stats_log_{};
+
+    // 自适应上报节拍（仅上报线程访问，对外通过原子变量发布）
+    ReportCadence cadence_;
+    wta::world::WorldSnapshotPtr last_reported_;
+    std::chrono::steady_clock::time_point next_report_at_{};
+    std::atomic<uint32_t> report_interval_ms_{0};
+    std::atomic<CadenceReason> report_reason_{CadenceReason::Startup};
+
+    std::mutex plan_m_;
+    std::condition_variable plan_cv_;
+    std::optional<PlanJob> staged_;          // 待发送（仅保留最新）
+    std::optional<PlanResult> completed_;    // 已完成待规划线程处理（仅保留最新）
+    bool planner_busy_{false};               // 通信线程正在等待响应（plan_m_ 保护）
+    bool plan_outstanding_{false};           // 规划线程视角：有请求暂存或在途
+    wta::core::LatestMailbox<PlanResult> plan_mailbox_;   // 规划线程 -> 执行线程（无锁，仅保留最新）
+    // 执行线程记录的击毁时间，用于判断方案所基于的快照之后哪些实体已失效；应用方案时删除早于其快照的记录
+    std::unordered_map<wta::types::PlatformId, double> killed_platforms_;
+    std::unordered_map<wta::types::TargetId, double> killed_targets_;
+    PlanRepair repair_;                                   // 当前方案的本地修复模型（仅执行线程访问）
+    wta::core::LatencyHistogram repair_time_;
+    std::atomic<uint64_t> repaired_platforms_{0};
+    std::atomic<uint64_t> plans_applied_{0};
+    std::atomic<uint64_t> plans_partial_{0};
+    std::atomic<uint64_t> plans_rejected_{0};
+
+    // 推测求解（仅规划线程访问，计数器除外）
+    uint64_t plan_epoch_{0};                  // 每次非推测请求递增
+    bool speculating_{false};                 // 推测请求暂存或在途
+    std::optional<PlanResult> held_plan_;     // 提前就绪的推测方案，TTL 到期时切换
+    double plan_expiry_ts_{0.0};              // 当前方案的到期时间
+    wta::core::LatencyHistogram solve_latency_;    // 求解往返耗时（通信线程写入）
+    wta::core::LatencyHistogram plan_staleness_;   // 方案到期到新方案交付的间隔
+    std::atomic<uint64_t> spec_issued_{0};
+    std::atomic<uint64_t> spec_swapped_{0};
+    std::atomic<uint64_t> spec_discarded_{0};
 
     std::optional<wta::proto::PlanResponse> last_resp_{};
     double last_solve_ts_{0.0};
     double next_allowed_solve_ts_{0.0};
     double ttl_sec_{2.0};
     bool pending_replan_{true};
+    double replan_trigger_ts_{0.0};   // 触发本次重规划的最新事件时间，规划所用快照不得早于它
+    ReplanTrigger trigger_;           // 事件打分/去抖/滞回（仅规划线程访问）
+    std::atomic<uint64_t> solves_triggered_{0};
+    std::atomic<uint64_t> solves_avoided_{0};
+    std::atomic<uint64_t> plans_kept_{0};
+
+    // 分簇求解（通信线程写入）
+    PartitionOptions partition_opts_;
+    wta::core::LatencyHistogram cluster_solve_;
+    std::atomic<uint64_t> partitioned_solves_{0};
+    std::atomic<uint64_t> cluster_requests_{0};
+    SolveTuner tuner_;   // BPSO 规模自动调参（仅通信线程访问）
+    PlanCache plan_cache_;   // 近期输入 -> 方案（仅规划线程访问）
+    std::unique_ptr<ShadowSolver> shadow_;   // 影子模式（可选）
+    std::atomic<uint64_t> cache_hits_{0};
+    std::atomic<uint64_t> cache_misses_{0};
+    // 当前方案中击毁后由执行器本地推进的目标：有后续交战的平台的当前目标与各前置目标（仅规划线程访问）
+    std::unordered_set<wta::types::TargetId> follow_on_covered_;
+    std::atomic<uint64_t> kills_local_{0};
+
+    // 流水线追踪：规划线程记录最早的未处理触发事件，执行线程等到发给新增/改派平台的第一条命令后计入直方图
+    wta::core::PipelineTrace pipeline_trace_;
+    uint64_t trace_seq_{0};
+    double trace_origin_{0.0};
+    double trace_pickup_{0.0};
+    std::optional<wta::core::TraceContext> active_trace_;   // 执行线程：已应用、等待第一条命令
+    uint64_t plans_commanded_at_apply_{0};
 };
 
 } // namespace wta::orch
@@ -0,0 +1,169 @@
+#include "partitioner.hpp"
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+
+namespace wta::orch {
+
+namespace {
+
+struct DisjointSet {
+    std::vector<size_t> parent;
+
+    explicit DisjointSet(size_t n) : parent(n) { std::iota(parent.begin(), parent.end(), size_t{0}); }
+
+    size_t find(size_t x) {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    }
+
+    void unite(size_t a, size_t b) { parent[find(a)] = find(b); }
+};
+
+bool in_range(const wta::types::PlatformState& p, const wta::types::TargetState& t) {
+    const float dx = p.pos.x - t.pos.x;
+    const float dy = p.pos.y - t.pos.y;
+    return dx * dx + dy * dy <= p.max_range * p.max_range;
+}
+
+} // namespace
+
+std::vector<Cluster> partition_world(const wta::proto::PlanRequest& req) {
+    const size_t np = req.platforms.size();
+    const size_t nt = req.targets.size();
+    if (np == 0 || nt == 0) return {};
+    if (!req.config.model.enable_distance_constraint) {
+        Cluster all;
+        all.platforms.resize(np);
+        all.targets.resize(nt);
+        std::iota(all.platforms.begin(), all.platforms.end(), size_t{0});
+        std::iota(all.targets.begin(), all.targets.end(), size_t{0});
+        return {std::move(all)};
+    }
+
+    // 节点 0..np-1 为平台，np..np+nt-1 为目标
+    DisjointSet ds(np + nt);
+    std::vector<bool> reachable(nt, false);
+    std::vector<bool> armed(np, false);
+    for (size_t i = 0; i < np; ++i) {
+        for (size_t j = 0; j < nt; ++j) {
+            if (!in_range(req.platforms[i], req.targets[j])) continue;
+            ds.unite(i, np + j);
+            armed[i] = true;
+            reachable[j] = true;
+        }
+    }
+
+    std::unordered_map<int, size_t> target_index;
+    target_index.reserve(nt);
+    for (size_t j = 0; j < nt; ++j) target_index.emplace(req.targets[j].id, j);
+    for (size_t j = 0; j < nt; ++j) {
+        const auto& t = req.targets[j];
+        for (const auto* list : {&t.prerequisite_targets, &t.prerequisites}) {
+            for (int id : *list) {
+                auto it = target_index.find(id);
+                if (it != target_index.end()) ds.unite(np + j, np + it->second);
+            }
+        }
+    }
+
+    std::unordered_map<size_t, size_t> root_to_cluster;
+    std::vector<Cluster> clusters;
+    auto cluster_of = [&](size_t node) -> Cluster& {
+        auto [it, inserted] = root_to_cluster.emplace(ds.find(node), clusters.size());
+        if (inserted) clusters.emplace_back();
+        return clusters[it->second];
+    };
+    for (size_t i = 0; i < np; ++i) {
+        if (armed[i]) cluster_of(i).platforms.push_back(i);
+    }
+    // 射程外的前置目标随所在分量一起发出，保持时序约束完整
+    for (size_t j = 0; j < nt; ++j) {
+        const size_t root = ds.find(np + j);
+        if (reachable[j] || root_to_cluster.count(root)) cluster_of(np + j).targets.push_back(j);
+    }
+    clusters.erase(std::remove_if(clusters.begin(), clusters.end(),
+                                  [](const Cluster& c) { return c.platforms.empty() || c.targets.empty(); }),
+                   clusters.end());
+    return clusters;
+}
+
+std::vector<Cluster> pack_clusters(std::vector<Cluster> clusters, size_t max_groups) {
+    if (max_groups == 0 || clusters.size() <= max_groups) return clusters;
+    // 最大的先放，每次放进当前规模最小的组
+    std::sort(clusters.begin(), clusters.end(),
+              [](const Cluster& a, const Cluster& b) { return a.size() > b.size(); });
+    std::vector<Cluster> groups(max_groups);
+    for (auto& c : clusters) {
+        auto& g = *std::min_element(groups.begin(), groups.end(),
+                                    [](const Cluster& a, const Cluster& b) { return a.size() < b.size(); });
+        g.platforms.insert(g.platforms.end(), c.platforms.begin(), c.platforms.end());
+        g.targets.insert(g.targets.end(), c.targets.begin(), c.targets.end());
+    }
+    for (auto& g : groups) {
+        std::sort(g.platforms.begin(), g.platforms.end());
+        std::sort(g.targets.begin(), g.targets.end());
+    }
+    return groups;
+}
+
+wta::proto::PlanRequest make_cluster_request(const wta::proto::PlanRequest& whole, const Cluster& cluster) {
+    wta::proto::PlanRequest req;
+    req.timestamp = whole.timestamp;
+    req.reason = whole.reason;
+    req.config = whole.config;
+    req.snapshot_version = whole.snapshot_version;
+    req.max_follow_ons = whole.max_follow_ons;
+    req.platforms.reserve(cluster.platforms.size());
+    for (size_t i : cluster.platforms) req.platforms.push_back(whole.platforms[i]);
+    req.targets.reserve(cluster.targets.size());
+    for (size_t j : cluster.targets) req.targets.push_back(whole.targets[j]);
+    return req;
+}
+
+bool stitch_plans(const wta::proto::PlanRequest& whole, const std::vector<Cluster>& clusters,
+                  const std::vector<wta::proto::PlanResponse>& parts, wta::proto::PlanResponse& out) {
+    if (clusters.size() != parts.size()) return false;
+    const size_t np = whole.platforms.size();
+    const size_t nt = whole.targets.size();
+
+    out = wta::proto::PlanResponse{};
+    out.status = "ok";
+    out.timestamp = whole.timestamp;
+    out.n_platforms = np;
+    out.n_targets = nt;
+    out.assignment.assign(np * nt, 0);
+    out.snapshot_version = whole.snapshot_version;
+    out.stats.is_valid = true;
+    out.ttl_sec = parts.empty() ? out.ttl_sec : parts.front().ttl_sec;
+
+    for (size_t k = 0; k < clusters.size(); ++k) {
+        const auto& c = clusters[k];
+        const auto& r = parts[k];
+        if (r.status != "ok" || r.n_platforms != c.platforms.size() || r.n_targets != c.targets.size() ||
+            r.assignment.size() != r.n_platforms * r.n_targets) {
+            return false;
+        }
+        for (size_t i = 0; i < c.platforms.size(); ++i) {
+            for (size_t j = 0; j < c.targets.size(); ++j) {
+                const uint8_t v = r.assignment[wta::types::idx_row_major(i, j, r.n_targets)];
+                out.assignment[wta::types::idx_row_major(c.platforms[i], c.targets[j], nt)] = v;
+            }
+        }
+        // 后续交战使用实体 ID，与簇内下标无关，直接合并
+        out.follow_ons.insert(out.follow_ons.end(), r.follow_ons.begin(), r.follow_ons.end());
+        out.best_fitness += r.best_fitness;
+        out.ttl_sec = std::min(out.ttl_sec, r.ttl_sec);
+        out.stats.computation_time = std::max(out.stats.computation_time, r.stats.computation_time);
+        out.stats.iterations = std::max(out.stats.iterations, r.stats.iterations);
+        out.stats.is_valid = out.stats.is_valid && r.stats.is_valid;
+        out.stats.coverage_rate += r.stats.coverage_rate * static_cast<double>(c.targets.size());
+    }
+    if (nt > 0) out.stats.coverage_rate /= static_cast<double>(nt);
+    return true;
+}
+
+} // namespace wta::orch
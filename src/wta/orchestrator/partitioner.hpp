@@ -0,0 +1,49 @@
+#pragma once
+#include <vector>
+#include "../core/solver_messages.hpp"
+
+namespace wta::orch {
+
+/**
+ * @brief 一个独立子问题：平台/目标在整体请求中的下标
+ */
+struct Cluster {
+    std::vector<size_t> platforms;
+    std::vector<size_t> targets;
+
+    size_t size() const { return platforms.size() * targets.size(); }
+};
+
+struct PartitionOptions {
+    bool enabled{true};
+    size_t max_parallel{4};         // 同时在途的子请求上限，多余的簇按规模装箱合并
+    size_t min_split_pairs{64};     // 平台×目标少于该值时不拆分
+};
+
+/**
+ * @brief 按“射程内”关系把平台与目标划分为互不相关的簇
+ *
+ * 平台与其 max_range 内的目标相连，目标与其前置目标相连，取连通分量。
+ * 只含平台或只含目标的分量没有可行分配，不出现在结果中。
+ * 距离约束关闭时所有平台都可能打击任意目标，返回单个簇。
+ */
+std::vector<Cluster> partition_world(const wta::proto::PlanRequest& req);
+
+/**
+ * @brief 把簇装箱为至多 max_groups 组（按平台×目标规模贪心均衡），合并独立簇不影响最优解
+ */
+std::vector<Cluster> pack_clusters(std::vector<Cluster> clusters, size_t max_groups);
+
+// 取出簇对应的子请求（配置、原因与快照版本沿用整体请求）
+wta::proto::PlanRequest make_cluster_request(const wta::proto::PlanRequest& whole, const Cluster& cluster);
+
+/**
+ * @brief 把各簇的响应拼回整体请求的行主序分配矩阵
+ *
+ * 任一子响应失败或尺寸不符时返回 false。适应度求和，TTL 取最小，
+ * 计算时间取最大（并行求解），覆盖率按目标数加权，后续交战队列直接合并。
+ */
+bool stitch_plans(const wta::proto::PlanRequest& whole, const std::vector<Cluster>& clusters,
+                  const std::vector<wta::proto::PlanResponse>& parts, wta::proto::PlanResponse& out);
+
+} // namespace wta::orch
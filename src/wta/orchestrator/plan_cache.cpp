@@ -0,0 +1,122 @@
+#include "plan_cache.hpp"
+#include <cmath>
+#include <cstring>
+
+namespace wta::orch {
+
+namespace {
+
+// FNV-1a 64：跨进程/跨运行稳定，不依赖 std::hash 的实现
+class Hasher {
+public:
+    template <typename T>
+    void add(const T& v) {
+        unsigned char bytes[sizeof(T)];
+        std::memcpy(bytes, &v, sizeof(T));
+        for (unsigned char b : bytes) {
+            h_ ^= b;
+            h_ *= 1099511628211ull;
+        }
+    }
+
+    void add_cell(float v, float grid) { add(static_cast<int64_t>(std::floor(v / grid))); }
+
+    uint64_t value() const { return h_; }
+
+private:
+    uint64_t h_{14695981039346656037ull};
+};
+
+} // namespace
+
+uint64_t hash_plan_inputs(const wta::proto::PlanRequest& req, float grid) {
+    Hasher h;
+    const float g = grid > 0.f ? grid : 1.f;
+
+    h.add(req.platforms.size());
+    for (const auto& p : req.platforms) {
+        h.add(p.id);
+        h.add(p.alive);
+        h.add(static_cast<uint8_t>(p.role));
+        h.add_cell(p.pos.x, g);
+        h.add_cell(p.pos.y, g);
+        h.add_cell(p.max_range, g);
+        h.add(p.max_targets);
+        h.add(p.quantity);
+        h.add(p.ammo.missile);
+        h.add(p.ammo.bomb);
+        h.add(p.ammo.rocket);
+        for (const auto& mag : p.magazines) h.add(mag.ammo_count);
+    }
+
+    h.add(req.targets.size());
+    for (const auto& t : req.targets) {
+        h.add(t.id);
+        h.add(t.alive);
+        h.add(static_cast<uint8_t>(t.kind));
+        h.add_cell(t.pos.x, g);
+        h.add_cell(t.pos.y, g);
+        h.add(t.value);
+        h.add(t.tier);
+        for (int id : t.prerequisite_targets) h.add(id);
+    }
+
+    // 粒子数/迭代数由规划线程上的调参器按规模与耗时模型事后改写，键在此之前计算，故不参与
+    const auto& b = req.config.bpso;
+    h.add(b.w_max);
+    h.add(b.w_min);
+    h.add(b.c1);
+    h.add(b.c2);
+    h.add(b.v_max);
+    h.add(b.use_gpu);
+    h.add(b.seed.value_or(-1));
+    h.add(req.max_follow_ons);
+    const auto& m = req.config.model;
+    h.add(m.enable_tier_constraint);
+    h.add(m.enable_coverage_constraint);
+    h.add(m.enable_distance_constraint);
+    h.add(m.weights.value);
+    h.add(m.weights.cost);
+    return h.value();
+}
+
+const wta::proto::PlanResponse* PlanCache::find(uint64_t key, double now) {
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+        ++misses_;
+        return nullptr;
+    }
+    if (now - it->second->solved_at > opts_.max_age_sec) {
+        lru_.erase(it->second);
+        index_.erase(it);
+        ++misses_;
+        return nullptr;
+    }
+    lru_.splice(lru_.begin(), lru_, it->second);
+    ++hits_;
+    return &it->second->resp;
+}
+
+void PlanCache::insert(uint64_t key, const wta::proto::PlanResponse& resp, double now) {
+    if (opts_.capacity == 0) return;
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        it->second->resp = resp;
+        it->second->solved_at = now;
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return;
+    }
+    lru_.push_front(Entry{key, resp, now});
+    index_[key] = lru_.begin();
+    while (index_.size() > opts_.capacity) {
+        index_.erase(lru_.back().key);
+        lru_.pop_back();
+    }
+}
+
+void PlanCache::clear() {
+    lru_.clear();
+    index_.clear();
+}
+
+} // namespace wta::orch
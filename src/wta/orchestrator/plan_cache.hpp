@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include "../core/solver_messages.hpp"
+
+namespace wta::orch {
+
+/**
+ * @brief 规划输入的稳定哈希（量化后）
+ *
+ * 参与哈希：平台/目标的顺序与 ID、存活状态、按 grid 米取整的位置、平台弹药（含弹夹余量）、
+ * 射程、目标价值/层级/前置关系，以及求解配置与后续交战数。油量、损伤等不影响分配的字段不参与；
+ * BPSO 的粒子数/迭代数属于求解预算，由调参器在哈希之后按规模决定，也不参与。
+ * 分配矩阵按请求中的顺序索引，因此顺序不同视为不同输入。
+ */
+uint64_t hash_plan_inputs(const wta::proto::PlanRequest& req, float grid);
+
+struct PlanCacheOptions {
+    size_t capacity{8};       // 保留最近的若干个输入/方案，应对来回切换的局面
+    float grid{50.f};         // 位置量化网格（米）
+    double max_age_sec{60.0}; // 方案求解后超过该时间不再复用
+};
+
+/**
+ * @brief 近期方案的 LRU 缓存（键为量化输入哈希）
+ *
+ * 只在规划线程中使用，无需加锁。
+ */
+class PlanCache {
+public:
+    explicit PlanCache(PlanCacheOptions opts = {}) : opts_(opts) {}
+
+    // 命中时返回缓存的方案并移到最近使用；过期条目视为未命中并删除
+    const wta::proto::PlanResponse* find(uint64_t key, double now);
+    // 插入或覆盖（覆盖时重置求解时间），超出容量时淘汰最久未用的条目
+    void insert(uint64_t key, const wta::proto::PlanResponse& resp, double now);
+    void clear();
+
+    size_t size() const { return index_.size(); }
+    uint64_t hits() const { return hits_; }
+    uint64_t misses() const { return misses_; }
+    double hit_rate() const {
+        const uint64_t n = hits_ + misses_;
+        return n ? static_cast<double>(hits_) / static_cast<double>(n) : 0.0;
+    }
+    const PlanCacheOptions& options() const { return opts_; }
+
+private:
+    struct Entry {
+        uint64_t key;
+        wta::proto::PlanResponse resp;
+        double solved_at;
+    };
+
+    PlanCacheOptions opts_;
+    std::list<Entry> lru_;   // 前端为最近使用
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> index_;
+    uint64_t hits_{0};
+    uint64_t misses_{0};
+};
+
+} // namespace wta::orch
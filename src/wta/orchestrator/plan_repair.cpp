@@ -0,0 +1,171 @@
+#include "plan_repair.hpp"
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+namespace wta::orch {
+
+namespace {
+
+// 距离下限（米）：避免贴近目标的平台得分发散
+constexpr float kMinDistance = 100.f;
+
+bool holds(const std::vector<size_t>& targets, size_t j) {
+    return std::find(targets.begin(), targets.end(), j) != targets.end();
+}
+
+float distance(const wta::types::Vec2& a, const wta::types::Vec2& b) {
+    const float dx = a.x - b.x;
+    const float dy = a.y - b.y;
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+} // namespace
+
+void PlanRepair::clear() {
+    plats_.clear();
+    tgts_.clear();
+}
+
+void PlanRepair::reset(const wta::proto::PlanResponse& plan, const wta::world::WorldSnapshot& world) {
+    clear();
+    const size_t np = plan.n_platforms;
+    const size_t nt = plan.n_targets;
+    if (np == 0 || nt == 0 || plan.assignment.size() < np * nt) return;
+
+    std::unordered_map<wta::types::PlatformId, const wta::types::PlatformState*> plat_by_id;
+    for (const auto& p : world.platforms) plat_by_id.emplace(p.id, &p);
+    std::unordered_map<wta::types::TargetId, const wta::types::TargetState*> tgt_by_id;
+    for (const auto& t : world.targets) tgt_by_id.emplace(t.id, &t);
+
+    tgts_.resize(nt);
+    for (size_t j = 0; j < nt; ++j) {
+        const auto it = tgt_by_id.find(static_cast<wta::types::TargetId>(j + 1));
+        if (it == tgt_by_id.end()) continue;
+        const auto& s = *it->second;
+        auto& t = tgts_[j];
+        t.alive = s.alive;
+        t.pos = s.pos;
+        t.value = s.value;
+        t.kind = static_cast<int>(s.kind);
+        for (const auto* ids : {&s.prerequisite_targets, &s.prerequisites}) {
+            for (int id : *ids) {
+                if (id >= 1 && static_cast<size_t>(id) <= nt) t.prereq.push_back(static_cast<size_t>(id - 1));
+            }
+        }
+    }
+
+    plats_.resize(np);
+    for (size_t i = 0; i < np; ++i) {
+        const auto it = plat_by_id.find(static_cast<wta::types::PlatformId>(i + 1));
+        if (it == plat_by_id.end()) continue;
+        const auto& s = *it->second;
+        auto& p = plats_[i];
+        p.alive = s.alive;
+        p.pos = s.pos;
+        p.hit_prob = std::min(std::max(s.hit_prob, 0.f), 1.f);
+        p.max_range = s.max_range;
+        p.max_targets = std::max(s.max_targets, 1);
+        p.kinds = s.target_types;
+    }
+    for (const auto& queue : plan.follow_ons) {
+        if (queue.platform_id >= 1 && static_cast<size_t>(queue.platform_id) <= np && !queue.steps.empty()) {
+            plats_[static_cast<size_t>(queue.platform_id - 1)].queued = true;
+        }
+    }
+
+    for (size_t i = 0; i < np; ++i) {
+        auto& p = plats_[i];
+        for (size_t j = 0; j < nt; ++j) {
+            if (plan.assignment[wta::types::idx_row_major(i, j, nt)] == 0) continue;
+            p.targets.push_back(j);
+            if (p.alive) tgts_[j].survive *= 1.0 - p.hit_prob;
+        }
+    }
+}
+
+void PlanRepair::on_platform_killed(wta::types::PlatformId pid) {
+    if (pid < 1 || static_cast<size_t>(pid) > plats_.size()) return;
+    auto& p = plats_[static_cast<size_t>(pid - 1)];
+    if (!p.alive) return;
+    p.alive = false;
+    // 该平台不再贡献毁伤：重算其目标的未摧毁概率
+    for (size_t j : p.targets) {
+        double survive = 1.0;
+        for (const auto& other : plats_) {
+            if (other.alive && holds(other.targets, j)) survive *= 1.0 - other.hit_prob;
+        }
+        tgts_[j].survive = survive;
+    }
+}
+
+bool PlanRepair::eligible(const Plat& p, size_t j) const {
+    const auto& t = tgts_[j];
+    if (!t.alive) return false;
+    if (!p.kinds.empty() && p.kinds.count(t.kind) == 0) return false;
+    if (p.max_range > 0.f && distance(p.pos, t.pos) > p.max_range) return false;
+    if (!holds(p.targets, j) && static_cast<int>(p.targets.size()) >= p.max_targets) return false;
+    for (size_t q : t.prereq) {
+        if (tgts_[q].alive) return false;
+    }
+    return true;
+}
+
+double PlanRepair::score(const Plat& p, size_t j) const {
+    const auto& t = tgts_[j];
+    double survive = t.survive;
+    // 已在本平台分配中的目标：不计自身的贡献
+    if (holds(p.targets, j) && p.hit_prob < 1.f) survive /= 1.0 - p.hit_prob;
+    return static_cast<double>(t.value) * p.hit_prob * survive / std::max(distance(p.pos, t.pos), kMinDistance);
+}
+
+std::vector<RepairMove> PlanRepair::on_target_killed(wta::types::TargetId tid) {
+    std::vector<RepairMove> moves;
+    if (tid < 1 || static_cast<size_t>(tid) > tgts_.size()) return moves;
+    const size_t killed = static_cast<size_t>(tid - 1);
+    if (!tgts_[killed].alive) return moves;
+    tgts_[killed].alive = false;
+
+    // 只有正在执行该目标（首个目标）的平台会空出
+    std::vector<size_t> freed;
+    for (size_t i = 0; i < plats_.size(); ++i) {
+        auto& p = plats_[i];
+        const auto it = std::find(p.targets.begin(), p.targets.end(), killed);
+        if (it == p.targets.end()) continue;
+        const bool was_current = it == p.targets.begin();
+        p.targets.erase(it);
+        if (was_current && p.alive && !p.queued) freed.push_back(i);
+    }
+    // 命中率高的平台先挑
+    std::sort(freed.begin(), freed.end(),
+              [&](size_t a, size_t b) { return plats_[a].hit_prob > plats_[b].hit_prob; });
+
+    for (size_t i : freed) {
+        auto& p = plats_[i];
+        size_t best = tgts_.size();
+        double best_score = 0.0;
+        for (size_t j = 0; j < tgts_.size(); ++j) {
+            if (!eligible(p, j)) continue;
+            const double s = score(p, j);
+            if (s > best_score) {
+                best_score = s;
+                best = j;
+            }
+        }
+        if (best == tgts_.size()) continue;
+
+        // 执行器只执行每个平台的首个目标：选中的目标放到首位
+        const auto it = std::find(p.targets.begin(), p.targets.end(), best);
+        if (it != p.targets.end()) {
+            p.targets.erase(it);
+        } else {
+            tgts_[best].survive *= 1.0 - p.hit_prob;
+        }
+        p.targets.insert(p.targets.begin(), best);
+        moves.push_back({static_cast<wta::types::PlatformId>(i + 1), static_cast<wta::types::TargetId>(best + 1),
+                         best_score});
+    }
+    return moves;
+}
+
+} // namespace wta::orch
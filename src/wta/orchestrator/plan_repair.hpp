@@ -0,0 +1,67 @@
+#pragma once
+#include <vector>
+#include "../core/solver_messages.hpp"
+#include "../world/snapshot_service.hpp"
+
+namespace wta::orch {
+
+/**
+ * @brief 一次本地修复的改派
+ */
+struct RepairMove {
+    wta::types::PlatformId platform{0};
+    wta::types::TargetId target{0};
+    double score{0.0};
+};
+
+/**
+ * @brief 目标被毁时的本地方案修复
+ *
+ * 目标被毁后，分配给它的平台在下一次完整求解（节流窗口 + 求解往返）之前一直空闲。
+ * 本类在方案应用时按方案与快照建立打分模型，击毁时只为空出的平台挑选收益最高的剩余目标：
+ *   收益 = 价值 × 命中率 × 该目标当前未被已分配平台摧毁的概率 / 距离
+ * 遵守射程、可打击类型、max_targets 与前置目标约束（前置目标全部被毁后才可分配）。
+ * 有后续交战队列的平台由执行器本地推进，不参与修复。下一次完整求解会纠正修复带来的偏差。
+ *
+ * 分配矩阵按行主序 n_platforms x n_targets 解释，ID = 下标 + 1（与执行器一致）。
+ * 只在执行线程中使用，无需加锁。
+ */
+class PlanRepair {
+public:
+    // 以刚应用的方案与当前快照重建模型
+    void reset(const wta::proto::PlanResponse& plan, const wta::world::WorldSnapshot& world);
+    void clear();
+    bool empty() const { return plats_.empty(); }
+
+    void on_platform_killed(wta::types::PlatformId pid);
+    // 目标被毁：返回空出平台的改派（无可行目标的平台不出现在结果中），并更新模型
+    std::vector<RepairMove> on_target_killed(wta::types::TargetId tid);
+
+private:
+    struct Plat {
+        bool alive{false};
+        bool queued{false};          // 有后续交战队列
+        wta::types::Vec2 pos{};
+        float hit_prob{0.f};
+        float max_range{0.f};        // <=0 表示不限
+        int max_targets{1};
+        std::unordered_set<int> kinds;   // 可打击的目标类型，空表示不限
+        std::vector<size_t> targets;     // 当前分配的目标下标，首个为执行器正在执行的目标
+    };
+    struct Tgt {
+        bool alive{false};
+        wta::types::Vec2 pos{};
+        float value{0.f};
+        int kind{0};
+        double survive{1.0};         // 已分配平台全部未命中的概率
+        std::vector<size_t> prereq;  // 前置目标下标
+    };
+
+    bool eligible(const Plat& p, size_t j) const;
+    double score(const Plat& p, size_t j) const;
+
+    std::vector<Plat> plats_;
+    std::vector<Tgt> tgts_;
+};
+
+} // namespace wta::orch
@@ -0,0 +1,73 @@
+#include "plan_validation.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace wta::orch {
+
+namespace {
+
+template <class State, class Id>
+bool gone_in(const std::vector<State>& states, Id id) {
+    for (const auto& s : states) {
+        if (s.id == id) return !s.alive;
+    }
+    return true;
+}
+
+} // namespace
+
+PlanValidation validate_plan(wta::proto::PlanResponse& resp,
+                             const wta::world::WorldSnapshot& planned_on,
+                             const wta::world::WorldSnapshot& current,
+                             const std::unordered_set<wta::types::PlatformId>& killed_platforms,
+                             const std::unordered_set<wta::types::TargetId>& killed_targets,
+                             double max_drop_ratio) {
+    PlanValidation v;
+    const size_t n_plat = resp.n_platforms;
+    const size_t n_tgt = resp.n_targets;
+    const bool world_moved = current.version > planned_on.version;
+    auto plat_gone = [&](wta::types::PlatformId pid) {
+        return killed_platforms.count(pid) > 0 || (world_moved && gone_in(current.platforms, pid));
+    };
+    auto tgt_gone = [&](wta::types::TargetId tid) {
+        return killed_targets.count(tid) > 0 || (world_moved && gone_in(current.targets, tid));
+    };
+
+    std::vector<size_t> drop;
+    for (size_t i = 0; i < n_plat; ++i) {
+        const auto pid = static_cast<wta::types::PlatformId>(i + 1);
+        const bool platform_gone = plat_gone(pid);
+        for (size_t j = 0; j < n_tgt; ++j) {
+            const size_t idx = i * n_tgt + j;
+            if (idx >= resp.assignment.size() || resp.assignment[idx] == 0) continue;
+            ++v.assigned;
+            const auto tid = static_cast<wta::types::TargetId>(j + 1);
+            if (platform_gone || tgt_gone(tid)) drop.push_back(idx);
+        }
+    }
+
+    v.dropped = drop.size();
+    if (v.assigned > 0 && static_cast<double>(v.dropped) > max_drop_ratio * static_cast<double>(v.assigned)) {
+        v.rejected = true;
+        return v;
+    }
+    for (size_t idx : drop) resp.assignment[idx] = 0;
+
+    for (auto it = resp.follow_ons.begin(); it != resp.follow_ons.end();) {
+        if (plat_gone(it->platform_id)) {
+            v.follow_ons_dropped += it->steps.size();
+            it = resp.follow_ons.erase(it);
+            continue;
+        }
+        auto& steps = it->steps;
+        const size_t before = steps.size();
+        steps.erase(std::remove_if(steps.begin(), steps.end(),
+                                   [&](const auto& s) { return tgt_gone(s.target_id); }),
+                    steps.end());
+        v.follow_ons_dropped += before - steps.size();
+        it = steps.empty() ? resp.follow_ons.erase(it) : it + 1;
+    }
+    return v;
+}
+
+} // namespace wta::orch
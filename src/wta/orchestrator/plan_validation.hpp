@@ -0,0 +1,32 @@
+#pragma once
+#include <unordered_set>
+#include "../core/solver_messages.hpp"
+#include "../world/snapshot_service.hpp"
+
+namespace wta::orch {
+
+struct PlanValidation {
+    size_t assigned{0};     // 方案中的分配对数
+    size_t dropped{0};      // 因平台/目标在快照之后失效而剔除的分配对
+    bool rejected{false};   // 失效比例过高，整个方案不再下发
+    size_t follow_ons_dropped{0};   // 剔除的后续交战（不计入失效比例）
+};
+
+/**
+ * @brief 按规划所用快照校验方案，剔除快照之后已失效的平台/目标
+ *
+ * 分配矩阵按行主序 n_platforms x n_targets 解释，ID = 下标 + 1（与执行器一致）。
+ * 实体失效的判据：在 killed_* 中（快照之后收到击毁事件），或当前快照比规划快照新且
+ * 其中该实体已不存在/已死亡。被剔除的分配对直接在 resp.assignment 中清零。
+ * 后续交战队列同样剔除失效平台的整条队列与失效目标的单步；以失效目标为前置条件的步骤保留（条件已满足）。
+ *
+ * @param max_drop_ratio 剔除比例超过该值时拒绝整个方案（此时 resp 不被修改）
+ */
+PlanValidation validate_plan(wta::proto::PlanResponse& resp,
+                             const wta::world::WorldSnapshot& planned_on,
+                             const wta::world::WorldSnapshot& current,
+                             const std::unordered_set<wta::types::PlatformId>& killed_platforms,
+                             const std::unordered_set<wta::types::TargetId>& killed_targets,
+                             double max_drop_ratio = 0.5);
+
+} // namespace wta::orch
@@ -0,0 +1,89 @@
+#include "replan_trigger.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace wta::orch {
+
+double ReplanTrigger::target_importance(wta::types::TargetId id, const wta::world::WorldSnapshot* world) const {
+    if (!world) return opts_.unknown_importance;
+    const wta::types::TargetState* found = nullptr;
+    float max_value = 0.f;
+    for (const auto& t : world->targets) {
+        max_value = std::max(max_value, t.value);
+        if (t.id == id) found = &t;
+    }
+    if (!found) return opts_.unknown_importance;
+    const double rel = max_value > 0.f ? static_cast<double>(found->value / max_value) : 1.0;
+    const size_t tier = static_cast<size_t>(std::clamp(found->tier, 0, static_cast<int>(opts_.tier_weight.size()) - 1));
+    return std::max(rel, opts_.min_importance) * opts_.tier_weight[tier];
+}
+
+double ReplanTrigger::score(const wta::events::Event& ev, const wta::world::WorldSnapshot* world) const {
+    using wta::events::EventType;
+    switch (ev.type) {
+        case EventType::EntityKilled: {
+            const auto& e = std::get<wta::events::EntityKilledEvent>(ev.payload);
+            return e.is_platform ? opts_.platform_killed : opts_.target_killed * target_importance(e.entity_id, world);
+        }
+        case EventType::HandleDamage: {
+            const auto& e = std::get<wta::events::DamageEvent>(ev.payload);
+            const double dmg = std::clamp(static_cast<double>(e.damage), 0.0, 1.0);
+            return e.is_platform ? opts_.platform_damage * dmg
+                                 : opts_.target_damage * dmg * target_importance(e.entity_id, world);
+        }
+        case EventType::Fired:
+            return opts_.fired;
+        case EventType::ReplanRequest:
+            return kNever;
+        default:
+            return 0.0;
+    }
+}
+
+double ReplanTrigger::threshold_at(double now) const {
+    const double since = now - last_trigger_ts_;
+    if (opts_.hysteresis_sec <= 0.0 || since >= opts_.hysteresis_sec) return opts_.threshold;
+    return opts_.threshold * (1.0 + opts_.hysteresis * (1.0 - since / opts_.hysteresis_sec));
+}
+
+void ReplanTrigger::on_event(const wta::events::Event& ev, const wta::world::WorldSnapshot* world, double now) {
+    ++stats_.events;
+    ++pending_events_;
+    if (ev.type == wta::events::EventType::ReplanRequest) {
+        ++stats_.forced;
+        due_at_ = now;
+        return;
+    }
+    accumulated_ += score(ev, world);
+    // 首次越过阈值时开始去抖；之后的事件并入同一批，不推迟触发时刻
+    if (due_at_ == kNever && accumulated_ >= threshold_at(now)) {
+        due_at_ = now + opts_.debounce_sec;
+    }
+}
+
+void ReplanTrigger::on_solve(double now, bool by_trigger) {
+    if (by_trigger && due_at_ != kNever) {
+        ++stats_.triggered;
+        last_trigger_ts_ = now;
+        stats_.absorbed += pending_events_ > 0 ? pending_events_ - 1 : 0;
+    } else {
+        stats_.absorbed += pending_events_;
+    }
+    accumulated_ = 0.0;
+    pending_events_ = 0;
+    due_at_ = kNever;
+}
+
+bool ReplanTrigger::should_replace(const wta::proto::PlanResponse& current,
+                                   const wta::proto::PlanResponse& candidate) {
+    if (opts_.min_improvement <= 0.0 || current.n_platforms != candidate.n_platforms ||
+        current.n_targets != candidate.n_targets) {
+        return true;
+    }
+    const double scale = std::max(std::abs(current.best_fitness), 1e-9);
+    if (candidate.best_fitness - current.best_fitness >= opts_.min_improvement * scale) return true;
+    ++stats_.kept;
+    return false;
+}
+
+} // namespace wta::orch
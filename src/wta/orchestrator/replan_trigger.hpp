@@ -0,0 +1,93 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <limits>
+#include "../core/solver_messages.hpp"
+#include "../world/event_bus.hpp"
+#include "../world/snapshot_service.hpp"
+
+namespace wta::orch {
+
+/**
+ * @brief 重规划触发策略参数
+ *
+ * 每个事件按类型打分，目标相关事件再乘以目标重要度（相对价值 × 层级权重）。
+ * 累计分数达到阈值后再等待一个去抖窗口，把同一波交战的事件合并为一次求解。
+ */
+struct ReplanTriggerOptions {
+    double threshold{1.0};              // 累计分数达到该值才触发求解
+    double platform_killed{1.0};        // 平台损失：单独即可触发
+    double platform_damage{1.5};        // 平台受伤：乘以伤害值
+    double target_killed{1.0};          // 目标被毁：乘以目标重要度
+    double target_damage{0.4};          // 目标受伤：乘以伤害值与目标重要度
+    double fired{0.05};                 // 开火（弹药变化）
+    double unknown_importance{0.2};     // 快照中找不到的目标（如未登记的步兵）
+    double min_importance{0.05};        // 相对价值下限，避免零价值目标完全不计分
+    std::array<double, 3> tier_weight{1.5, 1.2, 1.0};   // 层级 0/1/2：低层级是后续目标的前置，影响更大
+    double debounce_sec{0.1};           // 越过阈值后等待合并的窗口
+    double hysteresis{0.5};             // 事件触发求解后阈值上浮比例
+    double hysteresis_sec{2.0};         // 上浮的阈值在该时间内线性回落
+    double min_improvement{0.02};       // 同一规模下新方案适应度的最小相对提升，不足时保留当前方案（避免任务抖动）
+};
+
+/**
+ * @brief 重规划触发统计
+ */
+struct ReplanTriggerStats {
+    uint64_t events{0};         // 参与打分的事件数
+    uint64_t triggered{0};      // 事件触发的求解次数
+    uint64_t absorbed{0};       // 未单独触发求解的事件（并入去抖批次或留给 TTL 求解）
+    uint64_t forced{0};         // ReplanRequest 强制触发次数
+    uint64_t kept{0};           // 提升不足、保留当前方案的求解结果数
+};
+
+/**
+ * @brief 基于事件打分的重规划触发器
+ *
+ * 代替“任意击毁/伤害/开火事件都立即重规划”：低价值步兵受伤只积累少量分数，
+ * 平台损失或高价值目标被毁则很快越过阈值。ReplanRequest 不受阈值与去抖约束。
+ * 每次发出非推测求解（不论原因）都清空累计分数，事件触发的求解之后阈值临时上浮（滞回）。
+ * 求解结果相对当前方案的适应度提升不足 min_improvement 时不替换当前方案（最小改进滞回）。
+ * 只在规划线程中使用，无需加锁。
+ */
+class ReplanTrigger {
+public:
+    explicit ReplanTrigger(ReplanTriggerOptions opts = {}) : opts_(opts) {}
+
+    // 单个事件的分数；world 为空时目标按 unknown_importance 计
+    double score(const wta::events::Event& ev, const wta::world::WorldSnapshot* world) const;
+
+    void on_event(const wta::events::Event& ev, const wta::world::WorldSnapshot* world, double now);
+    // 是否应立即发出求解
+    bool due(double now) const { return now >= due_at_; }
+    // 预计触发时刻；无待触发时为 +inf
+    double due_at() const { return due_at_; }
+    // 发出非推测求解时调用；by_trigger 表示由本触发器导致（启用滞回）
+    void on_solve(double now, bool by_trigger);
+    /**
+     * @brief 新方案是否值得替换当前方案
+     *
+     * 规模（平台数/目标数）变化说明世界已变化，总是替换；否则要求适应度（越大越好）的相对提升
+     * 不小于 min_improvement。不替换时计入 stats().kept。
+     */
+    bool should_replace(const wta::proto::PlanResponse& current, const wta::proto::PlanResponse& candidate);
+
+    double accumulated() const { return accumulated_; }
+    double threshold_at(double now) const;
+    const ReplanTriggerStats& stats() const { return stats_; }
+    const ReplanTriggerOptions& options() const { return opts_; }
+
+private:
+    static constexpr double kNever = std::numeric_limits<double>::infinity();
+
+    double target_importance(wta::types::TargetId id, const wta::world::WorldSnapshot* world) const;
+
+    ReplanTriggerOptions opts_;
+    ReplanTriggerStats stats_;
+    double accumulated_{0.0};
+    uint64_t pending_events_{0};    // 自上次求解以来计分的事件数
+    double due_at_{kNever};
+    double last_trigger_ts_{-kNever};
+};
+
+} // namespace wta::orch
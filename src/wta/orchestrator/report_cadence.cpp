@@ -0,0 +1,108 @@
+#include "report_cadence.hpp"
+#include <algorithm>
+#include <unordered_map>
+
+namespace wta::orch {
+
+namespace {
+
+int total_ammo(const wta::types::PlatformState& p) {
+    int n = p.ammo.missile + p.ammo.bomb + p.ammo.rocket;
+    for (const auto& mag : p.magazines) n += mag.ammo_count;
+    return n;
+}
+
+bool moved(const wta::types::Vec2& a, const wta::types::Vec2& b, float eps) {
+    const float dx = a.x - b.x;
+    const float dy = a.y - b.y;
+    return dx * dx + dy * dy > eps * eps;
+}
+
+} // namespace
+
+WorldDelta diff_worlds(const wta::world::WorldSnapshot& prev, const wta::world::WorldSnapshot& cur,
+                       float move_epsilon) {
+    WorldDelta d;
+
+    std::unordered_map<wta::types::PlatformId, const wta::types::PlatformState*> prev_plat;
+    prev_plat.reserve(prev.platforms.size());
+    for (const auto& p : prev.platforms) prev_plat.emplace(p.id, &p);
+    size_t matched = 0;
+    for (const auto& p : cur.platforms) {
+        auto it = prev_plat.find(p.id);
+        if (it == prev_plat.end()) continue;
+        ++matched;
+        const auto& old = *it->second;
+        if (old.alive && !p.alive) {
+            ++d.died;
+            continue;
+        }
+        if (moved(old.pos, p.pos, move_epsilon)) ++d.moved;
+        if (total_ammo(old) != total_ammo(p)) ++d.ammo_changed;
+    }
+    d.died += static_cast<int>(prev.platforms.size() - matched);
+
+    std::unordered_map<wta::types::TargetId, const wta::types::TargetState*> prev_tgt;
+    prev_tgt.reserve(prev.targets.size());
+    for (const auto& t : prev.targets) prev_tgt.emplace(t.id, &t);
+    matched = 0;
+    for (const auto& t : cur.targets) {
+        auto it = prev_tgt.find(t.id);
+        if (it == prev_tgt.end()) continue;
+        ++matched;
+        const auto& old = *it->second;
+        if (old.alive && !t.alive) {
+            ++d.died;
+            continue;
+        }
+        if (moved(old.pos, t.pos, move_epsilon)) ++d.moved;
+    }
+    d.died += static_cast<int>(prev.targets.size() - matched);
+    return d;
+}
+
+const char* to_string(CadenceReason reason) {
+    switch (reason) {
+        case CadenceReason::Startup:      return "startup";
+        case CadenceReason::Combat:       return "combat";
+        case CadenceReason::Changing:     return "changing";
+        case CadenceReason::Quiet:        return "quiet";
+        case CadenceReason::Backpressure: return "backpressure";
+    }
+    return "unknown";
+}
+
+ReportCadence::ReportCadence(ReportCadenceOptions opts)
+: opts_(opts), interval_(std::chrono::milliseconds(1000)) {
+    interval_ = clamp(interval_);
+}
+
+std::chrono::milliseconds ReportCadence::clamp(std::chrono::milliseconds v) const {
+    return std::min(std::max(v, opts_.min_interval), opts_.max_interval);
+}
+
+std::chrono::milliseconds ReportCadence::on_report(const WorldDelta& delta, bool sent_ok,
+                                                   std::chrono::microseconds send_time) {
+    if (!sent_ok || send_time > opts_.slow_send) {
+        interval_ = clamp(interval_ * 2);
+        reason_ = CadenceReason::Backpressure;
+    } else if (delta.died > 0 || delta.total() >= opts_.combat_changes) {
+        interval_ = opts_.min_interval;
+        reason_ = CadenceReason::Combat;
+    } else if (delta.total() > 0) {
+        interval_ = clamp(interval_ / 2);
+        reason_ = CadenceReason::Changing;
+    } else {
+        interval_ = clamp(interval_ * 3 / 2);
+        reason_ = CadenceReason::Quiet;
+    }
+    return interval_;
+}
+
+std::chrono::milliseconds ReportCadence::on_engagement_event() {
+    interval_ = opts_.min_interval;
+    reason_ = CadenceReason::Combat;
+    return interval_;
+}
+
+} // namespace wta::orch
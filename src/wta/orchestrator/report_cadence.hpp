@@ -0,0 +1,67 @@
+#pragma once
+#include <chrono>
+#include "../world/snapshot_service.hpp"
+
+namespace wta::orch {
+
+/**
+ * @brief 两次上报之间的世界变化（廉价统计，不做深比较）
+ */
+struct WorldDelta {
+    int moved{0};          // 位移超过 epsilon 的实体
+    int died{0};           // 由存活变为死亡或从快照中消失的实体
+    int ammo_changed{0};   // 弹药数变化的平台
+
+    int total() const { return moved + died + ammo_changed; }
+};
+
+WorldDelta diff_worlds(const wta::world::WorldSnapshot& prev, const wta::world::WorldSnapshot& cur,
+                       float move_epsilon);
+
+struct ReportCadenceOptions {
+    std::chrono::milliseconds min_interval{200};    // 交战时最快 5 Hz
+    std::chrono::milliseconds max_interval{5000};   // 静默时最慢 0.2 Hz
+    float move_epsilon{5.f};                         // 位移阈值（米）
+    int combat_changes{3};                           // 变化实体数达到该值视为交战
+    std::chrono::milliseconds slow_send{200};        // 单次上报超过该耗时视为消费端拥塞
+};
+
+enum class CadenceReason : uint8_t {
+    Startup,        // 尚未有上报反馈
+    Combat,         // 有击毁或大量实体变化：最快
+    Changing,       // 少量变化：逐步加快
+    Quiet,          // 无变化：逐步放慢
+    Backpressure    // 发送失败或过慢：放慢，优先保证消费端
+};
+
+const char* to_string(CadenceReason reason);
+
+/**
+ * @brief 自适应状态上报节拍
+ *
+ * 每次上报后根据世界变化与发送反馈给出下一次间隔，在 [min_interval, max_interval] 内调整：
+ * 交战时直接跳到最快，静默时每次放慢 1.5 倍，发送失败/过慢时加倍退避。
+ * 只在上报线程中使用，无需加锁。
+ */
+class ReportCadence {
+public:
+    explicit ReportCadence(ReportCadenceOptions opts = {});
+
+    // 上报完成后调用，返回下一次上报间隔
+    std::chrono::milliseconds on_report(const WorldDelta& delta, bool sent_ok, std::chrono::microseconds send_time);
+    // 收到击毁/伤害/开火事件：立即切到最快节拍，返回新间隔
+    std::chrono::milliseconds on_engagement_event();
+
+    std::chrono::milliseconds interval() const { return interval_; }
+    CadenceReason reason() const { return reason_; }
+    const ReportCadenceOptions& options() const { return opts_; }
+
+private:
+    std::chrono::milliseconds clamp(std::chrono::milliseconds v) const;
+
+    ReportCadenceOptions opts_;
+    std::chrono::milliseconds interval_;
+    CadenceReason reason_{CadenceReason::Startup};
+};
+
+} // namespace wta::orch
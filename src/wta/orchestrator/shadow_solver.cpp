@@ -0,0 +1,169 @@
+#include "shadow_solver.hpp"
+#include <iomanip>
+#include <sstream>
+
+namespace wta::orch {
+
+namespace {
+
+// 每个平台取第一个被分配的目标（与执行器一致），无分配为 0
+std::vector<int> first_targets(const wta::proto::PlanResponse& r) {
+    std::vector<int> out(r.n_platforms, 0);
+    for (size_t i = 0; i < r.n_platforms; ++i) {
+        for (size_t j = 0; j < r.n_targets; ++j) {
+            const size_t idx = wta::types::idx_row_major(i, j, r.n_targets);
+            if (idx < r.assignment.size() && r.assignment[idx] > 0) {
+                out[i] = static_cast<int>(j + 1);
+                break;
+            }
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+double assignment_agreement(const wta::proto::PlanResponse& a, const wta::proto::PlanResponse& b) {
+    if (a.n_platforms != b.n_platforms || a.n_targets != b.n_targets) return 0.0;
+    const auto ta = first_targets(a);
+    const auto tb = first_targets(b);
+    size_t considered = 0;
+    size_t same = 0;
+    for (size_t i = 0; i < ta.size(); ++i) {
+        if (ta[i] == 0 && tb[i] == 0) continue;
+        ++considered;
+        if (ta[i] == tb[i]) ++same;
+    }
+    return considered ? static_cast<double>(same) / static_cast<double>(considered) : 1.0;
+}
+
+ShadowSolver::ShadowSolver(wta::net::ISolverClient& client, Observer observer)
+: client_(client), observer_(std::move(observer)) {}
+
+void ShadowSolver::start() {
+    std::lock_guard<std::mutex> lk(m_);
+    if (running_) return;
+    running_ = true;
+    th_ = std::thread(&ShadowSolver::loop, this);
+}
+
+void ShadowSolver::stop() {
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        if (!running_) return;
+        running_ = false;
+    }
+    cv_.notify_all();
+    // 在途的影子请求最多等到其超时
+    if (th_.joinable()) th_.join();
+}
+
+uint64_t ShadowSolver::submit(wta::proto::PlanRequest req, std::chrono::milliseconds timeout) {
+    uint64_t id = 0;
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        if (!running_) return 0;
+        if (inflight_ != 0) {
+            skipped_.fetch_add(1, std::memory_order_relaxed);
+            return 0;
+        }
+        id = inflight_ = ++next_id_;
+        pending_ = std::move(req);
+        timeout_ = timeout;
+        primary_ = Side{};
+        shadow_ = Side{};
+    }
+    cv_.notify_one();
+    return id;
+}
+
+void ShadowSolver::primary_done(uint64_t id, bool ok, const wta::proto::PlanResponse& resp, double sec) {
+    std::unique_lock<std::mutex> lk(m_);
+    if (id == 0 || id != inflight_) return;
+    primary_.done = true;
+    primary_.ok = ok;
+    primary_.sec = sec;
+    primary_.resp = resp;
+    if (!shadow_.done) return;
+    const auto cmp = finish_locked();
+    lk.unlock();
+    if (observer_) observer_(cmp);
+}
+
+void ShadowSolver::loop() {
+    std::unique_lock<std::mutex> lk(m_);
+    while (true) {
+        cv_.wait(lk, [&] { return pending_.has_value() || !running_; });
+        if (!running_) break;
+        const auto req = std::move(*pending_);
+        pending_.reset();
+        const auto timeout = timeout_;
+        lk.unlock();
+
+        Side side;
+        const auto t0 = std::chrono::steady_clock::now();
+        side.ok = client_.request_plan(req, side.resp, timeout);
+        side.sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        side.done = true;
+
+        lk.lock();
+        shadow_ = std::move(side);
+        if (!primary_.done) continue;
+        const auto cmp = finish_locked();
+        lk.unlock();
+        if (observer_) observer_(cmp);
+        lk.lock();
+    }
+}
+
+ShadowComparison ShadowSolver::finish_locked() {
+    ShadowComparison cmp;
+    cmp.id = inflight_;
+    cmp.primary_ok = primary_.ok && primary_.resp.status == "ok";
+    cmp.shadow_ok = shadow_.ok && shadow_.resp.status == "ok";
+    cmp.primary_sec = primary_.sec;
+    cmp.shadow_sec = shadow_.sec;
+    cmp.primary_fitness = primary_.resp.best_fitness;
+    cmp.shadow_fitness = shadow_.resp.best_fitness;
+
+    if (cmp.primary_ok) primary_latency_.record_sec(cmp.primary_sec);
+    if (cmp.shadow_ok) {
+        shadow_latency_.record_sec(cmp.shadow_sec);
+    } else {
+        shadow_failed_.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (cmp.primary_ok && cmp.shadow_ok) {
+        cmp.agreement = assignment_agreement(primary_.resp, shadow_.resp);
+        ++both_ok_;
+        agreement_sum_ += cmp.agreement;
+        fitness_delta_sum_ += cmp.shadow_fitness - cmp.primary_fitness;
+        if (cmp.shadow_sec < cmp.primary_sec) shadow_faster_.fetch_add(1, std::memory_order_relaxed);
+    }
+    compared_.fetch_add(1, std::memory_order_relaxed);
+
+    inflight_ = 0;
+    primary_ = Side{};
+    shadow_ = Side{};
+    return cmp;
+}
+
+double ShadowSolver::mean_agreement() const {
+    std::lock_guard<std::mutex> lk(m_);
+    return both_ok_ ? agreement_sum_ / static_cast<double>(both_ok_) : 0.0;
+}
+
+double ShadowSolver::mean_fitness_delta() const {
+    std::lock_guard<std::mutex> lk(m_);
+    return both_ok_ ? fitness_delta_sum_ / static_cast<double>(both_ok_) : 0.0;
+}
+
+std::string ShadowSolver::summary() const {
+    std::ostringstream os;
+    os << "compared=" << compared() << " skipped=" << skipped() << " shadow_failed=" << shadow_failures()
+       << " shadow_faster=" << shadow_faster() << std::fixed << std::setprecision(3)
+       << " agreement=" << mean_agreement() << " fitness_delta=" << mean_fitness_delta()
+       << " primary[" << primary_latency_.summary() << "] shadow[" << shadow_latency_.summary() << "]";
+    return os.str();
+}
+
+} // namespace wta::orch
@@ -0,0 +1,105 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include "../core/latency_histogram.hpp"
+#include "../net/solver_client.hpp"
+
+namespace wta::orch {
+
+/**
+ * @brief 两个方案分配的一致程度
+ *
+ * 按执行器的解释（每个平台取第一个被分配的目标）逐平台比较，只统计至少一方有分配的平台。
+ * 两方都没有分配时为 1；尺寸不一致时为 0。
+ */
+double assignment_agreement(const wta::proto::PlanResponse& a, const wta::proto::PlanResponse& b);
+
+/**
+ * @brief 一次主/影子求解的对比结果
+ */
+struct ShadowComparison {
+    uint64_t id{0};
+    bool primary_ok{false};
+    bool shadow_ok{false};
+    double primary_sec{0.0};
+    double shadow_sec{0.0};
+    double primary_fitness{0.0};
+    double shadow_fitness{0.0};
+    double agreement{0.0};      // 两方都成功时有效
+};
+
+/**
+ * @brief 影子求解器：同一请求并行发往候选求解器，只记录对比，结果从不应用
+ *
+ * 影子请求在独立线程中发送，主求解路径不等待影子结果；影子仍在求解时的新请求直接跳过，
+ * 慢的候选求解器不会积压请求或拖慢主路径。两方都完成后由后完成的一方生成对比记录，
+ * 计入统计并交给 observer（在通信线程或影子线程中调用）。
+ */
+class ShadowSolver {
+public:
+    using Observer = std::function<void(const ShadowComparison&)>;
+
+    explicit ShadowSolver(wta::net::ISolverClient& client, Observer observer = {});
+    ~ShadowSolver() { stop(); }
+
+    void start();
+    void stop();
+
+    // 通信线程：主求解发出前调用；影子忙时跳过并返回 0
+    uint64_t submit(wta::proto::PlanRequest req, std::chrono::milliseconds timeout);
+    // 通信线程：主求解完成后调用（id 为 submit 的返回值）
+    void primary_done(uint64_t id, bool ok, const wta::proto::PlanResponse& resp, double sec);
+
+    uint64_t compared() const { return compared_.load(std::memory_order_relaxed); }
+    uint64_t skipped() const { return skipped_.load(std::memory_order_relaxed); }
+    uint64_t shadow_failures() const { return shadow_failed_.load(std::memory_order_relaxed); }
+    uint64_t shadow_faster() const { return shadow_faster_.load(std::memory_order_relaxed); }
+    const wta::core::LatencyHistogram& primary_latency() const { return primary_latency_; }
+    const wta::core::LatencyHistogram& shadow_latency() const { return shadow_latency_; }
+    double mean_agreement() const;
+    double mean_fitness_delta() const;   // 影子 - 主，仅两方都成功的请求
+    std::string summary() const;
+
+private:
+    struct Side {
+        bool done{false};
+        bool ok{false};
+        double sec{0.0};
+        wta::proto::PlanResponse resp;
+    };
+
+    void loop();
+    ShadowComparison finish_locked();   // 两方都完成（持有 m_）：计入统计并复位为空闲
+
+    wta::net::ISolverClient& client_;
+    Observer observer_;
+    std::thread th_;
+    bool running_{false};
+
+    mutable std::mutex m_;
+    std::condition_variable cv_;
+    uint64_t next_id_{0};
+    uint64_t inflight_{0};                               // 0 表示空闲
+    std::optional<wta::proto::PlanRequest> pending_;     // 待影子线程发送
+    std::chrono::milliseconds timeout_{1000};
+    Side primary_;
+    Side shadow_;
+
+    wta::core::LatencyHistogram primary_latency_;
+    wta::core::LatencyHistogram shadow_latency_;
+    std::atomic<uint64_t> compared_{0};
+    std::atomic<uint64_t> skipped_{0};
+    std::atomic<uint64_t> shadow_failed_{0};
+    std::atomic<uint64_t> shadow_faster_{0};
+    uint64_t both_ok_{0};           // m_ 保护
+    double agreement_sum_{0.0};
+    double fitness_delta_sum_{0.0};
+};
+
+} // namespace wta::orch
@@ -0,0 +1,76 @@
+#include "solve_tuner.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace wta::orch {
+
+namespace {
+
+double work_of(size_t n_platforms, size_t n_targets, int n_particles, int n_iterations) {
+    return static_cast<double>(n_particles) * static_cast<double>(n_iterations) *
+           static_cast<double>(n_platforms) * static_cast<double>(n_targets);
+}
+
+} // namespace
+
+double SolveTuner::slope() const {
+    if (w_ <= 0.0) return opts_.prior_sec_per_unit;
+    const double var = sxx_ * w_ - sx_ * sx_;
+    // 规模差异不足以分离截距时，按过原点拟合
+    if (var <= 1e-9 * sxx_ * w_) return sxx_ > 0.0 ? std::max(sxy_ / sxx_, 0.0) : opts_.prior_sec_per_unit;
+    return std::max((sxy_ * w_ - sx_ * sy_) / var, 0.0);
+}
+
+double SolveTuner::intercept() const {
+    if (w_ <= 0.0) return 0.0;
+    const double var = sxx_ * w_ - sx_ * sx_;
+    if (var <= 1e-9 * sxx_ * w_) return 0.0;
+    return std::max((sy_ - slope() * sx_) / w_, 0.0);
+}
+
+double SolveTuner::predict(size_t n_platforms, size_t n_targets, int n_particles, int n_iterations) const {
+    return intercept() + slope() * work_of(n_platforms, n_targets, n_particles, n_iterations);
+}
+
+TuneDecision SolveTuner::tune(size_t n_platforms, size_t n_targets) const {
+    TuneDecision d;
+    const double pairs = static_cast<double>(std::max<size_t>(n_platforms * n_targets, 1));
+    const double b = slope();
+    const double budget = opts_.deadline_sec - intercept();
+    // 预算内可承受的 粒子×迭代
+    const double units = (b > 0.0 && budget > 0.0) ? budget / (b * pairs) : (b > 0.0 ? 0.0 : 1e18);
+    const double ratio = std::max(opts_.particles_per_iteration, 1e-3);
+    const double iters = std::sqrt(units / ratio);
+
+    d.n_iterations = static_cast<int>(std::clamp(iters, static_cast<double>(opts_.min_iterations),
+                                                 static_cast<double>(opts_.max_iterations)));
+    // 迭代数被截断时把剩余预算留给粒子数
+    const double particles = units / static_cast<double>(d.n_iterations);
+    d.n_particles = static_cast<int>(std::clamp(particles, static_cast<double>(opts_.min_particles),
+                                                static_cast<double>(opts_.max_particles)));
+    d.clamped = particles < opts_.min_particles || particles > opts_.max_particles;
+    d.predicted_sec = predict(n_platforms, n_targets, d.n_particles, d.n_iterations);
+    return d;
+}
+
+TuneDecision SolveTuner::apply(wta::config::BPSOConfig& bpso, size_t n_platforms, size_t n_targets) const {
+    const auto d = tune(n_platforms, n_targets);
+    bpso.n_particles = d.n_particles;
+    bpso.n_iterations = d.n_iterations;
+    return d;
+}
+
+void SolveTuner::observe(size_t n_platforms, size_t n_targets, int n_particles, int n_iterations,
+                         double computation_sec) {
+    if (computation_sec <= 0.0 || n_particles <= 0 || n_iterations <= 0) return;
+    const double x = work_of(n_platforms, n_targets, n_particles, n_iterations);
+    if (x <= 0.0) return;
+    const double f = opts_.forgetting;
+    w_ = w_ * f + 1.0;
+    sx_ = sx_ * f + x;
+    sy_ = sy_ * f + computation_sec;
+    sxx_ = sxx_ * f + x * x;
+    sxy_ = sxy_ * f + x * computation_sec;
+}
+
+} // namespace wta::orch
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>
+#include "../core/config.hpp"
+
+namespace wta::orch {
+
+struct SolveTunerOptions {
+    double deadline_sec{0.4};        // 目标求解耗时（求解器报告的 computation_time）
+    int min_particles{50};
+    int max_particles{500};          // 上限与求解器默认值一致：预算充足时不比默认更大
+    int min_iterations{15};
+    int max_iterations{50};
+    double particles_per_iteration{10.0};   // 缩放时保持粒子数/迭代数比例
+    double forgetting{0.95};         // 模型对旧样本的指数遗忘因子
+    double prior_sec_per_unit{1e-7}; // 无观测时：每个 粒子×迭代×平台×目标 的耗时
+};
+
+/**
+ * @brief 一次调参决定
+ */
+struct TuneDecision {
+    int n_particles{0};
+    int n_iterations{0};
+    double predicted_sec{0.0};   // 按当前模型预测的求解耗时
+    bool clamped{false};         // 已降到下限仍超预算（或已到上限）
+};
+
+/**
+ * @brief BPSO 规模自动调参
+ *
+ * 把求解耗时建模为 t = a + b * work，work = 粒子数 × 迭代数 × 平台数 × 目标数，
+ * 用带指数遗忘的在线最小二乘拟合 a/b；每次求解前按问题规模反解出不超过 deadline 的 work，
+ * 再按固定比例分配给粒子数与迭代数。样本不足两个不同规模时只拟合斜率（a = 0）。
+ * 只在求解通信线程中使用，无需加锁。
+ */
+class SolveTuner {
+public:
+    explicit SolveTuner(SolveTunerOptions opts = {}) : opts_(opts) {}
+
+    TuneDecision tune(size_t n_platforms, size_t n_targets) const;
+    // 把决定写入配置（其余参数保持不变）
+    TuneDecision apply(wta::config::BPSOConfig& bpso, size_t n_platforms, size_t n_targets) const;
+    // 记录一次求解的实际耗时
+    void observe(size_t n_platforms, size_t n_targets, int n_particles, int n_iterations, double computation_sec);
+
+    double predict(size_t n_platforms, size_t n_targets, int n_particles, int n_iterations) const;
+    double intercept() const;
+    double slope() const;
+    double samples() const { return w_; }
+    const SolveTunerOptions& options() const { return opts_; }
+
+private:
+    SolveTunerOptions opts_;
+    // 加权累计量（x = work，y = 耗时）
+    double w_{0.0};
+    double sx_{0.0};
+    double sy_{0.0};
+    double sxx_{0.0};
+    double sxy_{0.0};
+};
+
+} // namespace wta::orch
@@ -0,0 +1,352 @@
+#include "flight_recorder.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+
+#ifdef WTA_HAVE_GLOG
+#include <glog/logging.h>
+#define WTA_LOG(level) LOG(level)
+#else
+#include <iostream>
+#define WTA_LOG(level) if(false) std::cout
+#endif
+
+namespace wta::record {
+
+namespace {
+
+using clock = std::chrono::steady_clock;
+
+inline double now_sec() {
+    return std::chrono::duration<double>(clock::now().time_since_epoch()).count();
+}
+
+constexpr size_t align8(size_t n) { return (n + 7) & ~size_t(7); }
+
+constexpr const char* kSegmentExt = ".wtarec";
+
+std::string segment_path(const std::string& dir, const std::string& stem, uint32_t seq) {
+    char suffix[16];
+    std::snprintf(suffix, sizeof(suffix), "-%04u", seq);
+    return (std::filesystem::path(dir) / (stem + suffix + kSegmentExt)).string();
+}
+
+} // namespace
+
+FlightRecorder::FlightRecorder(FlightRecorderOptions opts) : opts_(std::move(opts)) {
+    const auto epoch = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    stem_ = opts_.prefix + "-" + std::to_string(epoch);
+}
+
+FlightRecorder::~FlightRecorder() {
+    close();
+}
+
+bool FlightRecorder::open() {
+    std::lock_guard<std::mutex> lk(m_);
+    if (seg_.is_open()) return true;
+    std::error_code ec;
+    std::filesystem::create_directories(opts_.directory, ec);
+    if (ec) {
+        WTA_LOG(ERROR) << "[FlightRecorder] cannot create " << opts_.directory << ": " << ec.message();
+        return false;
+    }
+    return roll_locked();
+}
+
+void FlightRecorder::close() {
+    std::lock_guard<std::mutex> lk(m_);
+    if (!seg_.is_open()) return;
+    seg_.flush();
+    seg_.close(static_cast<size_t>(write_off_));
+    WTA_LOG(INFO) << "[FlightRecorder] closed: records=" << records() << " bytes=" << bytes()
+              << " segments=" << segment_paths_.size() << " pruned=" << pruned_segments() << " failed=" << failed()
+              << " avg_ns=" << avg_record_ns();
+}
+
+bool FlightRecorder::is_open() const {
+    std::lock_guard<std::mutex> lk(m_);
+    return seg_.is_open();
+}
+
+std::vector<std::string> FlightRecorder::segments() const {
+    std::lock_guard<std::mutex> lk(m_);
+    return segment_paths_;
+}
+
+double FlightRecorder::avg_record_ns() const {
+    const auto n = records();
+    return n ? static_cast<double>(record_ns_.load(std::memory_order_relaxed)) / n : 0.0;
+}
+
+void FlightRecorder::record_snapshot(double timestamp,
+                                     const std::vector<wta::types::PlatformState>& platforms,
+                                     const std::vector<wta::types::TargetState>& targets) {
+    // 直接编码引用的数据，避免为记录拷贝一份快照
+    const auto t0 = clock::now();
+    thread_local std::vector<uint8_t> buf;
+    buf.clear();
+    ByteWriter w(buf);
+    w.put(timestamp);
+    encode_list(w, platforms);
+    encode_list(w, targets);
+    if (append(RecordKind::Snapshot, now_sec(), buf.data(), buf.size())) {
+        record_ns_.fetch_add(static_cast<uint64_t>((clock::now() - t0).count()), std::memory_order_relaxed);
+    }
+}
+
+void FlightRecorder::record_event(const wta::events::Event& ev) {
+    record(RecordKind::BusEvent, ev);
+}
+
+void FlightRecorder::record_plan_request(const wta::proto::PlanRequest& req) {
+    record(RecordKind::PlanRequest, req);
+}
+
+void FlightRecorder::record_plan_response(const wta::proto::PlanRequest& req, const wta::proto::PlanResponse& resp) {
+    // 直接编码请求标识和响应，避免为记录拷贝一份响应
+    const auto t0 = clock::now();
+    thread_local std::vector<uint8_t> buf;
+    buf.clear();
+    ByteWriter w(buf);
+    w.put(req.snapshot_version);
+    w.put(static_cast<int32_t>(req.cluster_index));
+    encode(w, resp);
+    if (append(RecordKind::PlanResponse, now_sec(), buf.data(), buf.size())) {
+        record_ns_.fetch_add(static_cast<uint64_t>((clock::now() - t0).count()), std::memory_order_relaxed);
+    }
+}
+
+void FlightRecorder::record_exec_apply(const wta::proto::PlanResponse& resp) {
+    // 与 InterceptExecutor 的解析一致：行优先矩阵，平台/目标ID = 下标 + 1
+    ExecCommand cmd;
+    cmd.plan_timestamp = resp.timestamp;
+    cmd.n_platforms = static_cast<uint32_t>(resp.n_platforms);
+    cmd.n_targets = static_cast<uint32_t>(resp.n_targets);
+    for (size_t i = 0; i < resp.n_platforms; ++i) {
+        for (size_t j = 0; j < resp.n_targets; ++j) {
+            const size_t idx = wta::types::idx_row_major(i, j, resp.n_targets);
+            if (idx < resp.assignment.size() && resp.assignment[idx] > 0) {
+                cmd.engagements.push_back({static_cast<wta::types::PlatformId>(i + 1),
+                                           static_cast<wta::types::TargetId>(j + 1)});
+            }
+        }
+    }
+    record(RecordKind::ExecApply, cmd);
+}
+
+void FlightRecorder::record_exec_reassign(
+    const std::unordered_map<wta::types::PlatformId, wta::types::TargetId>& moves) {
+    record(RecordKind::ExecReassign, make_exec_reassign(moves));
+}
+
+template <class T>
+void FlightRecorder::record(RecordKind kind, const T& payload) {
+    const auto t0 = clock::now();
+    thread_local std::vector<uint8_t> buf;
+    buf.clear();
+    ByteWriter w(buf);
+    encode(w, payload);
+    if (append(kind, now_sec(), buf.data(), buf.size())) {
+        record_ns_.fetch_add(static_cast<uint64_t>((clock::now() - t0).count()), std::memory_order_relaxed);
+    }
+}
+
+SegmentHeader* FlightRecorder::header_locked() {
+    return reinterpret_cast<SegmentHeader*>(seg_.data());
+}
+
+bool FlightRecorder::append(RecordKind kind, double timestamp, const uint8_t* data, size_t n) {
+    const size_t need = align8(sizeof(RecordHeader) + n);
+
+    std::lock_guard<std::mutex> lk(m_);
+    if (!seg_.is_open()) {
+        failed_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    if (write_off_ + need > seg_.size()) {
+        const auto* h = header_locked();
+        if (h->data_offset + need > seg_.size() || !roll_locked()) {
+            failed_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+
+    auto* h = header_locked();
+    uint8_t* p = seg_.data() + write_off_;
+    const RecordHeader rh{static_cast<uint32_t>(n), static_cast<uint16_t>(kind), 0, timestamp};
+    std::memcpy(p, &rh, sizeof(rh));
+    if (n) std::memcpy(p + sizeof(rh), data, n);
+
+    if (h->index_count == 0) h->first_timestamp = timestamp;
+    if (h->index_count < h->index_capacity &&
+        (h->index_count == 0 || timestamp - last_index_ts_ >= opts_.index_interval_sec)) {
+        auto* index = reinterpret_cast<IndexEntry*>(seg_.data() + sizeof(SegmentHeader));
+        index[h->index_count++] = IndexEntry{timestamp, write_off_};
+        last_index_ts_ = timestamp;
+    }
+
+    write_off_ += need;
+    h->write_offset = write_off_;   // 提交：读取端只认 write_offset 之前的数据
+
+    records_.fetch_add(1, std::memory_order_relaxed);
+    bytes_.fetch_add(need, std::memory_order_relaxed);
+    return true;
+}
+
+bool FlightRecorder::roll_locked() {
+    if (seg_.is_open()) {
+        seg_.flush();
+        seg_.close(static_cast<size_t>(write_off_));
+    }
+
+    const std::string path = segment_path(opts_.directory, stem_, ++seg_seq_);
+    const size_t data_offset = align8(sizeof(SegmentHeader) + sizeof(IndexEntry) * opts_.index_capacity);
+    const size_t size = std::max(opts_.segment_bytes, data_offset + 4096);
+    if (!seg_.create(path, size)) {
+        WTA_LOG(ERROR) << "[FlightRecorder] cannot map segment " << path;
+        return false;
+    }
+
+    auto* h = header_locked();
+    std::memset(h, 0, sizeof(SegmentHeader));
+    std::memcpy(h->magic, kSegmentMagic, sizeof(kSegmentMagic));
+    h->version = kSegmentVersion;
+    h->index_capacity = opts_.index_capacity;
+    h->data_offset = data_offset;
+    h->write_offset = data_offset;
+    h->segment_seq = seg_seq_;
+    write_off_ = data_offset;
+    last_index_ts_ = 0.0;
+    segment_paths_.push_back(path);
+    WTA_LOG(INFO) << "[FlightRecorder] recording to " << path;
+    prune_locked();
+    return true;
+}
+
+void FlightRecorder::prune_locked() {
+    if (opts_.max_segments == 0) return;
+    while (segment_paths_.size() > opts_.max_segments) {
+        std::error_code ec;
+        std::filesystem::remove(segment_paths_.front(), ec);
+        if (ec) {
+            WTA_LOG(WARNING) << "[FlightRecorder] cannot remove " << segment_paths_.front() << ": " << ec.message();
+        }
+        segment_paths_.erase(segment_paths_.begin());
+        pruned_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// ==================== RecordingReader ====================
+
+bool RecordingReader::open(const std::vector<std::string>& segment_paths) {
+    close();
+    for (const auto& path : segment_paths) {
+        Segment seg;
+        seg.file = std::make_unique<MappedFile>();
+        if (!seg.file->open_readonly(path) || seg.file->size() < sizeof(SegmentHeader)) {
+            WTA_LOG(WARNING) << "[FlightRecorder] skip unreadable segment " << path;
+            continue;
+        }
+        seg.header = reinterpret_cast<const SegmentHeader*>(seg.file->data());
+        if (std::memcmp(seg.header->magic, kSegmentMagic, sizeof(kSegmentMagic)) != 0 ||
+            seg.header->version != kSegmentVersion ||
+            seg.header->data_offset > seg.file->size()) {
+            WTA_LOG(WARNING) << "[FlightRecorder] skip invalid segment " << path;
+            continue;
+        }
+        seg.index = reinterpret_cast<const IndexEntry*>(seg.file->data() + sizeof(SegmentHeader));
+        seg.end = std::min<uint64_t>(seg.header->write_offset, seg.file->size());
+        segs_.push_back(std::move(seg));
+    }
+    rewind();
+    return !segs_.empty();
+}
+
+void RecordingReader::close() {
+    segs_.clear();
+    seg_ = 0;
+    off_ = 0;
+}
+
+void RecordingReader::rewind() {
+    seg_ = 0;
+    off_ = segs_.empty() ? 0 : segs_[0].header->data_offset;
+}
+
+bool RecordingReader::next(RecordView& out) {
+    while (seg_ < segs_.size()) {
+        const auto& seg = segs_[seg_];
+        if (off_ + sizeof(RecordHeader) <= seg.end) {
+            RecordHeader rh;
+            std::memcpy(&rh, seg.file->data() + off_, sizeof(rh));
+            const uint64_t total = align8(sizeof(RecordHeader) + rh.length);
+            if (off_ + total <= seg.end) {
+                out.kind = static_cast<RecordKind>(rh.kind);
+                out.timestamp = rh.timestamp;
+                out.data = seg.file->data() + off_ + sizeof(RecordHeader);
+                out.size = rh.length;
+                off_ += total;
+                return true;
+            }
+        }
+        // 当前段读完（或尾部不完整），进入下一段
+        if (++seg_ < segs_.size()) off_ = segs_[seg_].header->data_offset;
+    }
+    return false;
+}
+
+bool RecordingReader::seek(double t) {
+    if (segs_.empty()) return false;
+
+    // 找到最后一个起始时间 <= t 的段
+    size_t s = 0;
+    for (size_t i = 0; i < segs_.size(); ++i) {
+        if (segs_[i].header->index_count > 0 && segs_[i].header->first_timestamp <= t) s = i;
+    }
+    const auto& seg = segs_[s];
+    const IndexEntry* begin = seg.index;
+    const IndexEntry* end = seg.index + std::min(seg.header->index_count, seg.header->index_capacity);
+    const IndexEntry* it = std::upper_bound(begin, end, t,
+        [](double v, const IndexEntry& e) { return v < e.timestamp; });
+
+    seg_ = s;
+    off_ = (it == begin) ? seg.header->data_offset : (it - 1)->offset;
+
+    // 索引是稀疏的：线性前进到第一条 >= t 的记录
+    for (;;) {
+        const size_t save_seg = seg_;
+        const uint64_t save_off = off_;
+        RecordView v;
+        if (!next(v)) return false;
+        if (v.timestamp >= t) {
+            seg_ = save_seg;
+            off_ = save_off;
+            return true;
+        }
+    }
+}
+
+double RecordingReader::start_time() const {
+    for (const auto& seg : segs_) {
+        if (seg.header->index_count > 0) return seg.header->first_timestamp;
+    }
+    return 0.0;
+}
+
+std::vector<std::string> find_segments(const std::string& directory, const std::string& session_stem) {
+    std::vector<std::string> out;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+        const auto name = entry.path().filename().string();
+        if (name.rfind(session_stem + "-", 0) == 0 && entry.path().extension() == kSegmentExt) {
+            out.push_back(entry.path().string());
+        }
+    }
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+} // namespace wta::record
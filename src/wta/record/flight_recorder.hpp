@@ -0,0 +1,190 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "mapped_file.hpp"
+#include "record_codec.hpp"
+
+namespace wta::world { struct IWorldSampler; }
+namespace wta::net { struct ISolverClient; }
+namespace wta::exec { struct IExecutor; }
+
+namespace wta::record {
+
+// ==================== 段文件格式 ====================
+//
+// [SegmentHeader 64B][IndexEntry × index_capacity][Record][Record]...
+// Record = [RecordHeader 16B][payload][填充到 8 字节对齐]
+// write_offset 在每条记录写完后更新，读取端以它为有效数据的结尾（崩溃时最多丢失最后一条）
+
+constexpr char     kSegmentMagic[8] = {'W', 'T', 'A', 'R', 'E', 'C', '0', '1'};
+constexpr uint32_t kSegmentVersion  = 2;
+
+struct SegmentHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t index_capacity;
+    uint64_t data_offset;       // 第一条记录的位置
+    uint64_t write_offset;      // 已提交数据的结束位置
+    uint32_t index_count;
+    uint32_t segment_seq;
+    double   first_timestamp;
+    uint8_t  reserved[16];
+};
+static_assert(sizeof(SegmentHeader) == 64, "SegmentHeader layout changed");
+
+// 稀疏时间索引：记录时间戳 -> 段内偏移
+struct IndexEntry {
+    double   timestamp;
+    uint64_t offset;
+};
+
+struct RecordHeader {
+    uint32_t length;            // 负载字节数（不含头和填充）
+    uint16_t kind;              // RecordKind
+    uint16_t reserved;
+    double   timestamp;         // 记录时刻（steady_clock 秒，与 Orchestrator 一致）
+};
+static_assert(sizeof(RecordHeader) == 16, "RecordHeader layout changed");
+
+struct FlightRecorderOptions {
+    std::string directory{"wta_recordings"};
+    std::string prefix{"flight"};
+    size_t      segment_bytes{64u << 20};   // 单段大小，写满后滚动到新段
+    uint32_t    index_capacity{4096};       // 每段最多的索引项
+    double      index_interval_sec{0.1};    // 相邻索引项的最小时间间隔
+    uint32_t    max_segments{8};            // 本会话最多保留的段数，滚动时删除最旧的段；0 表示不限制
+};
+
+/**
+ * @brief 飞行记录器 - 把快照、总线事件、规划请求/响应和执行指令（含本地改派）追加到内存映射段文件
+ *
+ * - 编码在调用线程的线程局部缓冲区完成，加锁后只做一次 memcpy 和头部更新
+ * - 段写满时滚动到新段；每段头部自带稀疏时间索引，回放可按时间定位
+ * - 磁盘占用不超过 max_segments × segment_bytes：超出时删除最旧的段，只保留最近的记录
+ * - 任何写入失败只计数不抛异常，记录器不能影响主流程
+ */
+class FlightRecorder {
+public:
+    explicit FlightRecorder(FlightRecorderOptions opts = {});
+    ~FlightRecorder();
+
+    FlightRecorder(const FlightRecorder&)            = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+    bool open();
+    void close();
+    bool is_open() const;
+
+    void record_snapshot(double timestamp,
+                         const std::vector<wta::types::PlatformState>& platforms,
+                         const std::vector<wta::types::TargetState>& targets);
+    void record_event(const wta::events::Event& ev);
+    void record_plan_request(const wta::proto::PlanRequest& req);
+    // 响应连同所属请求的标识一起记录，回放时按请求匹配
+    void record_plan_response(const wta::proto::PlanRequest& req, const wta::proto::PlanResponse& resp);
+    void record_exec_apply(const wta::proto::PlanResponse& resp);
+    void record_exec_reassign(const std::unordered_map<wta::types::PlatformId, wta::types::TargetId>& moves);
+
+    // 会话文件名前缀（prefix-<启动时间>），段文件为 <stem>-<序号>.wtarec
+    const std::string& session_stem() const { return stem_; }
+    std::vector<std::string> segments() const;
+
+    uint64_t records() const { return records_.load(std::memory_order_relaxed); }
+    uint64_t bytes() const { return bytes_.load(std::memory_order_relaxed); }
+    uint64_t failed() const { return failed_.load(std::memory_order_relaxed); }
+    // 因超出保留上限而删除的段数
+    uint64_t pruned_segments() const { return pruned_.load(std::memory_order_relaxed); }
+    // 每条记录的平均开销（编码 + 写入，纳秒）
+    double avg_record_ns() const;
+
+private:
+    template <class T>
+    void record(RecordKind kind, const T& payload);
+    bool append(RecordKind kind, double timestamp, const uint8_t* data, size_t n);
+    bool roll_locked();
+    void prune_locked();
+    SegmentHeader* header_locked();
+
+    FlightRecorderOptions opts_;
+    std::string stem_;
+
+    mutable std::mutex m_;
+    MappedFile seg_;
+    uint32_t seg_seq_{0};
+    uint64_t write_off_{0};
+    double last_index_ts_{0.0};
+    std::vector<std::string> segment_paths_;
+
+    std::atomic<uint64_t> records_{0};
+    std::atomic<uint64_t> bytes_{0};
+    std::atomic<uint64_t> failed_{0};
+    std::atomic<uint64_t> pruned_{0};
+    std::atomic<uint64_t> record_ns_{0};
+};
+
+// ==================== 读取 ====================
+
+struct RecordView {
+    RecordKind     kind{RecordKind::Snapshot};
+    double         timestamp{0.0};
+    const uint8_t* data{nullptr};
+    uint32_t       size{0};
+};
+
+template <class T>
+inline bool decode_record(const RecordView& view, T& out) {
+    ByteReader r(view.data, view.size);
+    decode(r, out);
+    return r.ok();
+}
+
+/**
+ * @brief 按顺序读取一组段文件
+ */
+class RecordingReader {
+public:
+    bool open(const std::vector<std::string>& segment_paths);
+    void close();
+
+    bool next(RecordView& out);
+    void rewind();
+
+    /**
+     * @brief 定位到第一条时间戳 >= t 的记录（先用段索引二分，再线性前进）
+     */
+    bool seek(double t);
+
+    double start_time() const;
+    size_t segment_count() const { return segs_.size(); }
+
+private:
+    struct Segment {
+        std::unique_ptr<MappedFile> file;
+        const SegmentHeader* header{nullptr};
+        const IndexEntry* index{nullptr};
+        uint64_t end{0};
+    };
+
+    std::vector<Segment> segs_;
+    size_t seg_{0};
+    uint64_t off_{0};
+};
+
+// 列出目录下属于某个会话的段文件（按序号排序）
+std::vector<std::string> find_segments(const std::string& directory, const std::string& session_stem);
+
+// ==================== 记录装饰器 ====================
+// 包装真实实现：调用透传给 inner，同时把输入/输出写入记录器（inner 和 recorder 的生命周期由调用方保证）
+
+std::unique_ptr<wta::world::IWorldSampler> make_recording_sampler(wta::world::IWorldSampler& inner,
+                                                                  FlightRecorder& recorder);
+std::unique_ptr<wta::net::ISolverClient> make_recording_solver_client(wta::net::ISolverClient& inner,
+                                                                      FlightRecorder& recorder);
+std::unique_ptr<wta::exec::IExecutor> make_recording_executor(wta::exec::IExecutor& inner,
+                                                              FlightRecorder& recorder);
+
+} // namespace wta::record
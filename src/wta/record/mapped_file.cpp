@@ -0,0 +1,167 @@
+#include "mapped_file.hpp"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace wta::record {
+
+#ifdef _WIN32
+
+bool MappedFile::create(const std::string& path, size_t size) {
+    close();
+    HANDLE file = ::CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                                CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    const auto size64 = static_cast<unsigned long long>(size);
+    HANDLE mapping = ::CreateFileMappingA(file, nullptr, PAGE_READWRITE,
+                                          static_cast<DWORD>(size64 >> 32),
+                                          static_cast<DWORD>(size64 & 0xFFFFFFFFull), nullptr);
+    if (!mapping) {
+        ::CloseHandle(file);
+        return false;
+    }
+    void* view = ::MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, size);
+    if (!view) {
+        ::CloseHandle(mapping);
+        ::CloseHandle(file);
+        return false;
+    }
+
+    file_ = file;
+    mapping_ = mapping;
+    data_ = static_cast<uint8_t*>(view);
+    size_ = size;
+    writable_ = true;
+    path_ = path;
+    return true;
+}
+
+bool MappedFile::open_readonly(const std::string& path) {
+    close();
+    HANDLE file = ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size{};
+    if (!::GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        ::CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        ::CloseHandle(file);
+        return false;
+    }
+    void* view = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        ::CloseHandle(mapping);
+        ::CloseHandle(file);
+        return false;
+    }
+
+    file_ = file;
+    mapping_ = mapping;
+    data_ = static_cast<uint8_t*>(view);
+    size_ = static_cast<size_t>(size.QuadPart);
+    writable_ = false;
+    path_ = path;
+    return true;
+}
+
+void MappedFile::flush() {
+    if (data_ && writable_) ::FlushViewOfFile(data_, 0);
+}
+
+void MappedFile::close(size_t truncate_to) {
+    if (!data_) return;
+    ::UnmapViewOfFile(data_);
+    ::CloseHandle(mapping_);
+    if (writable_ && truncate_to > 0 && truncate_to < size_) {
+        LARGE_INTEGER pos{};
+        pos.QuadPart = static_cast<LONGLONG>(truncate_to);
+        if (::SetFilePointerEx(file_, pos, nullptr, FILE_BEGIN)) ::SetEndOfFile(file_);
+    }
+    ::CloseHandle(file_);
+    data_ = nullptr;
+    mapping_ = nullptr;
+    file_ = nullptr;
+    size_ = 0;
+}
+
+#else
+
+bool MappedFile::create(const std::string& path, size_t size) {
+    close();
+    const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        ::close(fd);
+        return false;
+    }
+    void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+        ::close(fd);
+        return false;
+    }
+
+    fd_ = fd;
+    data_ = static_cast<uint8_t*>(p);
+    size_ = size;
+    writable_ = true;
+    path_ = path;
+    return true;
+}
+
+bool MappedFile::open_readonly(const std::string& path) {
+    close();
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+    const auto size = static_cast<size_t>(st.st_size);
+    void* p = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+        ::close(fd);
+        return false;
+    }
+
+    fd_ = fd;
+    data_ = static_cast<uint8_t*>(p);
+    size_ = size;
+    writable_ = false;
+    path_ = path;
+    return true;
+}
+
+void MappedFile::flush() {
+    if (data_ && writable_) ::msync(data_, size_, MS_ASYNC);
+}
+
+void MappedFile::close(size_t truncate_to) {
+    if (!data_) return;
+    ::munmap(data_, size_);
+    if (writable_ && truncate_to > 0 && truncate_to < size_) {
+        (void)::ftruncate(fd_, static_cast<off_t>(truncate_to));
+    }
+    ::close(fd_);
+    data_ = nullptr;
+    fd_ = -1;
+    size_ = 0;
+}
+
+#endif
+
+} // namespace wta::record
@@ -0,0 +1,55 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace wta::record {
+
+/**
+ * @brief 内存映射文件（Windows: CreateFileMapping / POSIX: mmap）
+ *
+ * 写入映射区域只是内存拷贝；进程崩溃后已写入的页仍由操作系统落盘。
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // 创建（或截断）文件并映射 size 字节，可读写
+    bool create(const std::string& path, size_t size);
+
+    // 只读映射已有文件的全部内容
+    bool open_readonly(const std::string& path);
+
+    // 异步刷写脏页到磁盘
+    void flush();
+
+    /**
+     * @brief 解除映射并关闭文件
+     * @param truncate_to 非 0 且为可写映射时，关闭后把文件截断为该长度（去掉未使用的尾部）
+     */
+    void close(size_t truncate_to = 0);
+
+    bool is_open() const { return data_ != nullptr; }
+    uint8_t* data() { return data_; }
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    const std::string& path() const { return path_; }
+
+private:
+    uint8_t* data_{nullptr};
+    size_t size_{0};
+    bool writable_{false};
+    std::string path_;
+#ifdef _WIN32
+    void* file_{nullptr};
+    void* mapping_{nullptr};
+#else
+    int fd_{-1};
+#endif
+};
+
+} // namespace wta::record
@@ -0,0 +1,460 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include "../core/solver_messages.hpp"
+#include "../world/event_bus.hpp"
+
+/**
+ * @file record_codec.hpp
+ * @brief 飞行记录器的二进制编解码
+ *
+ * 记录只在本机写入/回放，不需要跨语言：字段按本机字节序直接拷贝，
+ * 字符串/数组为 u32 长度前缀。比经 protobuf 中转少一次对象构造，单条记录编码在微秒级以内。
+ * 字段没有可选/缺省形式：任何负载布局变化都要提升 kSegmentVersion，读取端跳过版本不符的段。
+ */
+
+namespace wta::record {
+
+// 记录类型（写入文件，只能追加新值）
+enum class RecordKind : uint16_t {
+    Snapshot     = 1,   // 采样得到的世界快照
+    BusEvent     = 2,   // 事件总线上的事件
+    PlanRequest  = 3,   // 发给求解器的规划请求
+    PlanResponse = 4,   // 求解器返回的规划结果
+    ExecApply    = 5,   // 执行器收到的分配指令
+    ExecReassign = 6    // 执行器收到的本地改派（击毁后的局部修复）
+};
+
+struct Snapshot {
+    double timestamp{0.0};
+    std::vector<wta::types::PlatformState> platforms;
+    std::vector<wta::types::TargetState> targets;
+};
+
+struct Engagement {
+    wta::types::PlatformId platform_id{0};
+    wta::types::TargetId   target_id{0};
+};
+
+// 规划请求的标识：回放时按它把录制的响应交还给对应的请求（分区求解的各簇请求并行在途，到达顺序不固定）
+struct PlanKey {
+    uint64_t snapshot_version{0};
+    int32_t  cluster_index{-1};
+};
+
+// 规划响应记录：响应及其所属请求
+struct PlanResponseRecord {
+    PlanKey key;
+    wta::proto::PlanResponse resp;
+};
+
+// 执行器指令：某次规划被应用时下发的 (平台, 目标) 对
+struct ExecCommand {
+    double plan_timestamp{0.0};
+    uint32_t n_platforms{0};
+    uint32_t n_targets{0};
+    std::vector<Engagement> engagements;
+};
+
+// 执行器本地改派：平台 -> 新目标（按平台排序，同样的改派总是得到同样的记录）
+struct ExecReassign {
+    std::vector<Engagement> moves;
+};
+
+inline ExecReassign make_exec_reassign(
+    const std::unordered_map<wta::types::PlatformId, wta::types::TargetId>& moves) {
+    ExecReassign cmd;
+    cmd.moves.reserve(moves.size());
+    for (const auto& [pid, tid] : moves) cmd.moves.push_back({pid, tid});
+    std::sort(cmd.moves.begin(), cmd.moves.end(),
+              [](const Engagement& a, const Engagement& b) { return a.platform_id < b.platform_id; });
+    return cmd;
+}
+
+class ByteWriter {
+public:
+    explicit ByteWriter(std::vector<uint8_t>& buf) : buf_(buf) {}
+
+    template <class T>
+    void put(T v) {
+        static_assert(std::is_trivially_copyable_v<T>, "put() requires a trivially copyable type");
+        const size_t at = buf_.size();
+        buf_.resize(at + sizeof(T));
+        std::memcpy(buf_.data() + at, &v, sizeof(T));
+    }
+
+    void put_bytes(const void* p, size_t n) {
+        put(static_cast<uint32_t>(n));
+        const size_t at = buf_.size();
+        buf_.resize(at + n);
+        if (n) std::memcpy(buf_.data() + at, p, n);
+    }
+
+    void put_str(const std::string& s) { put_bytes(s.data(), s.size()); }
+
+    template <class T>
+    void put_pod_vec(const std::vector<T>& v) {
+        static_assert(std::is_trivially_copyable_v<T>, "put_pod_vec() requires a trivially copyable type");
+        put_bytes(v.data(), v.size() * sizeof(T));
+    }
+
+private:
+    std::vector<uint8_t>& buf_;
+};
+
+// 越界读取时置 ok() = false 并返回默认值，调用方在最后统一检查
+class ByteReader {
+public:
+    ByteReader(const uint8_t* p, size_t n) : p_(p), end_(p + n) {}
+
+    template <class T>
+    T get() {
+        static_assert(std::is_trivially_copyable_v<T>, "get() requires a trivially copyable type");
+        T v{};
+        if (!ok_ || static_cast<size_t>(end_ - p_) < sizeof(T)) {
+            ok_ = false;
+            return v;
+        }
+        std::memcpy(&v, p_, sizeof(T));
+        p_ += sizeof(T);
+        return v;
+    }
+
+    std::string get_str() {
+        const auto n = get<uint32_t>();
+        if (!ok_ || static_cast<size_t>(end_ - p_) < n) {
+            ok_ = false;
+            return {};
+        }
+        std::string s(reinterpret_cast<const char*>(p_), n);
+        p_ += n;
+        return s;
+    }
+
+    template <class T>
+    std::vector<T> get_pod_vec() {
+        const auto n = get<uint32_t>();
+        if (!ok_ || n % sizeof(T) != 0 || static_cast<size_t>(end_ - p_) < n) {
+            ok_ = false;
+            return {};
+        }
+        std::vector<T> v(n / sizeof(T));
+        if (n) std::memcpy(v.data(), p_, n);
+        p_ += n;
+        return v;
+    }
+
+    bool ok() const { return ok_; }
+    size_t remaining() const { return ok_ ? static_cast<size_t>(end_ - p_) : 0; }
+
+private:
+    const uint8_t* p_;
+    const uint8_t* end_;
+    bool ok_{true};
+};
+
+// ==================== 实体状态 ====================
+
+inline void encode(ByteWriter& w, const wta::types::PlatformState& p) {
+    w.put(p.id);
+    w.put(p.role);
+    w.put(p.hit_prob);
+    w.put(p.cost);
+    w.put(p.pos);
+    w.put(p.max_range);
+    w.put(p.max_targets);
+    w.put(p.quantity);
+    w.put(p.alive);
+    w.put(static_cast<uint32_t>(p.target_types.size()));
+    for (int t : p.target_types) w.put(t);
+    w.put(p.ammo);
+    w.put_str(p.platform_type);
+    w.put(static_cast<uint32_t>(p.magazines.size()));
+    for (const auto& m : p.magazines) {
+        w.put_str(m.name);
+        w.put(m.ammo_count);
+        w.put(m.loaded);
+        w.put(m.type);
+        w.put_str(m.location);
+    }
+    w.put(p.fuel);
+    w.put(p.damage);
+}
+
+inline void decode(ByteReader& r, wta::types::PlatformState& p) {
+    p.id = r.get<wta::types::PlatformId>();
+    p.role = r.get<wta::types::PlatformRole>();
+    p.hit_prob = r.get<float>();
+    p.cost = r.get<float>();
+    p.pos = r.get<wta::types::Vec2>();
+    p.max_range = r.get<float>();
+    p.max_targets = r.get<int>();
+    p.quantity = r.get<int>();
+    p.alive = r.get<bool>();
+    const auto n_types = r.get<uint32_t>();
+    p.target_types.clear();
+    for (uint32_t i = 0; i < n_types && r.ok(); ++i) p.target_types.insert(r.get<int>());
+    p.ammo = r.get<wta::types::AmmoState>();
+    p.platform_type = r.get_str();
+    const auto n_mags = r.get<uint32_t>();
+    p.magazines.clear();
+    for (uint32_t i = 0; i < n_mags && r.ok(); ++i) {
+        wta::types::MagazineDetail m;
+        m.name = r.get_str();
+        m.ammo_count = r.get<int>();
+        m.loaded = r.get<bool>();
+        m.type = r.get<int>();
+        m.location = r.get_str();
+        p.magazines.push_back(std::move(m));
+    }
+    p.fuel = r.get<float>();
+    p.damage = r.get<float>();
+}
+
+inline void encode(ByteWriter& w, const wta::types::TargetState& t) {
+    w.put(t.id);
+    w.put(t.kind);
+    w.put(t.tier);
+    w.put(t.value);
+    w.put(t.pos);
+    w.put_pod_vec(t.prerequisites);
+    w.put(t.alive);
+    w.put_str(t.target_type);
+    w.put_pod_vec(t.prerequisite_targets);
+}
+
+inline void decode(ByteReader& r, wta::types::TargetState& t) {
+    t.id = r.get<wta::types::TargetId>();
+    t.kind = r.get<wta::types::TargetKind>();
+    t.tier = r.get<int>();
+    t.value = r.get<float>();
+    t.pos = r.get<wta::types::Vec2>();
+    t.prerequisites = r.get_pod_vec<int>();
+    t.alive = r.get<bool>();
+    t.target_type = r.get_str();
+    t.prerequisite_targets = r.get_pod_vec<int>();
+}
+
+template <class T>
+inline void encode_list(ByteWriter& w, const std::vector<T>& v) {
+    w.put(static_cast<uint32_t>(v.size()));
+    for (const auto& e : v) encode(w, e);
+}
+
+template <class T>
+inline void decode_list(ByteReader& r, std::vector<T>& v) {
+    const auto n = r.get<uint32_t>();
+    v.clear();
+    for (uint32_t i = 0; i < n && r.ok(); ++i) {
+        T e;
+        decode(r, e);
+        v.push_back(std::move(e));
+    }
+}
+
+// ==================== 配置 ====================
+
+inline void encode(ByteWriter& w, const wta::config::SolveConfig& c) {
+    w.put(c.bpso.n_particles);
+    w.put(c.bpso.n_iterations);
+    w.put(c.bpso.w_max);
+    w.put(c.bpso.w_min);
+    w.put(c.bpso.c1);
+    w.put(c.bpso.c2);
+    w.put(c.bpso.v_max);
+    w.put(c.bpso.use_gpu);
+    w.put(c.bpso.seed.has_value());
+    w.put(c.bpso.seed.value_or(0));
+    w.put(c.model.enable_tier_constraint);
+    w.put(c.model.enable_coverage_constraint);
+    w.put(c.model.enable_distance_constraint);
+    w.put(c.model.weights);
+}
+
+inline void decode(ByteReader& r, wta::config::SolveConfig& c) {
+    c.bpso.n_particles = r.get<int>();
+    c.bpso.n_iterations = r.get<int>();
+    c.bpso.w_max = r.get<float>();
+    c.bpso.w_min = r.get<float>();
+    c.bpso.c1 = r.get<float>();
+    c.bpso.c2 = r.get<float>();
+    c.bpso.v_max = r.get<float>();
+    c.bpso.use_gpu = r.get<bool>();
+    const bool has_seed = r.get<bool>();
+    const int seed = r.get<int>();
+    c.bpso.seed = has_seed ? std::optional<int>(seed) : std::nullopt;
+    c.model.enable_tier_constraint = r.get<bool>();
+    c.model.enable_coverage_constraint = r.get<bool>();
+    c.model.enable_distance_constraint = r.get<bool>();
+    c.model.weights = r.get<wta::config::ModelWeights>();
+}
+
+// ==================== 记录负载 ====================
+
+inline void encode(ByteWriter& w, const Snapshot& s) {
+    w.put(s.timestamp);
+    encode_list(w, s.platforms);
+    encode_list(w, s.targets);
+}
+
+inline void decode(ByteReader& r, Snapshot& s) {
+    s.timestamp = r.get<double>();
+    decode_list(r, s.platforms);
+    decode_list(r, s.targets);
+}
+
+inline void encode(ByteWriter& w, const wta::proto::PlanRequest& req) {
+    w.put(req.timestamp);
+    w.put_str(req.reason);
+    encode(w, req.config);
+    encode_list(w, req.platforms);
+    encode_list(w, req.targets);
+    w.put(req.snapshot_version);
+    w.put(req.max_follow_ons);
+    w.put(static_cast<int32_t>(req.cluster_index));
+}
+
+inline void decode(ByteReader& r, wta::proto::PlanRequest& req) {
+    req.timestamp = r.get<double>();
+    req.reason = r.get_str();
+    decode(r, req.config);
+    decode_list(r, req.platforms);
+    decode_list(r, req.targets);
+    req.snapshot_version = r.get<uint64_t>();
+    req.max_follow_ons = r.get<int>();
+    req.cluster_index = r.get<int32_t>();
+}
+
+inline void encode(ByteWriter& w, const wta::proto::PlanResponse& resp) {
+    w.put_str(resp.status);
+    w.put(resp.timestamp);
+    w.put(resp.best_fitness);
+    w.put_pod_vec(resp.assignment);
+    w.put(static_cast<uint64_t>(resp.n_platforms));
+    w.put(static_cast<uint64_t>(resp.n_targets));
+    w.put(resp.stats.computation_time);
+    w.put(resp.stats.iterations);
+    w.put(resp.stats.is_valid);
+    w.put(resp.stats.coverage_rate);
+    w.put(resp.ttl_sec);
+    w.put_str(resp.error_msg);
+    w.put(resp.snapshot_version);
+    w.put(static_cast<uint32_t>(resp.follow_ons.size()));
+    for (const auto& q : resp.follow_ons) {
+        w.put(q.platform_id);
+        w.put_pod_vec(q.steps);
+    }
+}
+
+inline void decode(ByteReader& r, wta::proto::PlanResponse& resp) {
+    resp.status = r.get_str();
+    resp.timestamp = r.get<double>();
+    resp.best_fitness = r.get<double>();
+    resp.assignment = r.get_pod_vec<uint8_t>();
+    resp.n_platforms = static_cast<size_t>(r.get<uint64_t>());
+    resp.n_targets = static_cast<size_t>(r.get<uint64_t>());
+    resp.stats.computation_time = r.get<double>();
+    resp.stats.iterations = r.get<int>();
+    resp.stats.is_valid = r.get<bool>();
+    resp.stats.coverage_rate = r.get<double>();
+    resp.ttl_sec = r.get<double>();
+    resp.error_msg = r.get_str();
+    resp.snapshot_version = r.get<uint64_t>();
+    resp.follow_ons.clear();
+    const auto n = r.get<uint32_t>();
+    for (uint32_t i = 0; i < n && r.ok(); ++i) {
+        wta::proto::EngagementQueue q;
+        q.platform_id = r.get<wta::types::PlatformId>();
+        q.steps = r.get_pod_vec<wta::proto::FollowOnEngagement>();
+        resp.follow_ons.push_back(std::move(q));
+    }
+}
+
+inline void encode(ByteWriter& w, const PlanResponseRecord& rec) {
+    w.put(rec.key.snapshot_version);
+    w.put(rec.key.cluster_index);
+    encode(w, rec.resp);
+}
+
+inline void decode(ByteReader& r, PlanResponseRecord& rec) {
+    rec.key.snapshot_version = r.get<uint64_t>();
+    rec.key.cluster_index = r.get<int32_t>();
+    decode(r, rec.resp);
+}
+
+inline void encode(ByteWriter& w, const ExecCommand& cmd) {
+    w.put(cmd.plan_timestamp);
+    w.put(cmd.n_platforms);
+    w.put(cmd.n_targets);
+    w.put_pod_vec(cmd.engagements);
+}
+
+inline void decode(ByteReader& r, ExecCommand& cmd) {
+    cmd.plan_timestamp = r.get<double>();
+    cmd.n_platforms = r.get<uint32_t>();
+    cmd.n_targets = r.get<uint32_t>();
+    cmd.engagements = r.get_pod_vec<Engagement>();
+}
+
+inline void encode(ByteWriter& w, const ExecReassign& cmd) {
+    w.put_pod_vec(cmd.moves);
+}
+
+inline void decode(ByteReader& r, ExecReassign& cmd) {
+    cmd.moves = r.get_pod_vec<Engagement>();
+}
+
+// 开火事件的武器ID只在本进程有效，记录时写入字符串，回放时重新驻留
+inline void encode(ByteWriter& w, const wta::events::Event& e) {
+    w.put(e.type);
+    w.put(e.timestamp);
+    w.put(static_cast<uint8_t>(e.payload.index()));
+    if (const auto* k = std::get_if<wta::events::EntityKilledEvent>(&e.payload)) {
+        w.put(k->entity_id);
+        w.put(k->is_platform);
+    } else if (const auto* d = std::get_if<wta::events::DamageEvent>(&e.payload)) {
+        w.put(d->entity_id);
+        w.put(d->damage);
+        w.put(d->is_platform);
+    } else if (const auto* f = std::get_if<wta::events::FiredEvent>(&e.payload)) {
+        w.put(f->platform_id);
+        const auto name = wta::core::weapon_names().lookup(f->weapon);
+        w.put_bytes(name.data(), name.size());
+    }
+}
+
+inline void decode(ByteReader& r, wta::events::Event& e) {
+    e.type = r.get<wta::events::EventType>();
+    e.timestamp = r.get<double>();
+    switch (r.get<uint8_t>()) {
+        case 1: {
+            wta::events::DamageEvent d;
+            d.entity_id = r.get<wta::types::Id>();
+            d.damage = r.get<float>();
+            d.is_platform = r.get<bool>();
+            e.payload = d;
+            break;
+        }
+        case 2: {
+            wta::events::FiredEvent f;
+            f.platform_id = r.get<wta::types::PlatformId>();
+            f.weapon = wta::core::weapon_names().intern(r.get_str());
+            e.payload = f;
+            break;
+        }
+        default: {
+            wta::events::EntityKilledEvent k;
+            k.entity_id = r.get<wta::types::Id>();
+            k.is_platform = r.get<bool>();
+            e.payload = k;
+            break;
+        }
+    }
+}
+
+} // namespace wta::record
@@ -0,0 +1,114 @@
+#include "flight_recorder.hpp"
+#include "../world/world_sampler.hpp"
+#include "../net/solver_client.hpp"
+#include "../exec/executor.hpp"
+
+namespace wta::record {
+
+namespace {
+
+class RecordingSampler final : public wta::world::IWorldSampler {
+public:
+    RecordingSampler(wta::world::IWorldSampler& inner, FlightRecorder& rec) : inner_(inner), rec_(rec) {}
+
+    void sample(wta::proto::SolveRequest& io_req) override {
+        inner_.sample(io_req);
+        rec_.record_snapshot(io_req.timestamp, io_req.platforms, io_req.targets);
+    }
+    wta::world::SamplerStats stats() const override { return inner_.stats(); }
+    const wta::core::LatencyHistogram* lock_hold_time() const override { return inner_.lock_hold_time(); }
+
+private:
+    wta::world::IWorldSampler& inner_;
+    FlightRecorder& rec_;
+};
+
+class RecordingSolverClient final : public wta::net::ISolverClient {
+public:
+    RecordingSolverClient(wta::net::ISolverClient& inner, FlightRecorder& rec) : inner_(inner), rec_(rec) {}
+
+    bool report_status(const wta::proto::StatusReportEvent& event, std::chrono::milliseconds timeout) override {
+        return inner_.report_status(event, timeout);
+    }
+    bool report_killed(const wta::proto::EntityKilledEvent& event, std::chrono::milliseconds timeout) override {
+        return inner_.report_killed(event, timeout);
+    }
+    bool report_damage(const wta::proto::DamageEvent& event, std::chrono::milliseconds timeout) override {
+        return inner_.report_damage(event, timeout);
+    }
+    bool report_fired(const wta::proto::FiredEvent& event, std::chrono::milliseconds timeout) override {
+        return inner_.report_fired(event, timeout);
+    }
+    bool send_log(const wta::proto::LogMessage& log_msg, std::chrono::milliseconds timeout) override {
+        return inner_.send_log(log_msg, timeout);
+    }
+
+    bool request_plan(const wta::proto::PlanRequest& req,
+                      wta::proto::PlanResponse& out,
+                      std::chrono::milliseconds timeout) override {
+        rec_.record_plan_request(req);
+        const bool ok = inner_.request_plan(req, out, timeout);
+        // 失败也记录（status 为空），回放时对同一请求返回失败
+        if (!ok) out.status.clear();
+        rec_.record_plan_response(req, out);
+        return ok;
+    }
+
+    bool solve(const wta::proto::SolveRequest& req,
+               wta::proto::SolveResponse& out,
+               std::chrono::milliseconds timeout) override {
+        return inner_.solve(req, out, timeout);
+    }
+
+private:
+    wta::net::ISolverClient& inner_;
+    FlightRecorder& rec_;
+};
+
+class RecordingExecutor final : public wta::exec::IExecutor {
+public:
+    RecordingExecutor(wta::exec::IExecutor& inner, FlightRecorder& rec) : inner_(inner), rec_(rec) {}
+
+    void apply_assignment(const wta::proto::PlanResponse& resp) override {
+        rec_.record_exec_apply(resp);
+        inner_.apply_assignment(resp);
+    }
+
+    void tick() override { inner_.tick(); }
+    clock::time_point next_tick() const override { return inner_.next_tick(); }
+    void use_timer_wheel(wta::core::TimerWheel* wheel, std::function<void()> wake) override {
+        inner_.use_timer_wheel(wheel, std::move(wake));
+    }
+    void on_entity_killed(wta::types::Id entity_id, bool is_platform) override {
+        inner_.on_entity_killed(entity_id, is_platform);
+    }
+    wta::exec::PlanChangeStats plan_change_stats() const override { return inner_.plan_change_stats(); }
+    uint64_t plans_commanded() const override { return inner_.plans_commanded(); }
+    size_t reassign(const std::unordered_map<wta::types::PlatformId, wta::types::TargetId>& moves) override {
+        rec_.record_exec_reassign(moves);
+        return inner_.reassign(moves);
+    }
+
+private:
+    wta::exec::IExecutor& inner_;
+    FlightRecorder& rec_;
+};
+
+} // namespace
+
+std::unique_ptr<wta::world::IWorldSampler> make_recording_sampler(wta::world::IWorldSampler& inner,
+                                                                  FlightRecorder& recorder) {
+    return std::make_unique<RecordingSampler>(inner, recorder);
+}
+
+std::unique_ptr<wta::net::ISolverClient> make_recording_solver_client(wta::net::ISolverClient& inner,
+                                                                      FlightRecorder& recorder) {
+    return std::make_unique<RecordingSolverClient>(inner, recorder);
+}
+
+std::unique_ptr<wta::exec::IExecutor> make_recording_executor(wta::exec::IExecutor& inner,
+                                                              FlightRecorder& recorder) {
+    return std::make_unique<RecordingExecutor>(inner, recorder);
+}
+
+} // namespace wta::record
@@ -0,0 +1,218 @@
+#include "replay.hpp"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace wta::record {
+
+// ==================== ReplayWorldSampler ====================
+
+void ReplayWorldSampler::push(Snapshot snap) {
+    std::lock_guard<std::mutex> lk(m_);
+    latest_ = std::move(snap);
+}
+
+void ReplayWorldSampler::sample(wta::proto::SolveRequest& io_req) {
+    std::lock_guard<std::mutex> lk(m_);
+    io_req.platforms = latest_.platforms;
+    io_req.targets = latest_.targets;
+    samples_.fetch_add(1, std::memory_order_relaxed);
+}
+
+// ==================== ReplaySolverClient ====================
+
+void ReplaySolverClient::push_request(wta::proto::PlanRequest req) {
+    std::lock_guard<std::mutex> lk(m_);
+    requests_.push_back(std::move(req));
+}
+
+void ReplaySolverClient::push_response(PlanResponseRecord rec) {
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        responses_[rec.key.cluster_index].push_back(std::move(rec));
+    }
+    cv_.notify_all();
+}
+
+void ReplaySolverClient::finish() {
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        finished_ = true;
+    }
+    cv_.notify_all();
+}
+
+bool ReplaySolverClient::report_status(const wta::proto::StatusReportEvent&, std::chrono::milliseconds) {
+    reports_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool ReplaySolverClient::report_killed(const wta::proto::EntityKilledEvent&, std::chrono::milliseconds) {
+    reports_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool ReplaySolverClient::report_damage(const wta::proto::DamageEvent&, std::chrono::milliseconds) {
+    reports_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool ReplaySolverClient::report_fired(const wta::proto::FiredEvent&, std::chrono::milliseconds) {
+    reports_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool ReplaySolverClient::request_plan(const wta::proto::PlanRequest& req,
+                                      wta::proto::PlanResponse& out,
+                                      std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lk(m_);
+    auto& queue = responses_[static_cast<int32_t>(req.cluster_index)];
+    if (!cv_.wait_for(lk, timeout, [&]{ return !queue.empty() || finished_; })) return false;
+    if (queue.empty()) return false;
+    auto it = std::find_if(queue.begin(), queue.end(), [&](const PlanResponseRecord& r) {
+        return r.key.snapshot_version == req.snapshot_version;
+    });
+    if (it == queue.end()) it = queue.begin();
+    out = std::move(it->resp);
+    queue.erase(it);
+    plans_served_.fetch_add(1, std::memory_order_relaxed);
+    // 录制时失败的请求以空 status 记录
+    return !out.status.empty();
+}
+
+std::vector<wta::proto::PlanRequest> ReplaySolverClient::recorded_requests() const {
+    std::lock_guard<std::mutex> lk(m_);
+    return requests_;
+}
+
+// ==================== ReplayExecutor ====================
+
+void ReplayExecutor::apply_assignment(const wta::proto::PlanResponse& resp) {
+    std::lock_guard<std::mutex> lk(m_);
+    applied_.push_back(resp);
+}
+
+size_t ReplayExecutor::reassign(const std::unordered_map<wta::types::PlatformId, wta::types::TargetId>& moves) {
+    auto cmd = make_exec_reassign(moves);
+    std::lock_guard<std::mutex> lk(m_);
+    reassigned_.push_back(std::move(cmd));
+    // 回放执行器没有任务状态，视为全部改派成功
+    return moves.size();
+}
+
+void ReplayExecutor::push_recorded_reassign(ExecReassign cmd) {
+    std::lock_guard<std::mutex> lk(m_);
+    recorded_reassigns_.push_back(std::move(cmd));
+}
+
+std::vector<ExecReassign> ReplayExecutor::reassigned() const {
+    std::lock_guard<std::mutex> lk(m_);
+    return reassigned_;
+}
+
+std::vector<ExecReassign> ReplayExecutor::recorded_reassigns() const {
+    std::lock_guard<std::mutex> lk(m_);
+    return recorded_reassigns_;
+}
+
+void ReplayExecutor::push_recorded(ExecCommand cmd) {
+    std::lock_guard<std::mutex> lk(m_);
+    recorded_.push_back(std::move(cmd));
+}
+
+std::vector<wta::proto::PlanResponse> ReplayExecutor::applied() const {
+    std::lock_guard<std::mutex> lk(m_);
+    return applied_;
+}
+
+std::vector<ExecCommand> ReplayExecutor::recorded() const {
+    std::lock_guard<std::mutex> lk(m_);
+    return recorded_;
+}
+
+// ==================== ReplayDriver ====================
+
+ReplayDriver::ReplayDriver(RecordingReader& reader, ReplayOptions opts)
+: reader_(reader), opts_(opts) {}
+
+ReplayStats ReplayDriver::run(wta::events::EventBus* bus, const std::atomic<bool>* stop) {
+    using clock = std::chrono::steady_clock;
+    ReplayStats st{};
+
+    if (opts_.start_time >= 0.0) {
+        reader_.seek(opts_.start_time);
+    } else {
+        reader_.rewind();
+    }
+
+    bool first = true;
+    double rec_origin = 0.0;
+    auto wall_origin = clock::now();
+
+    RecordView view;
+    while ((!stop || !stop->load()) && reader_.next(view)) {
+        if (first) {
+            rec_origin = view.timestamp;
+            wall_origin = clock::now();
+            first = false;
+        }
+        if (opts_.speed > 0.0) {
+            const double offset = (view.timestamp - rec_origin) / opts_.speed;
+            std::this_thread::sleep_until(wall_origin + std::chrono::duration_cast<clock::duration>(
+                std::chrono::duration<double>(offset)));
+        }
+
+        ++st.records;
+        switch (view.kind) {
+            case RecordKind::Snapshot: {
+                Snapshot snap;
+                if (!decode_record(view, snap)) { ++st.decode_errors; break; }
+                sampler_.push(std::move(snap));
+                ++st.snapshots;
+                break;
+            }
+            case RecordKind::BusEvent: {
+                wta::events::Event ev{};
+                if (!decode_record(view, ev)) { ++st.decode_errors; break; }
+                if (bus) bus->publish(ev);
+                ++st.events;
+                break;
+            }
+            case RecordKind::PlanRequest: {
+                wta::proto::PlanRequest req;
+                if (!decode_record(view, req)) { ++st.decode_errors; break; }
+                solver_.push_request(std::move(req));
+                ++st.plan_requests;
+                break;
+            }
+            case RecordKind::PlanResponse: {
+                PlanResponseRecord rec;
+                if (!decode_record(view, rec)) { ++st.decode_errors; break; }
+                solver_.push_response(std::move(rec));
+                ++st.plan_responses;
+                break;
+            }
+            case RecordKind::ExecApply: {
+                ExecCommand cmd;
+                if (!decode_record(view, cmd)) { ++st.decode_errors; break; }
+                executor_.push_recorded(std::move(cmd));
+                ++st.exec_applies;
+                break;
+            }
+            case RecordKind::ExecReassign: {
+                ExecReassign cmd;
+                if (!decode_record(view, cmd)) { ++st.decode_errors; break; }
+                executor_.push_recorded_reassign(std::move(cmd));
+                ++st.exec_reassigns;
+                break;
+            }
+            default:
+                ++st.decode_errors;
+                break;
+        }
+    }
+    solver_.finish();
+    return st;
+}
+
+} // namespace wta::record
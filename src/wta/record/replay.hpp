@@ -0,0 +1,142 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include "flight_recorder.hpp"
+#include "../world/world_sampler.hpp"
+#include "../net/solver_client.hpp"
+#include "../exec/executor.hpp"
+
+namespace wta::record {
+
+/**
+ * @brief 回放采样器 - sample() 返回回放进度中最近一次录制的快照
+ */
+class ReplayWorldSampler final : public wta::world::IWorldSampler {
+public:
+    void push(Snapshot snap);
+    void sample(wta::proto::SolveRequest& io_req) override;
+    uint64_t samples() const { return samples_.load(std::memory_order_relaxed); }
+
+private:
+    mutable std::mutex m_;
+    Snapshot latest_;
+    std::atomic<uint64_t> samples_{0};
+};
+
+/**
+ * @brief 回放求解器 - request_plan() 返回同一请求录制的响应（等待回放进度送达）
+ *
+ * 按簇序号分队列，队列内优先取快照版本相同的响应，否则按录制顺序取最早的一条。
+ * 分区求解的各簇请求并行在途，不能按全局先后顺序匹配。
+ */
+class ReplaySolverClient final : public wta::net::ISolverClient {
+public:
+    void push_request(wta::proto::PlanRequest req);
+    void push_response(PlanResponseRecord rec);
+    // 回放结束：唤醒等待中的 request_plan
+    void finish();
+
+    bool report_status(const wta::proto::StatusReportEvent&, std::chrono::milliseconds) override;
+    bool report_killed(const wta::proto::EntityKilledEvent&, std::chrono::milliseconds) override;
+    bool report_damage(const wta::proto::DamageEvent&, std::chrono::milliseconds) override;
+    bool report_fired(const wta::proto::FiredEvent&, std::chrono::milliseconds) override;
+    bool send_log(const wta::proto::LogMessage&, std::chrono::milliseconds) override { return true; }
+    bool request_plan(const wta::proto::PlanRequest& req,
+                      wta::proto::PlanResponse& out,
+                      std::chrono::milliseconds timeout) override;
+    bool solve(const wta::proto::SolveRequest&, wta::proto::SolveResponse&, std::chrono::milliseconds) override {
+        return false;
+    }
+
+    uint64_t plans_served() const { return plans_served_.load(std::memory_order_relaxed); }
+    uint64_t reports() const { return reports_.load(std::memory_order_relaxed); }
+    // 录制中的规划请求（用于与回放时实际发出的请求对比）
+    std::vector<wta::proto::PlanRequest> recorded_requests() const;
+
+private:
+    mutable std::mutex m_;
+    std::condition_variable cv_;
+    std::unordered_map<int32_t, std::deque<PlanResponseRecord>> responses_;   // 簇序号 -> 响应
+    std::vector<wta::proto::PlanRequest> requests_;
+    bool finished_{false};
+    std::atomic<uint64_t> plans_served_{0};
+    std::atomic<uint64_t> reports_{0};
+};
+
+/**
+ * @brief 回放执行器 - 记录收到的分配和本地改派，供与录制的执行指令对比
+ */
+class ReplayExecutor final : public wta::exec::IExecutor {
+public:
+    void apply_assignment(const wta::proto::PlanResponse& resp) override;
+    void tick() override { ticks_.fetch_add(1, std::memory_order_relaxed); }
+    size_t reassign(const std::unordered_map<wta::types::PlatformId, wta::types::TargetId>& moves) override;
+    // 回放执行器没有状态机，只需在新分配到达时 tick
+    clock::time_point next_tick() const override { return clock::time_point::max(); }
+
+    void push_recorded(ExecCommand cmd);
+    void push_recorded_reassign(ExecReassign cmd);
+    std::vector<wta::proto::PlanResponse> applied() const;
+    std::vector<ExecCommand> recorded() const;
+    // 回放时实际收到的改派（按平台排序）与录制的改派
+    std::vector<ExecReassign> reassigned() const;
+    std::vector<ExecReassign> recorded_reassigns() const;
+    uint64_t ticks() const { return ticks_.load(std::memory_order_relaxed); }
+
+private:
+    mutable std::mutex m_;
+    std::vector<wta::proto::PlanResponse> applied_;
+    std::vector<ExecCommand> recorded_;
+    std::vector<ExecReassign> reassigned_;
+    std::vector<ExecReassign> recorded_reassigns_;
+    std::atomic<uint64_t> ticks_{0};
+};
+
+struct ReplayOptions {
+    double speed{1.0};          // 回放倍速；<= 0 表示不等待，尽可能快
+    double start_time{-1.0};    // >= 0 时从该录制时间开始（使用时间索引定位）
+};
+
+struct ReplayStats {
+    uint64_t records{0};
+    uint64_t snapshots{0};
+    uint64_t events{0};
+    uint64_t plan_requests{0};
+    uint64_t plan_responses{0};
+    uint64_t exec_applies{0};
+    uint64_t exec_reassigns{0};
+    uint64_t decode_errors{0};
+};
+
+/**
+ * @brief 回放驱动 - 按录制时间把记录送入假采样器/求解器/执行器和事件总线
+ *
+ * 可以把 sampler()/solver()/executor() 交给真实的 Orchestrator，重现当时的决策过程。
+ */
+class ReplayDriver {
+public:
+    ReplayDriver(RecordingReader& reader, ReplayOptions opts = {});
+
+    ReplayWorldSampler& sampler() { return sampler_; }
+    ReplaySolverClient& solver() { return solver_; }
+    ReplayExecutor& executor() { return executor_; }
+
+    /**
+     * @brief 回放到结束（或 stop 被置位）
+     * @param bus 非空时把录制的事件重新发布到总线
+     */
+    ReplayStats run(wta::events::EventBus* bus = nullptr, const std::atomic<bool>* stop = nullptr);
+
+private:
+    RecordingReader& reader_;
+    ReplayOptions opts_;
+    ReplayWorldSampler sampler_;
+    ReplaySolverClient solver_;
+    ReplayExecutor executor_;
+};
+
+} // namespace wta::record
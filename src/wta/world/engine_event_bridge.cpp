@@ -0,0 +1,200 @@
+#include "engine_event_bridge.hpp"
+#include <intercept.hpp>
+#include <chrono>
+#include <cstring>
+#include "../core/damage_levels.hpp"
+
+namespace wta::world {
+
+using namespace intercept;
+using wta::events::EventType;
+
+namespace {
+
+double now_sec() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}// namespace
+
+/**
+ * @brief 已登记实体：ID 可随采样刷新，处理器句柄析构时自动移除事件处理器
+ */
+struct EngineEventBridge::Tracked {
+    std::atomic<wta::types::Id> id{0};
+    std::atomic<bool> is_platform{false};
+    std::atomic<bool> dead{false};
+    std::atomic<uint32_t> fired{0};   // Fired 处理器累计次数
+    wta::core::DamageLevels damage_levels;   // 只在引擎线程（Dammaged 处理器）中更新
+    uint64_t last_pass{0};
+
+    client::EHIdentifierHandle killed_eh;
+    client::EHIdentifierHandle damaged_eh;
+    client::EHIdentifierHandle fired_eh;
+};
+
+EngineEventBridge::EngineEventBridge(wta::events::EventBus& bus, size_t ring_capacity)
+: bus_(bus), ring_(ring_capacity) {}
+
+EngineEventBridge::~EngineEventBridge() {
+    stop();
+    // 注意：处理器应已在引擎线程上通过 untrack_all() 移除
+    std::lock_guard<std::mutex> lk(tracked_m_);
+    tracked_.clear();
+}
+
+void EngineEventBridge::start() {
+    if (running_.exchange(true)) return;
+    th_pump_ = std::thread(&EngineEventBridge::pump_loop, this);
+}
+
+void EngineEventBridge::stop() {
+    if (!running_.exchange(false)) return;
+    pump_cv_.notify_all();
+    if (th_pump_.joinable()) th_pump_.join();
+}
+
+void EngineEventBridge::track(const object& obj, wta::types::Id id, bool is_platform) {
+    track(obj, sqf::net_id(obj), id, is_platform);
+}
+
+uint32_t EngineEventBridge::track(const object& obj, const std::string& net_id, wta::types::Id id,
+                                  bool is_platform) {
+    std::lock_guard<std::mutex> lk(tracked_m_);
+    auto& slot = tracked_[net_id];
+    if (!slot) {
+        slot = std::make_unique<Tracked>();
+        Tracked* t = slot.get();
+        // 部位伤害槽按载具的部位数在此一次分配（invoker_lock 内），Dammaged 回调中不再分配
+        t->damage_levels = wta::core::DamageLevels(sqf::get_all_hit_points_damage(obj).damages.size());
+
+        // 处理器运行在引擎线程：只读原子字段、写环形队列，不分配
+        t->killed_eh = client::addEventHandler<client::eventhandlers_object::Killed>(
+            obj,
+            [this, t](object /*unit*/, object /*killer*/, object /*instigator*/, bool /*use_effects*/) {
+                t->dead.store(true, std::memory_order_relaxed);
+                EngineEventRecord rec{};
+                rec.type        = EventType::EntityKilled;
+                rec.entity_id   = t->id.load(std::memory_order_relaxed);
+                rec.is_platform = t->is_platform.load(std::memory_order_relaxed);
+                rec.timestamp   = now_sec();
+                enqueue(rec);
+            });
+
+        // 使用 Dammaged 而非 HandleDamage：只观察伤害，不改写引擎的伤害结果
+        t->damaged_eh = client::addEventHandler<client::eventhandlers_object::Dammaged>(
+            obj,
+            [this, t](object /*unit*/, r_string /*selection*/, float damage, float hit_index,
+                      r_string /*hit_point*/, object /*shooter*/, object /*projectile*/) {
+                // damage 是该部位的新伤害等级，只上报相对上一次的增量
+                const float delta = t->damage_levels.on_level(static_cast<int>(hit_index), damage);
+                if (delta <= 0.f) return;
+                EngineEventRecord rec{};
+                rec.type        = EventType::HandleDamage;
+                rec.entity_id   = t->id.load(std::memory_order_relaxed);
+                rec.is_platform = t->is_platform.load(std::memory_order_relaxed);
+                rec.damage      = delta;
+                rec.timestamp   = now_sec();
+                enqueue(rec);
+            });
+
+        if (is_platform) {
+            t->fired_eh = client::addEventHandler<client::eventhandlers_object::Fired>(
+                obj,
+                [this, t](object /*unit*/, r_string weapon, r_string /*muzzle*/, r_string /*mode*/,
+                          r_string /*ammo*/, r_string /*magazine*/, object /*projectile*/, object /*gunner*/) {
+                    t->fired.fetch_add(1, std::memory_order_relaxed);
+                    EngineEventRecord rec{};
+                    rec.type        = EventType::Fired;
+                    rec.entity_id   = t->id.load(std::memory_order_relaxed);
+                    rec.is_platform = true;
+                    rec.timestamp   = now_sec();
+                    // 只拷贝到定长缓冲区；驻留（加锁、可能分配）留给泵线程
+                    std::strncpy(rec.weapon, weapon.c_str(), sizeof(rec.weapon) - 1);
+                    enqueue(rec);
+                });
+        }
+    }
+
+    slot->id.store(id, std::memory_order_relaxed);
+    slot->is_platform.store(is_platform, std::memory_order_relaxed);
+    slot->last_pass = pass_;
+    return slot->fired.load(std::memory_order_relaxed);
+}
+
+void EngineEventBridge::end_pass() {
+    std::lock_guard<std::mutex> lk(tracked_m_);
+    for (auto it = tracked_.begin(); it != tracked_.end();) {
+        const auto& t = it->second;
+        if (t->last_pass != pass_ || t->dead.load(std::memory_order_relaxed)) {
+            it = tracked_.erase(it);  // 句柄析构即移除事件处理器
+        } else {
+            ++it;
+        }
+    }
+    ++pass_;
+}
+
+void EngineEventBridge::untrack_all() {
+    std::lock_guard<std::mutex> lk(tracked_m_);
+    tracked_.clear();
+}
+
+size_t EngineEventBridge::tracked_count() const {
+    std::lock_guard<std::mutex> lk(tracked_m_);
+    return tracked_.size();
+}
+
+void EngineEventBridge::enqueue(const EngineEventRecord& rec) {
+    if (!ring_.try_push(rec)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    pump_cv_.notify_one();
+}
+
+void EngineEventBridge::pump_loop() {
+    using namespace std::chrono_literals;
+    while (running_) {
+        if (pump_once() == 0) {
+            // 通知可能在进入等待前到达，超时兜底保证最多延迟 5ms
+            std::unique_lock<std::mutex> lk(pump_m_);
+            pump_cv_.wait_for(lk, 5ms);
+        }
+    }
+    pump_once();
+}
+
+size_t EngineEventBridge::pump_once() {
+    size_t n = 0;
+    EngineEventRecord rec{};
+    while (ring_.try_pop(rec)) {
+        wta::events::Event ev{};
+        ev.type      = rec.type;
+        ev.timestamp = rec.timestamp;
+        switch (rec.type) {
+            case EventType::EntityKilled:
+                ev.payload = wta::events::EntityKilledEvent{rec.entity_id, rec.is_platform};
+                break;
+            case EventType::HandleDamage:
+                ev.payload = wta::events::DamageEvent{rec.entity_id, rec.damage, rec.is_platform};
+                break;
+            case EventType::Fired:
+                // 武器名只在首次出现时驻留分配，之后按 string_view 查表
+                ev.payload = wta::events::FiredEvent{rec.entity_id, wta::core::weapon_names().intern(rec.weapon)};
+                break;
+            default:
+                continue;
+        }
+        bus_.publish(ev);
+        ++n;
+    }
+    published_.fetch_add(n, std::memory_order_relaxed);
+    return n;
+}
+
+std::unique_ptr<EngineEventBridge> make_engine_event_bridge(wta::events::EventBus& bus) {
+    return std::make_unique<EngineEventBridge>(bus);
+}
+
+}// namespace wta::world
@@ -0,0 +1,111 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include "event_bus.hpp"
+#include "../core/mpsc_ring.hpp"
+
+// 前向声明 intercept 类型
+namespace intercept::types {
+    class object;
+}
+
+namespace wta::world {
+
+/**
+ * @brief 引擎回调投递的紧凑事件（定长、可平凡拷贝）
+ *
+ * 武器名按值拷贝进定长缓冲区（超长截断），由泵线程驻留，引擎线程不接触驻留表。
+ */
+struct EngineEventRecord {
+    static constexpr size_t kWeaponNameMax = 64;
+
+    wta::events::EventType type{wta::events::EventType::MissionEachFrame};
+    bool                   is_platform{false};
+    wta::types::Id         entity_id{0};
+    float                  damage{0.f};    // 伤害增量（非部位伤害等级）
+    double                 timestamp{0.0};
+    char                   weapon[kWeaponNameMax]{};   // 以 '\0' 结尾
+};
+
+/**
+ * @brief 引擎事件桥 - 在采样到的平台/目标上注册 Intercept 事件处理器
+ *
+ * - Killed / Dammaged / Fired 处理器运行在引擎线程，只向无锁环形队列写入
+ *   EngineEventRecord，不分配内存、不加锁
+ * - 泵线程把环形队列中的记录发布到 EventBus（分配发生在引擎线程之外）
+ * - 采样器每轮调用 track() 登记实体，end_pass() 移除本轮未出现或已死亡的实体
+ */
+class EngineEventBridge {
+public:
+    explicit EngineEventBridge(wta::events::EventBus& bus, size_t ring_capacity = 4096);
+    ~EngineEventBridge();
+
+    EngineEventBridge(const EngineEventBridge&)            = delete;
+    EngineEventBridge& operator=(const EngineEventBridge&) = delete;
+
+    void start();
+    void stop();
+
+    /**
+     * @brief 登记（或刷新）一个实体并确保其事件处理器已注册
+     * @note 必须在 invoker_lock 内调用（例如采样循环中）
+     */
+    void track(const intercept::types::object& obj, wta::types::Id id, bool is_platform);
+
+    /**
+     * @brief 同上，调用方已取得 netId 时使用（省去一次 SQF 调用）
+     * @return 该实体累计的开火次数（仅平台注册 Fired 处理器，目标恒为 0），
+     *         采样器据此判断弹药是否需要重新查询
+     * @note 必须在 invoker_lock 内调用
+     */
+    uint32_t track(const intercept::types::object& obj, const std::string& net_id, wta::types::Id id,
+                   bool is_platform);
+
+    /**
+     * @brief 结束一轮采样：移除本轮未登记或已死亡实体的处理器
+     * @note 必须在 invoker_lock 内调用
+     */
+    void end_pass();
+
+    /**
+     * @brief 移除所有处理器（任务结束时调用）
+     * @note 必须在 invoker_lock 内或引擎线程上调用
+     */
+    void untrack_all();
+
+    size_t   tracked_count() const;
+    uint64_t published() const { return published_.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    struct Tracked;
+
+    // 引擎线程调用：写入环形队列并唤醒泵线程
+    void enqueue(const EngineEventRecord& rec);
+    void pump_loop();
+    size_t pump_once();
+
+    wta::events::EventBus& bus_;
+    wta::core::MpscRing<EngineEventRecord> ring_;
+
+    mutable std::mutex tracked_m_;
+    std::unordered_map<std::string, std::unique_ptr<Tracked>> tracked_;  // netId -> 实体
+    uint64_t pass_{0};
+
+    std::atomic<bool> running_{false};
+    std::thread th_pump_;
+    std::mutex pump_m_;
+    std::condition_variable pump_cv_;
+
+    std::atomic<uint64_t> published_{0};
+    std::atomic<uint64_t> dropped_{0};
+};
+
+std::unique_ptr<EngineEventBridge> make_engine_event_bridge(wta::events::EventBus& bus);
+
+}// namespace wta::world
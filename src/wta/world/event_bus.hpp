@@ -1,10 +1,20 @@
 #pragma once
 #include <mutex>
+#include <shared_mutex>
 #include <deque>
 #include <condition_variable>
 #include <variant>
-#include <string>
+#include <array>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <atomic>
+#include <algorithm>
+#include <initializer_list>
+#include <unordered_map>
+#include <chrono>
 #include "../core/types.hpp"
+#include "../core/string_intern.hpp"
 
 namespace wta::events {
 
@@ -13,12 +23,17 @@ enum class EventType : uint8_t {
     EntityKilled,
     HandleDamage,
     Fired,
-    ReplanRequest
+    ReplanRequest,
+    Count           // 仅用于计数，不是真实事件类型
 };
 
+constexpr size_t kEventTypeCount = static_cast<size_t>(EventType::Count);
+
 struct EntityKilledEvent { wta::types::Id entity_id{0}; bool is_platform{false}; };
+// damage 为本次新增的伤害量（引擎桥已把部位伤害等级换算为增量），合并时可直接累加
 struct DamageEvent { wta::types::Id entity_id{0}; float damage{0.f}; bool is_platform{false}; };
-struct FiredEvent { wta::types::PlatformId platform_id{0}; std::string weapon; };
+// weapon 为 wta::core::weapon_names() 中的驻留ID，事件本身不持有字符串
+struct FiredEvent { wta::types::PlatformId platform_id{0}; wta::core::InternId weapon{wta::core::kInvalidInternId}; };
 
 using EventPayload = std::variant<EntityKilledEvent, DamageEvent, FiredEvent>;
 
@@ -28,33 +43,401 @@ struct Event {
     double timestamp{0.0};
 };
 
-class EventBus {
+// 事件在发布时只构造一次，之后以引用计数指针扇出给所有订阅者（不拷贝负载）
+using EventPtr = std::shared_ptr<const Event>;
+
+// 订阅过滤器：返回 true 表示该订阅者接收此事件
+using EventFilter = std::function<bool(const Event&)>;
+
+// 总线旁路观察者：在发布线程上同步调用（用于飞行记录等），必须足够轻量且不能再发布事件
+using EventTap = std::function<void(const Event&)>;
+
+/**
+ * @brief 事件合并规则（在订阅队列内生效，只作用于尚未被消费的事件）
+ *
+ * - 同一实体在窗口内的多次伤害合并为一条，伤害值累加，保留最早时间戳
+ * - 击毁事件会撤销该实体尚未消费的伤害事件
+ * - 队列中已有 ReplanRequest 时，新的 ReplanRequest 直接折叠
+ */
+struct CoalescePolicy {
+    bool   enabled{true};
+    double damage_window_sec{0.05};
+    bool   kill_supersedes_damage{true};
+    bool   collapse_replan{true};
+};
+
+/**
+ * @brief 总线计数器（各订阅者之和）
+ */
+struct BusStats {
+    uint64_t published{0};
+    uint64_t delivered{0};          // 实际入队的事件数
+    uint64_t dropped{0};            // 队列满丢弃
+    uint64_t merged_damage{0};      // 合并进已有伤害事件
+    uint64_t superseded_damage{0};  // 被击毁事件撤销的伤害事件
+    uint64_t collapsed_replan{0};   // 折叠的重规划请求
+
+    uint64_t coalesced() const { return merged_damage + superseded_damage + collapsed_replan; }
+};
+
+/**
+ * @brief 事件订阅 - 每个订阅者拥有独立队列
+ *
+ * 由 EventBus::subscribe 创建，只接收注册过的 EventType（可附加过滤器）。
+ * 队列有容量上限，满时丢弃最旧事件并计数，避免慢消费者拖垮发布者。
+ * 入队时按 CoalescePolicy 合并重复事实，消费端工作量与不同事实数成正比。
+ */
+class Subscription {
 public:
-    void publish(Event e) {
-        {
-            std::lock_guard<std::mutex> lk(m_);
-            q_.push_back(std::move(e));
+    static constexpr size_t kDefaultCapacity = 1024;
+
+    Subscription(std::initializer_list<EventType> types,
+                 EventFilter filter,
+                 size_t capacity,
+                 CoalescePolicy policy = {})
+    : filter_(std::move(filter)), capacity_(capacity), policy_(policy) {
+        topics_.fill(false);
+        for (auto t : types) {
+            if (t != EventType::Count) topics_[static_cast<size_t>(t)] = true;
         }
-        cv_.notify_one();
     }
-    bool try_pop(Event& out) {
+
+    bool try_pop(EventPtr& out) {
         std::lock_guard<std::mutex> lk(m_);
-        if (q_.empty()) return false;
-        out = std::move(q_.front());
-        q_.pop_front();
+        if (live_ == 0) return false;
+        out = pop_front_locked();
         return true;
     }
-    Event wait_and_pop() {
+
+    // 阻塞直到有事件；订阅被关闭且队列为空时返回 nullptr
+    EventPtr wait_and_pop() {
         std::unique_lock<std::mutex> lk(m_);
-        cv_.wait(lk, [&]{ return !q_.empty(); });
-        Event e = std::move(q_.front());
-        q_.pop_front();
-        return e;
+        cv_.wait(lk, [&]{ return live_ > 0 || closed_; });
+        if (live_ == 0) return nullptr;
+        return pop_front_locked();
     }
+
+    /**
+     * @brief 一次加锁取走积压的事件批次
+     * @param out 追加输出（不会清空已有内容）
+     * @param max 最多取出的数量，0 表示全部（直接交换整个队列）
+     * @return 取出的事件数量
+     */
+    size_t drain_into(std::vector<EventPtr>& out, size_t max = 0) {
+        std::deque<EventPtr> batch;
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            if (live_ == 0) return 0;
+            if (max == 0 || max >= live_) {
+                head_seq_ += q_.size();
+                batch.swap(q_);
+                pending_damage_.clear();
+                replan_pending_ = false;
+                live_ = 0;
+            } else {
+                for (size_t i = 0; i < max; ++i) batch.push_back(pop_front_locked());
+            }
+        }
+        const size_t before = out.size();
+        for (auto& e : batch) {
+            if (e) out.push_back(std::move(e));
+        }
+        return out.size() - before;
+    }
+
+    // 等待直到有事件、被 wake()、超时或订阅关闭；返回是否有待处理事件
+    template <class Rep, class Period>
+    bool wait_for(const std::chrono::duration<Rep, Period>& timeout) {
+        std::unique_lock<std::mutex> lk(m_);
+        cv_.wait_for(lk, timeout, [&]{ return ready_locked(); });
+        woken_ = false;
+        return live_ > 0;
+    }
+
+    template <class Clock, class Duration>
+    bool wait_until(const std::chrono::time_point<Clock, Duration>& deadline) {
+        std::unique_lock<std::mutex> lk(m_);
+        cv_.wait_until(lk, deadline, [&]{ return ready_locked(); });
+        woken_ = false;
+        return live_ > 0;
+    }
+
+    // 无超时等待：仅由事件、wake() 或 close() 唤醒
+    bool wait() {
+        std::unique_lock<std::mutex> lk(m_);
+        cv_.wait(lk, [&]{ return ready_locked(); });
+        woken_ = false;
+        return live_ > 0;
+    }
+
+    // 不投递事件而唤醒一次等待者（定时器到期等场景）；无人等待时保留到下一次 wait
+    void wake() {
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            woken_ = true;
+        }
+        cv_.notify_all();
+    }
+
+    // 关闭订阅：唤醒所有等待者，之后不再接收新事件（已入队事件仍可取出）
+    void close() {
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            closed_ = true;
+        }
+        cv_.notify_all();
+    }
+
+    bool closed() const {
+        std::lock_guard<std::mutex> lk(m_);
+        return closed_;
+    }
+
+    size_t pending() const {
+        std::lock_guard<std::mutex> lk(m_);
+        return live_;
+    }
+
+    bool subscribed_to(EventType t) const {
+        return t != EventType::Count && topics_[static_cast<size_t>(t)];
+    }
+
+    uint64_t delivered() const { return delivered_.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    uint64_t merged_damage() const { return merged_damage_.load(std::memory_order_relaxed); }
+    uint64_t superseded_damage() const { return superseded_damage_.load(std::memory_order_relaxed); }
+    uint64_t collapsed_replan() const { return collapsed_replan_.load(std::memory_order_relaxed); }
+
 private:
-    std::mutex m_;
-    std::deque<Event> q_;
+    friend class EventBus;
+
+    static uint64_t entity_key(wta::types::Id id, bool is_platform) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(id)) << 1) | (is_platform ? 1u : 0u);
+    }
+
+    // 由 EventBus 在发布时调用（已按主题筛选）
+    void push(const EventPtr& e) {
+        if (filter_ && !filter_(*e)) return;
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            if (closed_) return;
+            if (policy_.enabled && coalesce_locked(e)) return;
+            if (capacity_ > 0 && live_ >= capacity_) {
+                pop_front_locked();
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+            }
+            index_locked(*e, head_seq_ + q_.size());
+            q_.push_back(e);
+            ++live_;
+        }
+        delivered_.fetch_add(1, std::memory_order_relaxed);
+        cv_.notify_one();
+    }
+
+    // 尝试把事件并入队列中尚未消费的事件，返回 true 表示无需再入队
+    bool coalesce_locked(const EventPtr& e) {
+        switch (e->type) {
+            case EventType::HandleDamage: {
+                const auto& dmg = std::get<DamageEvent>(e->payload);
+                auto it = pending_damage_.find(entity_key(dmg.entity_id, dmg.is_platform));
+                if (it == pending_damage_.end()) return false;
+                // 只并入该实体最近的一条（更早的已超出窗口）
+                auto& slot = q_[it->second.back() - head_seq_];
+                if (e->timestamp - slot->timestamp > policy_.damage_window_sec) return false;
+                auto merged = std::make_shared<Event>(*slot);
+                std::get<DamageEvent>(merged->payload).damage += dmg.damage;
+                slot = std::move(merged);
+                merged_damage_.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+            case EventType::EntityKilled: {
+                if (!policy_.kill_supersedes_damage) return false;
+                const auto& kill = std::get<EntityKilledEvent>(e->payload);
+                auto it = pending_damage_.find(entity_key(kill.entity_id, kill.is_platform));
+                if (it != pending_damage_.end()) {
+                    // 该实体所有未消费的伤害事件都被击毁取代，不只是窗口内的最近一条
+                    for (const uint64_t seq : it->second) {
+                        q_[seq - head_seq_].reset();  // 留空槽，出队时跳过
+                    }
+                    live_ -= it->second.size();
+                    superseded_damage_.fetch_add(it->second.size(), std::memory_order_relaxed);
+                    pending_damage_.erase(it);
+                }
+                return false;
+            }
+            case EventType::ReplanRequest:
+                if (policy_.collapse_replan && replan_pending_) {
+                    collapsed_replan_.fetch_add(1, std::memory_order_relaxed);
+                    return true;
+                }
+                return false;
+            default:
+                return false;
+        }
+    }
+
+    void index_locked(const Event& e, uint64_t seq) {
+        if (!policy_.enabled) return;
+        if (e.type == EventType::HandleDamage) {
+            const auto& dmg = std::get<DamageEvent>(e.payload);
+            pending_damage_[entity_key(dmg.entity_id, dmg.is_platform)].push_back(seq);
+        } else if (e.type == EventType::ReplanRequest) {
+            replan_pending_ = true;
+        }
+    }
+
+    void unindex_locked(const Event& e, uint64_t seq) {
+        if (e.type == EventType::HandleDamage) {
+            const auto& dmg = std::get<DamageEvent>(e.payload);
+            // 出队总是按序号从小到大，出队的就是该实体最早的一条
+            auto it = pending_damage_.find(entity_key(dmg.entity_id, dmg.is_platform));
+            if (it != pending_damage_.end() && !it->second.empty() && it->second.front() == seq) {
+                it->second.erase(it->second.begin());
+                if (it->second.empty()) pending_damage_.erase(it);
+            }
+        } else if (e.type == EventType::ReplanRequest) {
+            replan_pending_ = false;
+        }
+    }
+
+    bool ready_locked() const { return live_ > 0 || closed_ || woken_; }
+
+    // 要求 live_ > 0；跳过被撤销的空槽
+    EventPtr pop_front_locked() {
+        for (;;) {
+            EventPtr e = std::move(q_.front());
+            q_.pop_front();
+            const uint64_t seq = head_seq_++;
+            if (!e) continue;
+            unindex_locked(*e, seq);
+            --live_;
+            return e;
+        }
+    }
+
+    std::array<bool, kEventTypeCount> topics_{};
+    EventFilter filter_;
+    size_t capacity_;
+    CoalescePolicy policy_;
+
+    mutable std::mutex m_;
+    std::deque<EventPtr> q_;
     std::condition_variable cv_;
+    size_t live_{0};                 // 队列中非空槽数量
+    uint64_t head_seq_{0};           // q_.front() 的序号
+    std::unordered_map<uint64_t, std::vector<uint64_t>> pending_damage_;  // 实体 -> 未消费伤害事件序号（升序）
+    bool replan_pending_{false};
+    bool closed_{false};
+    bool woken_{false};
+
+    std::atomic<uint64_t> delivered_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> merged_damage_{0};
+    std::atomic<uint64_t> superseded_damage_{0};
+    std::atomic<uint64_t> collapsed_replan_{0};
+};
+
+using SubscriptionPtr = std::shared_ptr<Subscription>;
+
+/**
+ * @brief 主题式事件总线 - 多订阅者发布/订阅
+ *
+ * - subscribe() 按 EventType 注册，每个订阅者拥有独立队列，互不抢占
+ * - publish() 只分配一次事件对象，按主题索引扇出共享指针
+ * - 每个订阅队列按 CoalescePolicy 合并重复事件，stats() 汇总合并计数
+ * - close() 唤醒所有订阅者上的等待，用于关停时打断阻塞的消费线程
+ *
+ * 总线本身不持有队列：没有订阅者的事件发布后即丢弃，消费者必须显式 subscribe()。
+ */
+class EventBus {
+public:
+    explicit EventBus(CoalescePolicy policy = {}) : policy_(policy) {}
+
+    SubscriptionPtr subscribe(std::initializer_list<EventType> types,
+                              EventFilter filter = {},
+                              size_t capacity = Subscription::kDefaultCapacity) {
+        auto sub = std::make_shared<Subscription>(types, std::move(filter), capacity, policy_);
+        std::unique_lock<std::shared_mutex> lk(subs_m_);
+        if (closed_) sub->close();
+        for (size_t i = 0; i < kEventTypeCount; ++i) {
+            if (sub->topics_[i]) by_type_[i].push_back(sub);
+        }
+        return sub;
+    }
+
+    void unsubscribe(const SubscriptionPtr& sub) {
+        if (!sub) return;
+        std::unique_lock<std::shared_mutex> lk(subs_m_);
+        for (auto& list : by_type_) {
+            list.erase(std::remove(list.begin(), list.end(), sub), list.end());
+        }
+    }
+
+    void publish(Event e) {
+        const auto type_idx = static_cast<size_t>(e.type);
+        if (type_idx >= kEventTypeCount) return;
+        if (closed_.load(std::memory_order_acquire)) return;
+        auto ptr = std::make_shared<const Event>(std::move(e));
+        published_.fetch_add(1, std::memory_order_relaxed);
+        std::shared_lock<std::shared_mutex> lk(subs_m_);
+        if (tap_) tap_(*ptr);
+        for (const auto& sub : by_type_[type_idx]) {
+            sub->push(ptr);
+        }
+    }
+
+    // 设置（或用空函数清除）旁路观察者
+    void set_tap(EventTap tap) {
+        std::unique_lock<std::shared_mutex> lk(subs_m_);
+        tap_ = std::move(tap);
+    }
+
+    size_t subscriber_count(EventType t) const {
+        const auto type_idx = static_cast<size_t>(t);
+        if (type_idx >= kEventTypeCount) return 0;
+        std::shared_lock<std::shared_mutex> lk(subs_m_);
+        return by_type_[type_idx].size();
+    }
+
+    uint64_t published() const { return published_.load(std::memory_order_relaxed); }
+
+    BusStats stats() const {
+        BusStats st{};
+        st.published = published();
+        std::shared_lock<std::shared_mutex> lk(subs_m_);
+        std::vector<const Subscription*> seen;
+        for (const auto& list : by_type_) {
+            for (const auto& sub : list) {
+                if (std::find(seen.begin(), seen.end(), sub.get()) != seen.end()) continue;
+                seen.push_back(sub.get());
+                st.delivered += sub->delivered();
+                st.dropped += sub->dropped();
+                st.merged_damage += sub->merged_damage();
+                st.superseded_damage += sub->superseded_damage();
+                st.collapsed_replan += sub->collapsed_replan();
+            }
+        }
+        return st;
+    }
+
+    // 关闭总线：拒绝新事件并唤醒所有订阅上的等待者
+    void close() {
+        std::unique_lock<std::shared_mutex> lk(subs_m_);
+        closed_.store(true, std::memory_order_release);
+        for (const auto& list : by_type_) {
+            for (const auto& sub : list) sub->close();
+        }
+    }
+
+    bool closed() const { return closed_.load(std::memory_order_acquire); }
+
+private:
+    CoalescePolicy policy_;
+    mutable std::shared_mutex subs_m_;
+    std::array<std::vector<SubscriptionPtr>, kEventTypeCount> by_type_{};
+    EventTap tap_;
+    std::atomic<bool> closed_{false};
+    std::atomic<uint64_t> published_{0};
 };
 
 } // namespace wta::events
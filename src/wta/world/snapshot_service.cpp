@@ -0,0 +1,52 @@
+#include "snapshot_service.hpp"
+
+namespace wta::world {
+
+double SnapshotService::now_sec() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool SnapshotService::fresh_enough(const WorldSnapshotPtr& snap, double now, std::chrono::milliseconds max_age,
+                                   double not_before) {
+    if (!snap || snap->version == 0) return false;
+    // not_before 按采样开始比较（开始之后的事件不一定已反映）；年龄从采样完成算起，长时间分片采样不会刚完成就过期
+    if (not_before > 0.0 && snap->timestamp < not_before) return false;
+    const double sampled_at = snap->end_timestamp > 0.0 ? snap->end_timestamp : snap->timestamp;
+    return now - sampled_at <= std::chrono::duration<double>(max_age).count();
+}
+
+WorldSnapshotPtr SnapshotService::acquire(std::chrono::milliseconds max_age, double not_before) {
+    WorldSnapshotPtr snap = latest();
+    if (fresh_enough(snap, now_sec(), max_age, not_before)) {
+        reuses_.fetch_add(1, std::memory_order_relaxed);
+        return snap;
+    }
+
+    std::lock_guard<std::mutex> lk(sample_m_);
+    // 等锁期间其他线程可能刚发布了新快照，满足要求就直接复用
+    const double requested = now_sec();
+    snap = latest();
+    if (fresh_enough(snap, requested, max_age, not_before)) {
+        reuses_.fetch_add(1, std::memory_order_relaxed);
+        return snap;
+    }
+
+    wta::proto::SolveRequest req{};
+    req.timestamp = requested;
+    sampler_.sample(req);   // 内部持 invoker_lock（分片采样时多次短暂持锁）
+    const double finished = now_sec();
+    sample_time_.record_sec(finished - requested);
+
+    auto next = std::make_shared<WorldSnapshot>();
+    next->version = (snap ? snap->version : 0) + 1;
+    next->timestamp = requested;
+    next->end_timestamp = finished;
+    next->platforms = std::move(req.platforms);
+    next->targets = std::move(req.targets);
+    WorldSnapshotPtr published = std::move(next);
+    std::atomic_store(&current_, published);
+    samples_.fetch_add(1, std::memory_order_relaxed);
+    return published;
+}
+
+} // namespace wta::world
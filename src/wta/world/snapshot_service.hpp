@@ -0,0 +1,71 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "world_sampler.hpp"
+#include "../core/latency_histogram.hpp"
+
+namespace wta::world {
+
+/**
+ * @brief 不可变的世界快照（发布后只读，可被多个线程同时持有）
+ */
+struct WorldSnapshot {
+    uint64_t version{0};       // 单调递增，0 表示尚未采样
+    double timestamp{0.0};     // 采样开始时刻（steady 时钟秒）
+    double end_timestamp{0.0}; // 采样完成时刻；分片采样时实体状态分布在 [timestamp, end_timestamp] 内
+    std::vector<wta::types::PlatformState> platforms;
+    std::vector<wta::types::TargetState> targets;
+};
+using WorldSnapshotPtr = std::shared_ptr<const WorldSnapshot>;
+
+/**
+ * @brief 世界快照服务 - 统一采样并以 RCU 方式发布版本化快照
+ *
+ * 上报线程和规划线程不再各自调用 sampler.sample()：acquire() 先看当前快照是否足够新，
+ * 足够新就直接复用（无锁原子读 shared_ptr），否则由调用线程采样一次并原子替换。
+ * 多个线程同时要求刷新时只有一个线程进入引擎采样，其余线程等它发布后复用结果。
+ */
+class SnapshotService {
+public:
+    explicit SnapshotService(IWorldSampler& sampler) : sampler_(sampler) {}
+
+    /**
+     * @brief 当前发布的快照（可能为空快照，version == 0），无锁
+     */
+    WorldSnapshotPtr latest() const { return std::atomic_load(&current_); }
+
+    /**
+     * @brief 获取不早于要求的快照
+     * @param max_age 允许的最大年龄（从采样完成时刻算起）
+     * @param not_before 快照采样开始时刻不得早于该时间（例如触发重规划的事件时间戳）；<= 0 表示不限制
+     */
+    WorldSnapshotPtr acquire(std::chrono::milliseconds max_age, double not_before = 0.0);
+
+    // 强制采样一次并发布
+    WorldSnapshotPtr refresh() { return acquire(std::chrono::milliseconds(0), now_sec()); }
+
+    uint64_t samples() const { return samples_.load(std::memory_order_relaxed); }
+    uint64_t reuses() const { return reuses_.load(std::memory_order_relaxed); }
+    // 每次引擎采样的耗时（即 invoker_lock 持有时间的上界）
+    const wta::core::LatencyHistogram& sample_time() const { return sample_time_; }
+    SamplerStats sampler_stats() const { return sampler_.stats(); }
+    const wta::core::LatencyHistogram* sampler_lock_hold() const { return sampler_.lock_hold_time(); }
+
+    static double now_sec();
+
+private:
+    static bool fresh_enough(const WorldSnapshotPtr& snap, double now, std::chrono::milliseconds max_age,
+                             double not_before);
+
+    IWorldSampler& sampler_;
+    WorldSnapshotPtr current_{std::make_shared<const WorldSnapshot>()};
+    std::mutex sample_m_;   // 只串行化采样本身，读者不经过此锁
+    std::atomic<uint64_t> samples_{0};
+    std::atomic<uint64_t> reuses_{0};
+    wta::core::LatencyHistogram sample_time_;
+};
+
+} // namespace wta::world
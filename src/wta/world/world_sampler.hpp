@@ -1,14 +1,43 @@
 #pragma once
+#include <cstdint>
 #include <memory>
 #include "../core/solver_messages.hpp"
+#include "../core/latency_histogram.hpp"
 
 namespace wta::world {
 
+class EngineEventBridge;
+
+// 采样器的累计统计（静态属性缓存命中率、每次采样的引擎调用数）
+struct SamplerStats {
+	uint64_t samples{0};
+	uint64_t cache_hits{0};          // 静态属性直接取自缓存的实体次数
+	uint64_t cache_misses{0};        // 新实体或缓存过期，重新查询静态属性
+	uint64_t engine_calls{0};        // 累计 SQF 调用数（均在 invoker_lock 内）
+	uint32_t last_engine_calls{0};   // 最近一次采样的 SQF 调用数
+	size_t cached_objects{0};
+	uint32_t last_slices{0};         // 最近一次采样分几次持锁完成
+	uint64_t budget_overruns{0};     // 分片采样中超出持锁预算的次数
+
+	double hit_rate() const {
+		const uint64_t lookups = cache_hits + cache_misses;
+		return lookups ? static_cast<double>(cache_hits) / static_cast<double>(lookups) : 0.0;
+	}
+	double calls_per_sample() const {
+		return samples ? static_cast<double>(engine_calls) / static_cast<double>(samples) : 0.0;
+	}
+};
+
 struct IWorldSampler {
 	virtual ~IWorldSampler()                              = default;
 	virtual void sample(wta::proto::SolveRequest &io_req) = 0;
+	// 可在任意线程调用；不缓存的实现返回全零
+	virtual SamplerStats stats() const { return {}; }
+	// 每次持 invoker_lock 的时长；不持引擎锁的实现返回 nullptr
+	virtual const wta::core::LatencyHistogram *lock_hold_time() const { return nullptr; }
 };
 
-std::unique_ptr<IWorldSampler> make_intercept_world_sampler();
+// bridge 非空时，采样过程中会为每个平台/目标登记引擎事件处理器
+std::unique_ptr<IWorldSampler> make_intercept_world_sampler(EngineEventBridge *bridge = nullptr);
 
 }// namespace wta::world
@@ -1,10 +1,16 @@
 #include <intercept.hpp>
+#include <atomic>
 #include <string>
 #include <cstring>
 #include <chrono>
+#include <unordered_map>
+#include <vector>
 #include "../core/types.hpp"
+#include "../core/runtime_params.hpp"
+#include "../core/slice_budget.hpp"
 #include "world_sampler.hpp"
 #include "world_config.hpp"
+#include "engine_event_bridge.hpp"
 
 namespace wta::world {
 
@@ -135,221 +141,608 @@ float estimate_range(const wta::types::AmmoState& ammo) {
 	return 500.f;
 }
 
+// 静态属性的最长缓存时间（秒）：任务脚本可能稍后设置 wta_target_id、实体可能换阵营，过期后重新查询
+constexpr double kStaticAttrMaxAge = 30.0;
+
+double now_sec() {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 读取任务脚本指定的 wta_target_id；未设置或转换失败返回 -1（按采样顺序编号）
+int read_target_id(const object& obj) {
+	auto target_id_var = sqf::get_variable(obj, "wta_target_id");
+	try {
+		if (!target_id_var.is_nil()) {
+			float id_float = static_cast<float>(target_id_var);
+			return static_cast<int>(id_float);
+		}
+	} catch (...) {
+		// 忽略转换错误，使用默认ID
+	}
+	return -1;
+}
+
+// 实体的静态属性（按 netId 缓存）：阵营归类、类型、UAV 标记、指定 ID 与配置派生参数
+struct StaticAttrs {
+	enum class Category : uint8_t { Ignored, Platform, Target };
+
+	Category                  category{Category::Ignored};
+	std::string               type;
+	wta::types::TargetKind    kind{wta::types::TargetKind::Other};
+	int                       assigned_id{-1};
+	// 平台模板：id / 位置 / 油量 / 损伤之外的字段
+	wta::types::PlatformState plat{};
+	bool                      has_platform_config{false};
+	// 弹药只在开火后（或缓存过期时）重新查询
+	bool                      mags_valid{false};
+	uint32_t                  fired_seen{0};
+	std::string               side;           // 批量模式：上次归类时的阵营（str side）
+	double                    refreshed_at{0.0};
+	uint64_t                  last_pass{0};
+};
+
+// 批量采样的 SQF：一次调用遍历 vehicles 与 allUnits，返回扁平数组
+//   [玩家阵营, 载具数, 记录...]，每条记录 kBulkStride 个元素：
+//   [对象, netId, 阵营, 类型, 位置, 存活, 油量, 损伤, 是否 UAV, wta_target_id(-1 为未指定)]
+// 前「载具数」条记录为载具，其余为步兵
+constexpr const char* kBulkQuerySqf =
+	"private _out = [str side player, count vehicles];"
+	"{ _out append [_x, netId _x, str side _x, typeOf _x, getPos _x, alive _x, fuel _x, damage _x,"
+	" unitIsUAV _x, _x getVariable ['wta_target_id', -1]] } forEach vehicles;"
+	"{ _out append [_x, netId _x, str side _x, typeOf _x, getPos _x, alive _x, 0, damage _x,"
+	" false, _x getVariable ['wta_target_id', -1]] } forEach allUnits;"
+	"_out";
+constexpr size_t kBulkHeader = 2;
+constexpr size_t kBulkStride = 10;
+
+// 按阵营关系归类（纯 C++，两种采样模式共用）
+StaticAttrs::Category categorize(bool is_unit, bool friendly, bool civilian, bool is_uav) {
+	// 我方无人机 -> Platform
+	if (!is_unit && friendly && is_uav) return StaticAttrs::Category::Platform;
+	// 敌方载具/步兵 -> Target
+	if (!friendly && !civilian) return StaticAttrs::Category::Target;
+	return StaticAttrs::Category::Ignored;
+}
+
 class InterceptWorldSampler final : public IWorldSampler {
 public:
-	InterceptWorldSampler() {
+	explicit InterceptWorldSampler(EngineEventBridge *bridge) : bridge_(bridge) {
 		// 加载配置（只需加载一次）
 		config_.load_from_sqf();
+		// 批量查询只编译一次（构造在引擎线程上）
+		bulk_query_ = sqf::compile(kBulkQuerySqf);
+		bulk_ready_ = !bulk_query_.is_nil();
+		if (!bulk_ready_) sqf::diag_log("WTA Sampler: bulk query failed to compile, using per-entity sampling");
 	}
 	
 	void sample(wta::proto::SolveRequest &io_req) override
 	{
-		client::invoker_lock _lk;
-		
 		// 清空之前数据
 		io_req.platforms.clear();
 		io_req.targets.clear();
 		
-		// 获取玩家阵营
-		auto player = sqf::player();
-		auto player_side = sqf::get_side(player);
+		const double now = now_sec();
+		const int budget_us = wta::core::tunables().world_slice_budget_us.load(std::memory_order_relaxed);
+		if (budget_us > 0) {
+			sample_sliced(io_req, now, std::chrono::microseconds(budget_us));
+			return;
+		}
+		
+		uint32_t calls = 0;
+		const bool bulk = bulk_ready_ && wta::core::tunables().world_bulk_sample.load(std::memory_order_relaxed);
+		HeldLock _lk(lock_hold_);
+		switch_mode(bulk ? SampleMode::Bulk : SampleMode::PerEntity);
+		if (!bulk || !sample_bulk(io_req, now, calls)) sample_each(io_req, now, calls);
+		finish_pass(io_req, now, calls, 1);
+	}
+	
+	SamplerStats stats() const override
+	{
+		SamplerStats st{};
+		st.samples = samples_.load(std::memory_order_relaxed);
+		st.cache_hits = cache_hits_.load(std::memory_order_relaxed);
+		st.cache_misses = cache_misses_.load(std::memory_order_relaxed);
+		st.engine_calls = engine_calls_.load(std::memory_order_relaxed);
+		st.last_engine_calls = last_engine_calls_.load(std::memory_order_relaxed);
+		st.cached_objects = cached_objects_.load(std::memory_order_relaxed);
+		st.last_slices = last_slices_.load(std::memory_order_relaxed);
+		st.budget_overruns = budget_overruns_.load(std::memory_order_relaxed);
+		return st;
+	}
+	
+	const wta::core::LatencyHistogram *lock_hold_time() const override { return &lock_hold_; }
+	
+private:
+	enum class SampleMode : uint8_t { PerEntity, Bulk, Sliced };
+	
+	// 持 invoker_lock，释放时记录持锁时长
+	class HeldLock {
+	public:
+		explicit HeldLock(wta::core::LatencyHistogram &hist) : hist_(hist), start_(clock::now()) {}
+		~HeldLock() { hist_.record_sec(std::chrono::duration<double>(clock::now() - start_).count()); }
+		
+		wta::core::SliceBudget::clock::time_point start() const { return start_; }
+		std::chrono::microseconds elapsed() const {
+			return std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start_);
+		}
+		
+	private:
+		using clock = wta::core::SliceBudget::clock;
+		wta::core::LatencyHistogram &hist_;
+		client::invoker_lock lk_;   // 先于 start_ 构造：计时从拿到锁开始
+		clock::time_point start_;
+	};
+	
+	static const char *mode_name(SampleMode mode)
+	{
+		switch (mode) {
+			case SampleMode::Bulk: return "bulk";
+			case SampleMode::Sliced: return "sliced";
+			default: return "per-entity";
+		}
+	}
+	
+	// 切换采样模式时各模式记录的玩家阵营不一致，整个缓存失效
+	void switch_mode(SampleMode mode)
+	{
+		if (mode == mode_) return;
+		cache_.clear();
+		mode_ = mode;
+	}
+	
+	// 逐实体查询：每轮只查询动态字段（存活、位置、油量、损伤），静态属性取自缓存
+	void sample_each(wta::proto::SolveRequest &io_req, double now, uint32_t &calls)
+	{
+		std::vector<object> vehicles;
+		std::vector<object> units;
+		begin_each(vehicles, units, calls);
 		
 		int platform_id = 1;
 		int target_id = 1;
-		
 		// ===== 采集载具（包括无人机） =====
-		auto vehicles = sqf::vehicles();
-		for (size_t i = 0; i < vehicles.size(); ++i) {
-			const auto& veh = vehicles[i];
-			if (!sqf::alive(veh)) continue;
-			
-			auto veh_side = sqf::get_side(veh);
-			auto veh_type = sqf::type_of(veh);
-			auto veh_pos = sqf::get_pos(veh);
-			bool is_uav = sqf::unit_is_uav(veh);
-			
-			// 我方无人机 -> Platform
-			if (veh_side == player_side && is_uav) {
-				wta::types::PlatformState plat{};
-				plat.id = platform_id++;
-				plat.role = classify_platform(veh_type.c_str());
-				plat.pos.x = static_cast<float>(veh_pos.x);
-				plat.pos.y = static_cast<float>(veh_pos.y);
-				plat.alive = true;
-				
-				// 新增：平台类型名称
-				plat.platform_type = veh_type;
-				
-				// 新增：油量和损伤
-				plat.fuel = sqf::fuel(veh);
-				plat.damage = sqf::damage(veh);
-				
-				// 新增：弹夹详细信息
-				auto mags_full = sqf::magazines_ammo_full(veh);
-				for (const auto& mag : mags_full) {
-					wta::types::MagazineDetail mag_detail{};
-					mag_detail.name = mag.name;
-					mag_detail.ammo_count = mag.count;
-					mag_detail.loaded = mag.loaded;
-					mag_detail.type = mag.type;
-					mag_detail.location = mag.location;
-					plat.magazines.push_back(mag_detail);
-				}
-				
-				// 从配置读取平台参数（如果有配置）
-				auto platform_config = config_.get_platform_config(veh_type);
-				if (platform_config.has_value()) {
-					const auto& cfg = platform_config.value();
-					plat.max_range = cfg.max_range_km * 1000.0f;  // km -> m
-					plat.hit_prob = cfg.hit_prob;
-					plat.cost = cfg.cost;
-					plat.max_targets = cfg.max_targets;
-					for (int tid : cfg.target_types) {
-						plat.target_types.insert(tid);
-					}
-				} else {
-					// 使用默认值
-					plat.ammo = parse_ammo(veh);
-					plat.max_range = estimate_range(plat.ammo);
-					plat.hit_prob = 0.75f;
-					plat.cost = 10.f;
-					plat.max_targets = 1;
-					// 可攻击所有目标类型
-					plat.target_types.insert(static_cast<int>(wta::types::TargetKind::Infantry));
-					plat.target_types.insert(static_cast<int>(wta::types::TargetKind::Armor));
-					plat.target_types.insert(static_cast<int>(wta::types::TargetKind::SAM));
-					plat.target_types.insert(static_cast<int>(wta::types::TargetKind::Other));
-				}
-				plat.quantity = 1;
-				
-				io_req.platforms.push_back(plat);
+		for (const auto& veh : vehicles) visit(io_req, veh, false, now, calls, platform_id, target_id);
+		// ===== 采集步兵 =====
+		for (const auto& unit : units) visit(io_req, unit, true, now, calls, platform_id, target_id);
+	}
+	
+	/**
+	 * 分片采样：开头的玩家阵营、载具列表、步兵列表各占一片，之后每片逐实体查询直到预计超出持锁预算，
+	 * 片间释放 invoker_lock 让引擎继续渲染。快照逐片构建，整轮完成后才返回（由 SnapshotService 发布），
+	 * 实体状态分布在采样开始到结束之间。收尾（移除处理器、淘汰缓存）按估算耗时放进有余量的片，否则单独一片。
+	 * 单条引擎命令（如 vehicles/allUnits）无法再拆，它本身超出预算时只能计入 budget_overruns。
+	 */
+	void sample_sliced(wta::proto::SolveRequest &io_req, double now, std::chrono::microseconds budget)
+	{
+		uint32_t calls = 0;
+		uint32_t slices = 0;
+		std::vector<object> vehicles;
+		std::vector<object> units;
+		auto single_slice = [&](auto &&step) {
+			HeldLock lk(lock_hold_);
+			++slices;
+			step();
+			note_overrun(lk, budget);
+		};
+		single_slice([&] {
+			switch_mode(SampleMode::Sliced);
+			read_player_side(calls);
+		});
+		single_slice([&] { vehicles = sqf::vehicles(); ++calls; });
+		single_slice([&] { units = sqf::all_units(); ++calls; });
+		
+		slice_budget_.set_budget(budget);
+		const size_t n_vehicles = vehicles.size();
+		const size_t total = n_vehicles + units.size();
+		const double budget_us = static_cast<double>(budget.count());
+		size_t next = 0;
+		int platform_id = 1;
+		int target_id = 1;
+		for (bool done = false; !done;) {
+			HeldLock lk(lock_hold_);
+			++slices;
+			slice_budget_.begin(lk.start());
+			bool room = true;
+			const size_t first = next;
+			while (room && next < total) {
+				// 上一片之后被删除的实体 alive 为 false，直接跳过
+				const bool is_unit = next >= n_vehicles;
+				visit(io_req, is_unit ? units[next - n_vehicles] : vehicles[next], is_unit, now, calls, platform_id,
+				      target_id);
+				++next;
+				room = slice_budget_.next(wta::core::SliceBudget::clock::now());
 			}
-			// 敌方载具 -> Target
-			else if (veh_side != player_side && veh_side != sqf::civilian()) {
-				// 检查是否有 wta_target_id 变量
-				auto target_id_var = sqf::get_variable(veh, "wta_target_id");
-				int assigned_target_id = target_id;
-				try {
-					if (!target_id_var.is_nil()) {
-						float id_float = static_cast<float>(target_id_var);
-						assigned_target_id = static_cast<int>(id_float);
-					}
-				} catch (...) {
-					// 忽略转换错误，使用默认ID
-				}
-				
-				wta::types::TargetState tgt{};
-				tgt.id = assigned_target_id;
-				tgt.kind = classify_target(veh_type.c_str());
-				tgt.pos.x = static_cast<float>(veh_pos.x);
-				tgt.pos.y = static_cast<float>(veh_pos.y);
-				tgt.alive = true;
-				
-				// 从配置读取目标参数
-				auto target_config = config_.get_target_config(assigned_target_id);
-				if (target_config.has_value()) {
-					const auto& cfg = target_config.value();
-					tgt.target_type = cfg.type_name;
-					tgt.value = cfg.value;
-					tgt.tier = cfg.tier;
-					for (int prereq : cfg.prerequisites) {
-						tgt.prerequisite_targets.push_back(prereq);
-					}
-				} else {
-					// 使用默认值
-					tgt.target_type = veh_type;
-					tgt.value = calc_target_value(tgt.kind);
-					tgt.tier = 0;
-				}
-				
-				io_req.targets.push_back(tgt);
-				target_id++;
+			// 收尾放得下才在本片完成；本片没有处理实体时（收尾独占一片）总是完成，保证进度
+			const double used_us = static_cast<double>(lk.elapsed().count());
+			if (next == total && (next == first || (room && used_us + finish_estimate_us_ <= budget_us))) {
+				// 引擎对象句柄在锁内释放
+				vehicles.clear();
+				units.clear();
+				const auto t0 = wta::core::SliceBudget::clock::now();
+				finish_pass(io_req, now, calls, slices);
+				const double cost = std::chrono::duration<double, std::micro>(
+					wta::core::SliceBudget::clock::now() - t0).count();
+				finish_estimate_us_ = finish_estimate_us_ > 0.0 ? finish_estimate_us_ + 0.25 * (cost - finish_estimate_us_)
+				                                                : cost;
+				done = true;
 			}
+			note_overrun(lk, budget);
 		}
+	}
+	
+	void note_overrun(const HeldLock &lk, std::chrono::microseconds budget)
+	{
+		if (lk.elapsed() > budget) budget_overruns_.fetch_add(1, std::memory_order_relaxed);
+	}
+	
+	// 玩家阵营：变化时整个缓存失效
+	void read_player_side(uint32_t &calls)
+	{
+		auto player = sqf::player();
+		auto player_side = sqf::get_side(player);
+		calls += 2;
+		if (!have_player_side_ || player_side != player_side_) {
+			cache_.clear();
+			player_side_ = player_side;
+			have_player_side_ = true;
+		}
+	}
+	
+	// 逐实体采样的开头：玩家阵营与实体列表
+	void begin_each(std::vector<object> &vehicles, std::vector<object> &units, uint32_t &calls)
+	{
+		read_player_side(calls);
+		vehicles = sqf::vehicles();
+		units = sqf::all_units();
+		calls += 2;
+	}
+	
+	// 逐实体查询一个载具/步兵（步兵只可能成为目标）
+	void visit(wta::proto::SolveRequest &io_req, const object &obj, bool is_unit, double now, uint32_t &calls,
+	           int &platform_id, int &target_id)
+	{
+		++calls;
+		if (!sqf::alive(obj)) return;
 		
-		// ===== 采集步兵 =====
-		auto units = sqf::all_units();
-		for (size_t i = 0; i < units.size(); ++i) {
-			const auto& unit = units[i];
-			if (!sqf::alive(unit)) continue;
-			
-			auto unit_side = sqf::get_side(unit);
-			
-			// 只采集敌方步兵作为目标
-			if (unit_side != player_side && unit_side != sqf::civilian()) {
-				// 检查是否有 wta_target_id 变量
-				auto target_id_var = sqf::get_variable(unit, "wta_target_id");
-				int assigned_target_id = target_id;
-				try {
-					if (!target_id_var.is_nil()) {
-						float id_float = static_cast<float>(target_id_var);
-						assigned_target_id = static_cast<int>(id_float);
-					}
-				} catch (...) {
-					// 忽略转换错误，使用默认ID
-				}
-				
-				auto unit_type = sqf::type_of(unit);
-				auto unit_pos = sqf::get_pos(unit);
-				
-				wta::types::TargetState tgt{};
-				tgt.id = assigned_target_id;
-				tgt.kind = wta::types::TargetKind::Infantry;
-				tgt.pos.x = static_cast<float>(unit_pos.x);
-				tgt.pos.y = static_cast<float>(unit_pos.y);
-				tgt.alive = true;
-				
-				// 从配置读取目标参数
-				auto target_config = config_.get_target_config(assigned_target_id);
-				if (target_config.has_value()) {
-					const auto& cfg = target_config.value();
-					tgt.target_type = cfg.type_name;
-					tgt.value = cfg.value;
-					tgt.tier = cfg.tier;
-					for (int prereq : cfg.prerequisites) {
-						tgt.prerequisite_targets.push_back(prereq);
-					}
-				} else {
-					// 使用默认值
-					tgt.target_type = unit_type;
-					tgt.value = 20.f;
-					tgt.tier = 0;
-				}
-				
-				io_req.targets.push_back(tgt);
-				target_id++;
+		auto net_id = sqf::net_id(obj);
+		++calls;
+		StaticAttrs& attrs = lookup(net_id);
+		if (stale(attrs, now)) calls += refresh_object(attrs, obj, is_unit, now);
+		
+		if (attrs.category == StaticAttrs::Category::Platform) {
+			auto pos = sqf::get_pos(obj);
+			// 新增：油量和损伤
+			const float fuel = sqf::fuel(obj);
+			const float damage = sqf::damage(obj);
+			calls += 3;
+			emit_platform(io_req, attrs, obj, net_id, pos.x, pos.y, fuel, damage, platform_id, calls);
+		} else if (attrs.category == StaticAttrs::Category::Target) {
+			auto pos = sqf::get_pos(obj);
+			++calls;
+			emit_target(io_req, attrs, obj, net_id, pos.x, pos.y, target_id);
+		}
+	}
+	
+	// 一轮采样的收尾（须持 invoker_lock）：移除本轮未出现实体的处理器与缓存，更新统计
+	void finish_pass(const wta::proto::SolveRequest &io_req, double now, uint32_t calls, uint32_t slices)
+	{
+		// 移除本轮未出现（已死亡/已删除）实体的事件处理器与缓存
+		if (bridge_) bridge_->end_pass();
+		for (auto it = cache_.begin(); it != cache_.end();) {
+			if (it->second.last_pass != pass_) {
+				it = cache_.erase(it);
+			} else {
+				++it;
 			}
 		}
+		++pass_;
+		
+		samples_.fetch_add(1, std::memory_order_relaxed);
+		engine_calls_.fetch_add(calls, std::memory_order_relaxed);
+		last_engine_calls_.store(calls, std::memory_order_relaxed);
+		cached_objects_.store(cache_.size(), std::memory_order_relaxed);
+		last_slices_.store(slices, std::memory_order_relaxed);
 		
 		// 输出统计（每10秒输出一次，避免刷屏）
 		static double last_log_time = 0.0;
 		static int sample_count = 0;
 		sample_count++;
 		
-		double current_time = std::chrono::duration<double>(
-			std::chrono::steady_clock::now().time_since_epoch()
-		).count();
-		
-		if (current_time - last_log_time >= 10.0) {
+		if (now - last_log_time >= 10.0) {
+			const SamplerStats st = stats();
 			char msg[256];
 			sprintf_s(msg, sizeof(msg), 
-				"WTA Sampler: %d platforms, %d targets (%d samples in 10s)", 
-				(int)io_req.platforms.size(), (int)io_req.targets.size(), sample_count);
+				"WTA Sampler: %d platforms, %d targets (%d samples in 10s), %s, %u engine calls, cache hit %.1f%%, "
+				"%u slices, max lock hold %lluus", 
+				(int)io_req.platforms.size(), (int)io_req.targets.size(), sample_count,
+				mode_name(mode_), calls, st.hit_rate() * 100.0, slices,
+				(unsigned long long)lock_hold_.max_us());
 			sqf::diag_log(msg);
-			last_log_time = current_time;
+			last_log_time = now;
 			sample_count = 0;
 		}
 	}
 	
-private:
+	// 批量查询：一次 SQF 调用取回全部实体，其余为 C++ 解析（仅开火过的平台另查弹药）
+	// 返回值格式不符时返回 false，由调用方退回逐实体查询
+	bool sample_bulk(wta::proto::SolveRequest &io_req, double now, uint32_t &calls)
+	{
+		game_value result = sqf::call(bulk_query_);
+		++calls;
+		if (result.type_enum() != intercept::types::game_data_type::ARRAY) return false;
+		auto& arr = result.to_array();
+		if (arr.size() < kBulkHeader || (arr.size() - kBulkHeader) % kBulkStride != 0) return false;
+		
+		std::string player_side = static_cast<std::string>(arr[0]);
+		if (player_side != bulk_player_side_) {
+			cache_.clear();
+			bulk_player_side_ = std::move(player_side);
+		}
+		const size_t n_vehicles = static_cast<size_t>(static_cast<float>(arr[1]));
+		
+		int platform_id = 1;
+		int target_id = 1;
+		const size_t n = (arr.size() - kBulkHeader) / kBulkStride;
+		for (size_t k = 0; k < n; ++k) {
+			const size_t b = kBulkHeader + k * kBulkStride;
+			if (!static_cast<bool>(arr[b + 5])) continue;
+			
+			const object obj(arr[b]);
+			const std::string net_id = static_cast<std::string>(arr[b + 1]);
+			std::string obj_side = static_cast<std::string>(arr[b + 2]);
+			const bool is_unit = k >= n_vehicles;
+			
+			StaticAttrs& attrs = lookup(net_id);
+			if (attrs.side != obj_side) attrs.refreshed_at = 0.0;   // 换阵营：重新归类
+			if (stale(attrs, now)) {
+				const bool friendly = obj_side == bulk_player_side_;
+				const auto category = categorize(is_unit, friendly, obj_side == "CIV", static_cast<bool>(arr[b + 8]));
+				assign(attrs, category, static_cast<std::string>(arr[b + 3]), -1, is_unit, now);
+				attrs.side = std::move(obj_side);
+			}
+			if (attrs.category == StaticAttrs::Category::Ignored) continue;
+			
+			auto& pos = arr[b + 4].to_array();
+			if (pos.size() < 2) continue;
+			const float x = static_cast<float>(pos[0]);
+			const float y = static_cast<float>(pos[1]);
+			
+			if (attrs.category == StaticAttrs::Category::Platform) {
+				emit_platform(io_req, attrs, obj, net_id, x, y, static_cast<float>(arr[b + 6]),
+				              static_cast<float>(arr[b + 7]), platform_id, calls);
+			} else {
+				// wta_target_id 随批量结果每轮刷新，无需等缓存过期
+				const auto& id_var = arr[b + 9];
+				const int id = id_var.type_enum() == intercept::types::game_data_type::SCALAR
+				             ? static_cast<int>(static_cast<float>(id_var)) : -1;
+				attrs.assigned_id = id;
+				emit_target(io_req, attrs, obj, net_id, x, y, target_id);
+			}
+		}
+		return true;
+	}
+	
+	void emit_platform(wta::proto::SolveRequest &io_req, StaticAttrs &attrs, const object &veh,
+	                   const std::string &net_id, float x, float y, float fuel, float damage,
+	                   int &platform_id, uint32_t &calls)
+	{
+		const int id = platform_id++;
+		uint32_t fired = 0;
+		if (bridge_) fired = bridge_->track(veh, net_id, id, true);
+		// 无事件桥时无法得知是否开火，每轮重新查询弹药
+		if (!attrs.mags_valid || !bridge_ || fired != attrs.fired_seen) {
+			calls += refresh_magazines(attrs, veh);
+			attrs.fired_seen = fired;
+		}
+		
+		wta::types::PlatformState plat = attrs.plat;
+		plat.id = id;
+		plat.pos.x = x;
+		plat.pos.y = y;
+		plat.alive = true;
+		plat.fuel = fuel;
+		plat.damage = damage;
+		io_req.platforms.push_back(std::move(plat));
+	}
+	
+	void emit_target(wta::proto::SolveRequest &io_req, const StaticAttrs &attrs, const object &obj,
+	                 const std::string &net_id, float x, float y, int &target_id)
+	{
+		wta::types::TargetState tgt{};
+		tgt.id = attrs.assigned_id >= 0 ? attrs.assigned_id : target_id;
+		tgt.kind = attrs.kind;
+		tgt.pos.x = x;
+		tgt.pos.y = y;
+		tgt.alive = true;
+		apply_target_config(tgt, attrs.type, calc_target_value(tgt.kind));
+		
+		if (bridge_) bridge_->track(obj, net_id, tgt.id, false);
+		io_req.targets.push_back(std::move(tgt));
+		target_id++;
+	}
+	
+	StaticAttrs& lookup(const std::string& net_id)
+	{
+		auto& attrs = cache_[net_id];
+		attrs.last_pass = pass_;
+		return attrs;
+	}
+	
+	// 新实体或缓存过期：需要重新查询静态属性（同时计入命中率）
+	bool stale(const StaticAttrs& attrs, double now)
+	{
+		const bool miss = attrs.refreshed_at <= 0.0 || now - attrs.refreshed_at > kStaticAttrMaxAge;
+		(miss ? cache_misses_ : cache_hits_).fetch_add(1, std::memory_order_relaxed);
+		return miss;
+	}
+	
+	// 逐实体查询静态属性并归类，返回 SQF 调用数
+	uint32_t refresh_object(StaticAttrs& attrs, const object& obj, bool is_unit, double now)
+	{
+		uint32_t calls = 1;
+		auto obj_side = sqf::get_side(obj);
+		const bool friendly = obj_side == player_side_;
+		bool civilian = false;
+		bool is_uav = false;
+		if (friendly) {
+			if (!is_unit) {
+				is_uav = sqf::unit_is_uav(obj);
+				++calls;
+			}
+		} else {
+			civilian = obj_side == sqf::civilian();
+			++calls;
+		}
+		
+		const auto category = categorize(is_unit, friendly, civilian, is_uav);
+		std::string type;
+		int assigned_id = -1;
+		if (category != StaticAttrs::Category::Ignored) {
+			type = sqf::type_of(obj);
+			++calls;
+		}
+		if (category == StaticAttrs::Category::Target) {
+			assigned_id = read_target_id(obj);
+			++calls;
+		}
+		assign(attrs, category, std::move(type), assigned_id, is_unit, now);
+		return calls;
+	}
+	
+	void assign(StaticAttrs& attrs, StaticAttrs::Category category, std::string type, int assigned_id,
+	            bool is_unit, double now) const
+	{
+		attrs.category = category;
+		attrs.type = std::move(type);
+		attrs.assigned_id = assigned_id;
+		attrs.refreshed_at = now;
+		attrs.mags_valid = false;
+		if (category == StaticAttrs::Category::Platform) {
+			attrs.plat = build_platform_template(attrs);
+		} else if (category == StaticAttrs::Category::Target) {
+			attrs.kind = is_unit ? wta::types::TargetKind::Infantry : classify_target(attrs.type.c_str());
+		}
+	}
+	
+	// 平台的类型/角色与配置派生参数（无配置时射程由弹药估算，见 refresh_magazines）
+	wta::types::PlatformState build_platform_template(StaticAttrs& attrs) const
+	{
+		wta::types::PlatformState plat{};
+		plat.role = classify_platform(attrs.type.c_str());
+		
+		// 新增：平台类型名称
+		plat.platform_type = attrs.type;
+		
+		// 从配置读取平台参数（如果有配置）
+		auto platform_config = config_.get_platform_config(attrs.type);
+		attrs.has_platform_config = platform_config.has_value();
+		if (platform_config.has_value()) {
+			const auto& cfg = platform_config.value();
+			plat.max_range = cfg.max_range_km * 1000.0f;  // km -> m
+			plat.hit_prob = cfg.hit_prob;
+			plat.cost = cfg.cost;
+			plat.max_targets = cfg.max_targets;
+			for (int tid : cfg.target_types) {
+				plat.target_types.insert(tid);
+			}
+		} else {
+			// 使用默认值
+			plat.hit_prob = 0.75f;
+			plat.cost = 10.f;
+			plat.max_targets = 1;
+			// 可攻击所有目标类型
+			plat.target_types.insert(static_cast<int>(wta::types::TargetKind::Infantry));
+			plat.target_types.insert(static_cast<int>(wta::types::TargetKind::Armor));
+			plat.target_types.insert(static_cast<int>(wta::types::TargetKind::SAM));
+			plat.target_types.insert(static_cast<int>(wta::types::TargetKind::Other));
+		}
+		plat.quantity = 1;
+		return plat;
+	}
+	
+	// 重新查询平台弹药（写入缓存的平台模板），返回 SQF 调用数
+	uint32_t refresh_magazines(StaticAttrs& attrs, const object& veh)
+	{
+		uint32_t calls = 1;
+		auto& plat = attrs.plat;
+		
+		// 新增：弹夹详细信息
+		plat.magazines.clear();
+		auto mags_full = sqf::magazines_ammo_full(veh);
+		for (const auto& mag : mags_full) {
+			wta::types::MagazineDetail mag_detail{};
+			mag_detail.name = mag.name;
+			mag_detail.ammo_count = mag.count;
+			mag_detail.loaded = mag.loaded;
+			mag_detail.type = mag.type;
+			mag_detail.location = mag.location;
+			plat.magazines.push_back(mag_detail);
+		}
+		
+		// 无配置的平台按弹药估算射程
+		if (!attrs.has_platform_config) {
+			plat.ammo = parse_ammo(veh);
+			plat.max_range = estimate_range(plat.ammo);
+			++calls;
+		}
+		attrs.mags_valid = true;
+		return calls;
+	}
+	
+	// 目标配置按 ID 查表（纯 C++，每轮执行：未指定 ID 的目标按采样顺序编号）
+	void apply_target_config(wta::types::TargetState& tgt, const std::string& type, float default_value) const
+	{
+		auto target_config = config_.get_target_config(tgt.id);
+		if (target_config.has_value()) {
+			const auto& cfg = target_config.value();
+			tgt.target_type = cfg.type_name;
+			tgt.value = cfg.value;
+			tgt.tier = cfg.tier;
+			for (int prereq : cfg.prerequisites) {
+				tgt.prerequisite_targets.push_back(prereq);
+			}
+		} else {
+			// 使用默认值
+			tgt.target_type = type;
+			tgt.value = default_value;
+			tgt.tier = 0;
+		}
+	}
+	
 	WorldConfig config_;
+	EngineEventBridge *bridge_{nullptr};
+	
+	// 静态属性缓存（netId -> 属性），只在采样（持 invoker_lock、由 SnapshotService 串行化）中访问
+	std::unordered_map<std::string, StaticAttrs> cache_;
+	side player_side_{};
+	bool have_player_side_{false};
+	uint64_t pass_{0};
+	
+	// 批量查询（构造时编译一次）
+	code bulk_query_;
+	bool bulk_ready_{false};
+	std::string bulk_player_side_;
+	SampleMode mode_{SampleMode::PerEntity};
+	
+	// 分片采样的持锁预算估算（跨轮保留每个实体的耗时估算）
+	wta::core::SliceBudget slice_budget_{std::chrono::microseconds(0)};
+	double finish_estimate_us_{0.0};   // 收尾耗时估算（指数滑动平均）
+	wta::core::LatencyHistogram lock_hold_;
+	
+	std::atomic<uint64_t> samples_{0};
+	std::atomic<uint64_t> cache_hits_{0};
+	std::atomic<uint64_t> cache_misses_{0};
+	std::atomic<uint64_t> engine_calls_{0};
+	std::atomic<uint32_t> last_engine_calls_{0};
+	std::atomic<size_t> cached_objects_{0};
+	std::atomic<uint32_t> last_slices_{0};
+	std::atomic<uint64_t> budget_overruns_{0};
 };
 
 }// namespace
 
-std::unique_ptr<IWorldSampler> make_intercept_world_sampler()
+std::unique_ptr<IWorldSampler> make_intercept_world_sampler(EngineEventBridge *bridge)
 {
-	return std::make_unique<InterceptWorldSampler>();
+	return std::make_unique<InterceptWorldSampler>(bridge);
 }
 
 }// namespace wta::world
@@ -0,0 +1,34 @@
+#include <gtest/gtest.h>
+#include "../src/wta/core/damage_levels.hpp"
+
+using wta::core::DamageLevels;
+
+TEST(DamageLevels, ReportsIncreaseOverPreviousLevelPerHitPoint) {
+    DamageLevels levels(8);
+    EXPECT_FLOAT_EQ(levels.on_level(2, 0.3f), 0.3f);
+    // 同一部位再次命中：只计新增部分，不累加等级
+    EXPECT_FLOAT_EQ(levels.on_level(2, 0.5f), 0.2f);
+    EXPECT_FLOAT_EQ(levels.on_level(2, 0.5f), 0.f);
+    // 其他部位与整体伤害各自独立
+    EXPECT_FLOAT_EQ(levels.on_level(3, 0.4f), 0.4f);
+    EXPECT_FLOAT_EQ(levels.on_level(-1, 0.1f), 0.1f);
+}
+
+TEST(DamageLevels, RepairYieldsNoDamageAndResetsBaseline) {
+    DamageLevels levels(8);
+    EXPECT_FLOAT_EQ(levels.on_level(0, 0.8f), 0.8f);
+    EXPECT_FLOAT_EQ(levels.on_level(0, 0.0f), 0.f);
+    EXPECT_FLOAT_EQ(levels.on_level(0, 0.3f), 0.3f);
+}
+
+TEST(DamageLevels, SlotsFollowVehicleHitPointCount) {
+    // 部位多于 32 的载具：高索引部位各自独立，不与其他部位共用基线
+    DamageLevels levels(40);
+    EXPECT_EQ(levels.hit_points(), 40u);
+    EXPECT_FLOAT_EQ(levels.on_level(35, 0.2f), 0.2f);
+    EXPECT_FLOAT_EQ(levels.on_level(39, 0.2f), 0.2f);
+    EXPECT_FLOAT_EQ(levels.on_level(35, 0.5f), 0.3f);
+    // 超出部位数的索引被忽略
+    EXPECT_FLOAT_EQ(levels.on_level(40, 0.7f), 0.f);
+    EXPECT_FLOAT_EQ(levels.on_level(1000, 0.7f), 0.f);
+}
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "../src/wta/world/event_bus.hpp"
+#include <thread>
 
 class EventBusTest : public ::testing::Test {
 protected:
@@ -7,22 +8,25 @@ protected:
 };
 
 TEST_F(EventBusTest, PublishAndPopEvent) {
+    auto sub = bus.subscribe({wta::events::EventType::ReplanRequest});
     wta::events::Event e{wta::events::EventType::ReplanRequest, wta::events::EventPayload{}, 0.0};
     bus.publish(e);
     
-    wta::events::Event out{};
-    bool ok = bus.try_pop(out);
+    wta::events::EventPtr out;
+    bool ok = sub->try_pop(out);
     EXPECT_TRUE(ok);
-    EXPECT_EQ(out.type, wta::events::EventType::ReplanRequest);
+    EXPECT_EQ(out->type, wta::events::EventType::ReplanRequest);
 }
 
 TEST_F(EventBusTest, PopFromEmptyBus) {
-    wta::events::Event out{};
-    bool ok = bus.try_pop(out);
+    auto sub = bus.subscribe({wta::events::EventType::ReplanRequest});
+    wta::events::EventPtr out;
+    bool ok = sub->try_pop(out);
     EXPECT_FALSE(ok);
 }
 
 TEST_F(EventBusTest, MultipleEvents) {
+    auto sub = bus.subscribe({wta::events::EventType::EntityKilled});
     for (int i = 0; i < 5; ++i) {
         wta::events::Event e{wta::events::EventType::EntityKilled, 
                             wta::events::EntityKilledEvent{static_cast<int32_t>(i), false}, 0.0};
@@ -30,11 +34,233 @@ TEST_F(EventBusTest, MultipleEvents) {
     }
     
     for (int i = 0; i < 5; ++i) {
-        wta::events::Event out{};
-        EXPECT_TRUE(bus.try_pop(out));
-        EXPECT_EQ(out.type, wta::events::EventType::EntityKilled);
+        wta::events::EventPtr out;
+        EXPECT_TRUE(sub->try_pop(out));
+        EXPECT_EQ(out->type, wta::events::EventType::EntityKilled);
     }
     
-    wta::events::Event out{};
-    EXPECT_FALSE(bus.try_pop(out));
+    wta::events::EventPtr out;
+    EXPECT_FALSE(sub->try_pop(out));
+}
+
+TEST_F(EventBusTest, EventsWithoutSubscribersAreNotQueued) {
+    bus.publish({wta::events::EventType::HandleDamage, wta::events::DamageEvent{1, 0.2f, false}, 0.0});
+    EXPECT_EQ(bus.published(), 1u);
+    EXPECT_EQ(bus.stats().delivered, 0u);
+    EXPECT_EQ(bus.stats().dropped, 0u);
+
+    // 订阅只接收之后发布的事件
+    auto sub = bus.subscribe({wta::events::EventType::HandleDamage});
+    EXPECT_EQ(sub->pending(), 0u);
+}
+
+TEST_F(EventBusTest, SubscribersReceiveSameEvent) {
+    auto solver = bus.subscribe({wta::events::EventType::EntityKilled});
+    auto reporter = bus.subscribe({wta::events::EventType::EntityKilled,
+                                   wta::events::EventType::Fired});
+    
+    bus.publish({wta::events::EventType::EntityKilled, wta::events::EntityKilledEvent{7, false}, 1.0});
+    
+    wta::events::EventPtr a, b;
+    ASSERT_TRUE(solver->try_pop(a));
+    ASSERT_TRUE(reporter->try_pop(b));
+    // 扇出共享同一事件对象，不拷贝负载
+    EXPECT_EQ(a.get(), b.get());
+    EXPECT_EQ(std::get<wta::events::EntityKilledEvent>(a->payload).entity_id, 7);
+}
+
+TEST_F(EventBusTest, SubscriberOnlyReceivesRegisteredTypes) {
+    auto sub = bus.subscribe({wta::events::EventType::HandleDamage});
+    bus.publish({wta::events::EventType::Fired, wta::events::FiredEvent{1, wta::core::weapon_names().intern("gbu")}, 0.0});
+    
+    wta::events::EventPtr out;
+    EXPECT_FALSE(sub->try_pop(out));
+    EXPECT_EQ(bus.subscriber_count(wta::events::EventType::HandleDamage), 1u);
+}
+
+TEST_F(EventBusTest, SubscriberFilter) {
+    auto platforms_only = bus.subscribe(
+        {wta::events::EventType::EntityKilled},
+        [](const wta::events::Event& e) {
+            return std::get<wta::events::EntityKilledEvent>(e.payload).is_platform;
+        });
+    
+    bus.publish({wta::events::EventType::EntityKilled, wta::events::EntityKilledEvent{1, false}, 0.0});
+    bus.publish({wta::events::EventType::EntityKilled, wta::events::EntityKilledEvent{2, true}, 0.0});
+    
+    wta::events::EventPtr out;
+    ASSERT_TRUE(platforms_only->try_pop(out));
+    EXPECT_EQ(std::get<wta::events::EntityKilledEvent>(out->payload).entity_id, 2);
+    EXPECT_FALSE(platforms_only->try_pop(out));
+}
+
+TEST_F(EventBusTest, UnsubscribeStopsDelivery) {
+    auto sub = bus.subscribe({wta::events::EventType::ReplanRequest});
+    bus.unsubscribe(sub);
+    bus.publish({wta::events::EventType::ReplanRequest, wta::events::EventPayload{}, 0.0});
+    
+    wta::events::EventPtr out;
+    EXPECT_FALSE(sub->try_pop(out));
+}
+
+TEST_F(EventBusTest, OverflowDropsOldest) {
+    auto sub = bus.subscribe({wta::events::EventType::EntityKilled}, {}, 2);
+    for (int i = 0; i < 3; ++i) {
+        bus.publish({wta::events::EventType::EntityKilled, wta::events::EntityKilledEvent{i, false}, 0.0});
+    }
+    
+    EXPECT_EQ(sub->dropped(), 1u);
+    wta::events::EventPtr out;
+    ASSERT_TRUE(sub->try_pop(out));
+    EXPECT_EQ(std::get<wta::events::EntityKilledEvent>(out->payload).entity_id, 1);
+}
+
+TEST_F(EventBusTest, DamageWithinWindowIsMerged) {
+    auto sub = bus.subscribe({wta::events::EventType::HandleDamage});
+    bus.publish({wta::events::EventType::HandleDamage, wta::events::DamageEvent{3, 0.1f, false}, 10.00});
+    bus.publish({wta::events::EventType::HandleDamage, wta::events::DamageEvent{3, 0.2f, false}, 10.01});
+    bus.publish({wta::events::EventType::HandleDamage, wta::events::DamageEvent{4, 0.5f, false}, 10.01});
+    
+    EXPECT_EQ(sub->pending(), 2u);
+    EXPECT_EQ(sub->merged_damage(), 1u);
+    
+    wta::events::EventPtr out;
+    ASSERT_TRUE(sub->try_pop(out));
+    const auto& dmg = std::get<wta::events::DamageEvent>(out->payload);
+    EXPECT_EQ(dmg.entity_id, 3);
+    EXPECT_FLOAT_EQ(dmg.damage, 0.3f);
+    EXPECT_DOUBLE_EQ(out->timestamp, 10.00);
+}
+
+TEST_F(EventBusTest, DamageOutsideWindowIsKept) {
+    auto sub = bus.subscribe({wta::events::EventType::HandleDamage});
+    bus.publish({wta::events::EventType::HandleDamage, wta::events::DamageEvent{3, 0.1f, false}, 10.0});
+    bus.publish({wta::events::EventType::HandleDamage, wta::events::DamageEvent{3, 0.2f, false}, 11.0});
+    EXPECT_EQ(sub->pending(), 2u);
+}
+
+TEST_F(EventBusTest, KillSupersedesPendingDamage) {
+    auto sub = bus.subscribe({wta::events::EventType::HandleDamage, wta::events::EventType::EntityKilled});
+    bus.publish({wta::events::EventType::HandleDamage, wta::events::DamageEvent{5, 0.4f, false}, 1.0});
+    bus.publish({wta::events::EventType::EntityKilled, wta::events::EntityKilledEvent{5, false}, 1.0});
+    
+    EXPECT_EQ(sub->pending(), 1u);
+    EXPECT_EQ(sub->superseded_damage(), 1u);
+    
+    wta::events::EventPtr out;
+    ASSERT_TRUE(sub->try_pop(out));
+    EXPECT_EQ(out->type, wta::events::EventType::EntityKilled);
+    EXPECT_FALSE(sub->try_pop(out));
+}
+
+TEST_F(EventBusTest, KillSupersedesAllPendingDamageOfEntity) {
+    auto sub = bus.subscribe({wta::events::EventType::HandleDamage, wta::events::EventType::EntityKilled});
+    // 三条伤害互相超出合并窗口，各自入队；另一实体的伤害不受影响
+    bus.publish({wta::events::EventType::HandleDamage, wta::events::DamageEvent{5, 0.1f, false}, 1.0});
+    bus.publish({wta::events::EventType::HandleDamage, wta::events::DamageEvent{6, 0.1f, false}, 1.5});
+    bus.publish({wta::events::EventType::HandleDamage, wta::events::DamageEvent{5, 0.2f, false}, 2.0});
+    bus.publish({wta::events::EventType::HandleDamage, wta::events::DamageEvent{5, 0.3f, false}, 3.0});
+    EXPECT_EQ(sub->pending(), 4u);
+
+    // 先消费最早的一条，再击毁：剩下的两条都被取代
+    wta::events::EventPtr out;
+    ASSERT_TRUE(sub->try_pop(out));
+    EXPECT_DOUBLE_EQ(out->timestamp, 1.0);
+    bus.publish({wta::events::EventType::EntityKilled, wta::events::EntityKilledEvent{5, false}, 3.5});
+    EXPECT_EQ(sub->superseded_damage(), 2u);
+    EXPECT_EQ(sub->pending(), 2u);
+
+    ASSERT_TRUE(sub->try_pop(out));
+    EXPECT_EQ(std::get<wta::events::DamageEvent>(out->payload).entity_id, 6);
+    ASSERT_TRUE(sub->try_pop(out));
+    EXPECT_EQ(out->type, wta::events::EventType::EntityKilled);
+    EXPECT_FALSE(sub->try_pop(out));
+}
+
+TEST_F(EventBusTest, ReplanRequestsCollapse) {
+    auto sub = bus.subscribe({wta::events::EventType::ReplanRequest});
+    for (int i = 0; i < 4; ++i) {
+        bus.publish({wta::events::EventType::ReplanRequest, wta::events::EventPayload{}, 0.0});
+    }
+    EXPECT_EQ(sub->pending(), 1u);
+    
+    wta::events::EventPtr out;
+    ASSERT_TRUE(sub->try_pop(out));
+    // 已消费后新的请求重新入队
+    bus.publish({wta::events::EventType::ReplanRequest, wta::events::EventPayload{}, 0.0});
+    EXPECT_EQ(sub->pending(), 1u);
+    
+    EXPECT_EQ(bus.stats().collapsed_replan, 3u);
+}
+
+TEST_F(EventBusTest, DrainIntoTakesWholeBatch) {
+    auto sub = bus.subscribe({wta::events::EventType::EntityKilled});
+    for (int i = 0; i < 5; ++i) {
+        bus.publish({wta::events::EventType::EntityKilled, wta::events::EntityKilledEvent{i, false}, 0.0});
+    }
+    
+    std::vector<wta::events::EventPtr> batch;
+    EXPECT_EQ(sub->drain_into(batch, 2), 2u);
+    EXPECT_EQ(sub->drain_into(batch), 3u);
+    ASSERT_EQ(batch.size(), 5u);
+    EXPECT_EQ(std::get<wta::events::EntityKilledEvent>(batch[4]->payload).entity_id, 4);
+    EXPECT_EQ(sub->drain_into(batch), 0u);
+}
+
+TEST_F(EventBusTest, WaitForTimesOutWhenEmpty) {
+    auto sub = bus.subscribe({wta::events::EventType::Fired});
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(sub->wait_for(std::chrono::milliseconds(20)));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(20));
+}
+
+TEST_F(EventBusTest, WaitUntilWakesOnPublish) {
+    auto sub = bus.subscribe({wta::events::EventType::Fired});
+    std::thread producer([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        bus.publish({wta::events::EventType::Fired, wta::events::FiredEvent{1, wta::core::weapon_names().intern("gbu")}, 0.0});
+    });
+    EXPECT_TRUE(sub->wait_until(std::chrono::steady_clock::now() + std::chrono::seconds(5)));
+    producer.join();
+}
+
+TEST_F(EventBusTest, CloseWakesWaiters) {
+    auto sub = bus.subscribe({wta::events::EventType::ReplanRequest});
+    std::thread closer([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        bus.close();
+    });
+    EXPECT_EQ(sub->wait_and_pop(), nullptr);
+    closer.join();
+    
+    // 关闭后不再接收事件
+    bus.publish({wta::events::EventType::ReplanRequest, wta::events::EventPayload{}, 0.0});
+    wta::events::EventPtr out;
+    EXPECT_FALSE(sub->try_pop(out));
+}
+
+TEST_F(EventBusTest, FiredEventCarriesInternedWeapon) {
+    auto sub = bus.subscribe({wta::events::EventType::Fired});
+    const auto id = wta::core::weapon_names().intern("missiles_SCALPEL");
+    EXPECT_EQ(wta::core::weapon_names().intern("missiles_SCALPEL"), id);
+    bus.publish({wta::events::EventType::Fired, wta::events::FiredEvent{2, id}, 0.0});
+    
+    wta::events::EventPtr out;
+    ASSERT_TRUE(sub->try_pop(out));
+    const auto& fired = std::get<wta::events::FiredEvent>(out->payload);
+    EXPECT_EQ(wta::core::weapon_names().lookup(fired.weapon), "missiles_SCALPEL");
+    EXPECT_TRUE(std::is_trivially_copyable_v<wta::events::Event>);
+}
+
+TEST_F(EventBusTest, WakeInterruptsWaitWithoutEvent) {
+    auto sub = bus.subscribe({wta::events::EventType::EntityKilled});
+    std::thread waker([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        sub->wake();
+    });
+    EXPECT_FALSE(sub->wait());
+    waker.join();
+
+    // 唤醒标志只消费一次
+    EXPECT_FALSE(sub->wait_for(std::chrono::milliseconds(5)));
 }
@@ -0,0 +1,305 @@
+#include <gtest/gtest.h>
+#include "wta/record/flight_recorder.hpp"
+#include "wta/record/replay.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+
+using namespace wta::record;
+
+class FlightRecorderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir_ = std::filesystem::temp_directory_path() /
+               ("wta_rec_test_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) + "_" +
+                ::testing::UnitTest::GetInstance()->current_test_info()->name());
+        std::filesystem::remove_all(dir_);
+    }
+    void TearDown() override { std::filesystem::remove_all(dir_); }
+
+    FlightRecorderOptions options(size_t segment_bytes = 1u << 20) const {
+        FlightRecorderOptions opts;
+        opts.directory = dir_.string();
+        opts.segment_bytes = segment_bytes;
+        opts.index_capacity = 64;
+        opts.index_interval_sec = 0.0;   // 测试中每条记录都建索引
+        return opts;
+    }
+
+    static wta::proto::PlanResponse make_response() {
+        wta::proto::PlanResponse resp;
+        resp.status = "ok";
+        resp.timestamp = 12.5;
+        resp.best_fitness = 0.75;
+        resp.n_platforms = 2;
+        resp.n_targets = 2;
+        resp.assignment = {1, 0, 0, 1};
+        resp.ttl_sec = 3.0;
+        return resp;
+    }
+
+    std::filesystem::path dir_;
+};
+
+TEST_F(FlightRecorderTest, RoundTripsAllRecordKinds) {
+    FlightRecorder rec(options());
+    ASSERT_TRUE(rec.open());
+
+    wta::types::PlatformState p;
+    p.id = 7;
+    p.hit_prob = 0.8f;
+    p.target_types = {1, 2};
+    p.platform_type = "B_UAV_02_dynamicLoadout_F";
+    p.magazines.push_back({"2Rnd_GBU12_LGB", 2, true, 1, "pylon"});
+    wta::types::TargetState t;
+    t.id = 3;
+    t.value = 50.f;
+    t.prerequisite_targets = {1};
+    t.target_type = "SAM";
+    rec.record_snapshot(1.0, {p}, {t});
+
+    const auto weapon = wta::core::weapon_names().intern("missiles_SCALPEL");
+    rec.record_event({wta::events::EventType::Fired, wta::events::FiredEvent{7, weapon}, 2.0});
+
+    wta::proto::PlanRequest req;
+    req.reason = "ttl_expired";
+    req.config.bpso.seed = 42;
+    req.platforms = {p};
+    req.targets = {t};
+    req.snapshot_version = 9;
+    req.cluster_index = 1;
+    rec.record_plan_request(req);
+    rec.record_plan_response(req, make_response());
+    rec.record_exec_apply(make_response());
+    EXPECT_EQ(rec.records(), 5u);
+    EXPECT_EQ(rec.failed(), 0u);
+    rec.close();
+
+    RecordingReader reader;
+    ASSERT_TRUE(reader.open(rec.segments()));
+    RecordView v;
+
+    ASSERT_TRUE(reader.next(v));
+    ASSERT_EQ(v.kind, RecordKind::Snapshot);
+    Snapshot snap;
+    ASSERT_TRUE(decode_record(v, snap));
+    ASSERT_EQ(snap.platforms.size(), 1u);
+    EXPECT_EQ(snap.platforms[0].id, 7);
+    EXPECT_EQ(snap.platforms[0].target_types.count(2), 1u);
+    EXPECT_EQ(snap.platforms[0].magazines[0].name, "2Rnd_GBU12_LGB");
+    EXPECT_EQ(snap.targets[0].target_type, "SAM");
+    EXPECT_EQ(snap.targets[0].prerequisite_targets, std::vector<int>{1});
+
+    ASSERT_TRUE(reader.next(v));
+    ASSERT_EQ(v.kind, RecordKind::BusEvent);
+    wta::events::Event ev{};
+    ASSERT_TRUE(decode_record(v, ev));
+    EXPECT_EQ(wta::core::weapon_names().lookup(std::get<wta::events::FiredEvent>(ev.payload).weapon),
+              "missiles_SCALPEL");
+
+    ASSERT_TRUE(reader.next(v));
+    wta::proto::PlanRequest req_out;
+    ASSERT_TRUE(decode_record(v, req_out));
+    EXPECT_EQ(req_out.reason, "ttl_expired");
+    EXPECT_EQ(req_out.config.bpso.seed, std::optional<int>(42));
+    EXPECT_EQ(req_out.cluster_index, 1);
+
+    ASSERT_TRUE(reader.next(v));
+    PlanResponseRecord resp_out;
+    ASSERT_TRUE(decode_record(v, resp_out));
+    EXPECT_EQ(resp_out.key.snapshot_version, 9u);
+    EXPECT_EQ(resp_out.key.cluster_index, 1);
+    EXPECT_EQ(resp_out.resp.assignment, (std::vector<uint8_t>{1, 0, 0, 1}));
+    EXPECT_DOUBLE_EQ(resp_out.resp.ttl_sec, 3.0);
+
+    ASSERT_TRUE(reader.next(v));
+    ExecCommand cmd;
+    ASSERT_TRUE(decode_record(v, cmd));
+    ASSERT_EQ(cmd.engagements.size(), 2u);
+    EXPECT_EQ(cmd.engagements[1].platform_id, 2);
+    EXPECT_EQ(cmd.engagements[1].target_id, 2);
+
+    EXPECT_FALSE(reader.next(v));
+}
+
+TEST_F(FlightRecorderTest, RollsSegmentsAndSeeksByTime) {
+    // 小段强制滚动
+    FlightRecorder rec(options(8 * 1024));
+    ASSERT_TRUE(rec.open());
+    for (int i = 0; i < 400; ++i) {
+        rec.record_event({wta::events::EventType::EntityKilled, wta::events::EntityKilledEvent{i, false}, 0.0});
+    }
+    EXPECT_GT(rec.segments().size(), 1u);
+    EXPECT_EQ(rec.failed(), 0u);
+    rec.close();
+
+    auto found = find_segments(dir_.string(), rec.session_stem());
+    EXPECT_EQ(found, rec.segments());
+
+    RecordingReader reader;
+    ASSERT_TRUE(reader.open(found));
+    std::vector<double> stamps;
+    std::vector<int> ids;
+    RecordView v;
+    while (reader.next(v)) {
+        wta::events::Event ev{};
+        ASSERT_TRUE(decode_record(v, ev));
+        ids.push_back(std::get<wta::events::EntityKilledEvent>(ev.payload).entity_id);
+        stamps.push_back(v.timestamp);
+    }
+    ASSERT_EQ(ids.size(), 400u);
+    EXPECT_EQ(ids.front(), 0);
+    EXPECT_EQ(ids.back(), 399);
+
+    // 定位到第 300 条记录的时间
+    ASSERT_TRUE(reader.seek(stamps[300]));
+    ASSERT_TRUE(reader.next(v));
+    EXPECT_GE(v.timestamp, stamps[300]);
+    wta::events::Event ev{};
+    ASSERT_TRUE(decode_record(v, ev));
+    EXPECT_LE(std::get<wta::events::EntityKilledEvent>(ev.payload).entity_id, 300);
+}
+
+TEST_F(FlightRecorderTest, RejectsSegmentsWithOtherVersion) {
+    FlightRecorder rec(options());
+    ASSERT_TRUE(rec.open());
+    rec.record_plan_request(wta::proto::PlanRequest{});
+    rec.close();
+    const auto path = rec.segments().front();
+
+    // 改写段头版本：负载布局不同的旧录制不能按当前格式解码
+    {
+        std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+        ASSERT_TRUE(f.is_open());
+        const uint32_t old_version = kSegmentVersion - 1;
+        f.seekp(offsetof(SegmentHeader, version));
+        f.write(reinterpret_cast<const char*>(&old_version), sizeof(old_version));
+    }
+    RecordingReader reader;
+    EXPECT_FALSE(reader.open({path}));
+}
+
+TEST_F(FlightRecorderTest, PrunesOldestSegmentsBeyondLimit) {
+    auto opts = options(8 * 1024);
+    opts.max_segments = 2;
+    FlightRecorder rec(opts);
+    ASSERT_TRUE(rec.open());
+    for (int i = 0; i < 1200; ++i) {
+        rec.record_event({wta::events::EventType::EntityKilled, wta::events::EntityKilledEvent{i, false}, 0.0});
+    }
+    EXPECT_EQ(rec.segments().size(), 2u);
+    EXPECT_GT(rec.pruned_segments(), 0u);
+    rec.close();
+
+    // 磁盘上只剩最近的两个段，且仍可从头读到最后一条
+    auto found = find_segments(dir_.string(), rec.session_stem());
+    EXPECT_EQ(found, rec.segments());
+    RecordingReader reader;
+    ASSERT_TRUE(reader.open(found));
+    RecordView v;
+    int last = -1;
+    size_t n = 0;
+    while (reader.next(v)) {
+        wta::events::Event ev{};
+        ASSERT_TRUE(decode_record(v, ev));
+        last = std::get<wta::events::EntityKilledEvent>(ev.payload).entity_id;
+        ++n;
+    }
+    EXPECT_LT(n, 1200u);
+    EXPECT_EQ(last, 1199);
+}
+
+TEST_F(FlightRecorderTest, ReplayMatchesResponsesToClusterRequests) {
+    FlightRecorder rec(options());
+    ASSERT_TRUE(rec.open());
+    // 两个簇并行在途：簇 1 的响应先于簇 0 到达
+    wta::proto::PlanRequest c0;
+    c0.snapshot_version = 4;
+    c0.cluster_index = 0;
+    auto c1 = c0;
+    c1.cluster_index = 1;
+    auto r0 = make_response();
+    r0.assignment = {1, 0, 0, 0};
+    auto r1 = make_response();
+    r1.assignment = {0, 0, 0, 1};
+    rec.record_plan_request(c0);
+    rec.record_plan_request(c1);
+    rec.record_plan_response(c1, r1);
+    rec.record_plan_response(c0, r0);
+    rec.close();
+
+    RecordingReader reader;
+    ASSERT_TRUE(reader.open(rec.segments()));
+    ReplayDriver driver(reader, ReplayOptions{0.0});
+    const auto st = driver.run();
+    EXPECT_EQ(st.plan_responses, 2u);
+
+    wta::proto::PlanResponse out;
+    ASSERT_TRUE(driver.solver().request_plan(c0, out, std::chrono::milliseconds(10)));
+    EXPECT_EQ(out.assignment, r0.assignment);
+    ASSERT_TRUE(driver.solver().request_plan(c1, out, std::chrono::milliseconds(10)));
+    EXPECT_EQ(out.assignment, r1.assignment);
+    EXPECT_FALSE(driver.solver().request_plan(c0, out, std::chrono::milliseconds(10)));
+}
+
+TEST_F(FlightRecorderTest, ReplayFeedsFakesAndBus) {
+    FlightRecorder rec(options());
+    ASSERT_TRUE(rec.open());
+    wta::types::PlatformState p;
+    p.id = 1;
+    rec.record_snapshot(1.0, {p}, {});
+    rec.record_event({wta::events::EventType::EntityKilled, wta::events::EntityKilledEvent{5, false}, 1.5});
+    rec.record_plan_request(wta::proto::PlanRequest{});
+    rec.record_plan_response(wta::proto::PlanRequest{}, make_response());
+    rec.record_exec_apply(make_response());
+    rec.record_exec_reassign({{2, 1}, {1, 2}});
+    rec.close();
+
+    RecordingReader reader;
+    ASSERT_TRUE(reader.open(rec.segments()));
+    ReplayDriver driver(reader, ReplayOptions{0.0});
+    wta::events::EventBus bus;
+    auto sub = bus.subscribe({wta::events::EventType::EntityKilled});
+
+    const auto st = driver.run(&bus);
+    EXPECT_EQ(st.records, 6u);
+    EXPECT_EQ(st.exec_reassigns, 1u);
+    EXPECT_EQ(st.decode_errors, 0u);
+    EXPECT_EQ(sub->pending(), 1u);
+
+    wta::proto::SolveRequest sampled;
+    driver.sampler().sample(sampled);
+    ASSERT_EQ(sampled.platforms.size(), 1u);
+
+    wta::proto::PlanResponse out;
+    EXPECT_TRUE(driver.solver().request_plan(wta::proto::PlanRequest{}, out, std::chrono::milliseconds(10)));
+    EXPECT_EQ(out.assignment, (std::vector<uint8_t>{1, 0, 0, 1}));
+    // 录制的响应已取完，回放结束后不再阻塞
+    EXPECT_FALSE(driver.solver().request_plan(wta::proto::PlanRequest{}, out, std::chrono::seconds(5)));
+    EXPECT_EQ(driver.executor().recorded().size(), 1u);
+
+    // 录制的改派按平台排序，回放时收到的同一改派得到相同的记录
+    const auto recorded = driver.executor().recorded_reassigns();
+    ASSERT_EQ(recorded.size(), 1u);
+    ASSERT_EQ(recorded[0].moves.size(), 2u);
+    EXPECT_EQ(recorded[0].moves[0].platform_id, 1);
+    EXPECT_EQ(recorded[0].moves[0].target_id, 2);
+    EXPECT_EQ(driver.executor().reassign({{1, 2}, {2, 1}}), 2u);
+    const auto replayed = driver.executor().reassigned();
+    ASSERT_EQ(replayed.size(), 1u);
+    EXPECT_EQ(replayed[0].moves[1].platform_id, recorded[0].moves[1].platform_id);
+    EXPECT_EQ(replayed[0].moves[1].target_id, recorded[0].moves[1].target_id);
+}
+
+TEST_F(FlightRecorderTest, BusTapRecordsPublishedEvents) {
+    FlightRecorder rec(options());
+    ASSERT_TRUE(rec.open());
+    wta::events::EventBus bus;
+    bus.set_tap([&](const wta::events::Event& ev) { rec.record_event(ev); });
+    bus.publish({wta::events::EventType::HandleDamage, wta::events::DamageEvent{2, 0.3f, true}, 0.0});
+    bus.set_tap({});
+    bus.publish({wta::events::EventType::HandleDamage, wta::events::DamageEvent{2, 0.3f, true}, 0.0});
+    EXPECT_EQ(rec.records(), 1u);
+    EXPECT_LT(rec.avg_record_ns(), 50000.0);
+}
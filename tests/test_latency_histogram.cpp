@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include "../src/wta/core/latency_histogram.hpp"
+
+using wta::core::LatencyHistogram;
+
+TEST(LatencyHistogram, BucketsCoverValuesWithBoundedError) {
+    for (uint64_t us : {0ull, 1ull, 7ull, 8ull, 15ull, 16ull, 100ull, 999ull, 12345ull, 50000000ull}) {
+        const size_t idx = LatencyHistogram::bucket_of(us);
+        ASSERT_LT(idx, LatencyHistogram::kBuckets);
+        const uint64_t upper = LatencyHistogram::upper_bound_of(idx);
+        EXPECT_GE(upper, us);
+        EXPECT_LE(static_cast<double>(upper), static_cast<double>(us) * 1.125 + 1.0);
+    }
+    // 超出范围的值计入最后一个桶
+    EXPECT_EQ(LatencyHistogram::bucket_of(~0ull), LatencyHistogram::kBuckets - 1);
+}
+
+TEST(LatencyHistogram, PercentilesAndSummary) {
+    LatencyHistogram h;
+    EXPECT_EQ(h.percentile_us(50), 0u);
+    for (uint64_t us = 1; us <= 1000; ++us) h.record_us(us);
+    EXPECT_EQ(h.count(), 1000u);
+    EXPECT_EQ(h.max_us(), 1000u);
+    EXPECT_NEAR(h.mean_us(), 500.5, 0.01);
+    EXPECT_NEAR(static_cast<double>(h.percentile_us(50)), 500.0, 500.0 * 0.125);
+    EXPECT_NEAR(static_cast<double>(h.percentile_us(99)), 990.0, 990.0 * 0.125);
+    EXPECT_EQ(h.percentile_us(100), 1000u);
+    EXPECT_NE(h.summary().find("n=1000"), std::string::npos);
+
+    h.record_sec(-0.5);   // 时钟抖动按 0 计
+    EXPECT_EQ(h.count(), 1001u);
+    h.reset();
+    EXPECT_EQ(h.count(), 0u);
+    EXPECT_EQ(h.max_us(), 0u);
+}
+
+TEST(LatencyHistogram, ConcurrentRecordCountsEverySample) {
+    LatencyHistogram h;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&h, t] {
+            for (int i = 0; i < 10000; ++i) h.record_us(static_cast<uint64_t>(t * 100 + i % 100));
+        });
+    }
+    for (auto& th : threads) th.join();
+    EXPECT_EQ(h.count(), 40000u);
+    EXPECT_EQ(h.max_us(), 399u);
+}
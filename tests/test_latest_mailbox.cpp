@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "../src/wta/core/latest_mailbox.hpp"
+
+struct Plan {
+    int version{0};
+    std::vector<int> payload;
+};
+
+TEST(LatestMailbox, TakeReturnsLatestAndEmptiesSlot) {
+    wta::core::LatestMailbox<Plan> box;
+    EXPECT_FALSE(box.pending());
+    EXPECT_EQ(box.take(), nullptr);
+
+    EXPECT_FALSE(box.publish(std::make_unique<Plan>(Plan{1, {1}})));
+    EXPECT_TRUE(box.publish(std::make_unique<Plan>(Plan{2, {2, 2}})));   // 覆盖未取走的 1
+    EXPECT_TRUE(box.pending());
+    EXPECT_EQ(box.superseded(), 1u);
+
+    auto p = box.take();
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(p->version, 2);
+    EXPECT_EQ(p->payload.size(), 2u);
+    EXPECT_FALSE(box.pending());
+}
+
+TEST(LatestMailbox, ConsumerSeesMonotonicCompleteObjects) {
+    wta::core::LatestMailbox<Plan> box;
+    constexpr int kPlans = 20000;
+    std::atomic<bool> done{false};
+
+    std::thread producer([&] {
+        for (int v = 1; v <= kPlans; ++v) {
+            box.publish(std::make_unique<Plan>(Plan{v, std::vector<int>(8, v)}));
+        }
+        done = true;
+    });
+
+    int last = 0;
+    int taken = 0;
+    while (!done || box.pending()) {
+        if (auto p = box.take()) {
+            EXPECT_GT(p->version, last);
+            for (int x : p->payload) ASSERT_EQ(x, p->version);
+            last = p->version;
+            ++taken;
+        }
+    }
+    producer.join();
+    EXPECT_EQ(last, kPlans);
+    EXPECT_EQ(static_cast<uint64_t>(taken) + box.superseded(), static_cast<uint64_t>(kPlans));
+}
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include "../src/wta/core/mpsc_ring.hpp"
+#include "../src/wta/core/string_intern.hpp"
+
+struct Record {
+    int producer{0};
+    int seq{0};
+};
+
+TEST(MpscRing, PushPopInOrder) {
+    wta::core::MpscRing<Record> ring(4);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(ring.try_push({0, i}));
+    }
+    EXPECT_FALSE(ring.try_push({0, 99}));  // 已满
+    
+    Record r{};
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(ring.try_pop(r));
+        EXPECT_EQ(r.seq, i);
+    }
+    EXPECT_FALSE(ring.try_pop(r));
+}
+
+TEST(MpscRing, CapacityRoundsUpToPowerOfTwo) {
+    wta::core::MpscRing<Record> ring(5);
+    EXPECT_EQ(ring.capacity(), 8u);
+}
+
+TEST(MpscRing, MultipleProducers) {
+    constexpr int kProducers = 4;
+    constexpr int kPerProducer = 10000;
+    wta::core::MpscRing<Record> ring(1024);
+    
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&, p] {
+            for (int i = 0; i < kPerProducer; ++i) {
+                while (!ring.try_push({p, i})) std::this_thread::yield();
+            }
+        });
+    }
+    
+    // 每个生产者的记录应按顺序到达
+    std::vector<int> next(kProducers, 0);
+    int received = 0;
+    Record r{};
+    while (received < kProducers * kPerProducer) {
+        if (ring.try_pop(r)) {
+            EXPECT_EQ(r.seq, next[r.producer]);
+            next[r.producer] = r.seq + 1;
+            ++received;
+        }
+    }
+    for (auto& th : producers) th.join();
+}
+
+TEST(StringInterner, StableIds) {
+    wta::core::StringInterner table;
+    const auto a = table.intern("missiles_SCALPEL");
+    const auto b = table.intern("GBU12BombLauncher");
+    EXPECT_NE(a, b);
+    EXPECT_EQ(table.intern("missiles_SCALPEL"), a);
+    EXPECT_EQ(table.lookup(b), "GBU12BombLauncher");
+    EXPECT_EQ(table.size(), 2u);
+}
+
+TEST(StringInterner, EmptyAndUnknown) {
+    wta::core::StringInterner table;
+    EXPECT_EQ(table.intern(""), wta::core::kInvalidInternId);
+    EXPECT_TRUE(table.lookup(42).empty());
+}
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include "wta/orchestrator/partitioner.hpp"
+#include "wta/record/record_codec.hpp"
+
+using namespace wta::orch;
+
+namespace {
+
+wta::types::PlatformState platform(int id, float x, float range) {
+    wta::types::PlatformState p;
+    p.id = id;
+    p.pos = {x, 0.f};
+    p.max_range = range;
+    return p;
+}
+
+wta::types::TargetState target(int id, float x, std::vector<int> prereqs = {}) {
+    wta::types::TargetState t;
+    t.id = id;
+    t.pos = {x, 0.f};
+    t.prerequisite_targets = std::move(prereqs);
+    return t;
+}
+
+// 两组相距很远的平台/目标，外加一个射程外的前置目标
+wta::proto::PlanRequest make_request() {
+    wta::proto::PlanRequest req;
+    req.snapshot_version = 9;
+    req.platforms = {platform(1, 0.f, 1000.f), platform(2, 50000.f, 1000.f), platform(3, 100.f, 1000.f)};
+    req.targets = {target(1, 500.f), target(2, 50500.f, {3}), target(3, 90000.f)};
+    return req;
+}
+
+} // namespace
+
+TEST(PartitionerTest, SplitsByRangeAndMergesPrerequisites) {
+    const auto req = make_request();
+    const auto clusters = partition_world(req);
+    ASSERT_EQ(clusters.size(), 2u);
+    EXPECT_EQ(clusters[0].platforms, (std::vector<size_t>{0, 2}));
+    EXPECT_EQ(clusters[0].targets, (std::vector<size_t>{0}));
+    EXPECT_EQ(clusters[1].platforms, (std::vector<size_t>{1}));
+    // 目标 3 不在任何射程内，但作为目标 2 的前置随同一簇发出
+    EXPECT_EQ(clusters[1].targets, (std::vector<size_t>{1, 2}));
+
+    auto all = req;
+    all.config.model.enable_distance_constraint = false;
+    EXPECT_EQ(partition_world(all).size(), 1u);
+
+    const auto packed = pack_clusters(clusters, 1);
+    ASSERT_EQ(packed.size(), 1u);
+    EXPECT_EQ(packed[0].platforms, (std::vector<size_t>{0, 1, 2}));
+}
+
+TEST(PartitionerTest, StitchesClusterPlansIntoGlobalMatrix) {
+    const auto req = make_request();
+    const auto clusters = partition_world(req);
+    ASSERT_EQ(clusters.size(), 2u);
+
+    std::vector<wta::proto::PlanResponse> parts(2);
+    for (size_t k = 0; k < 2; ++k) {
+        const auto sub = make_cluster_request(req, clusters[k]);
+        EXPECT_EQ(sub.snapshot_version, 9u);
+        parts[k].status = "ok";
+        parts[k].n_platforms = sub.platforms.size();
+        parts[k].n_targets = sub.targets.size();
+        parts[k].assignment.assign(parts[k].n_platforms * parts[k].n_targets, 0);
+        parts[k].assignment[0] = 1;   // 每簇第一个平台打第一个目标
+        parts[k].best_fitness = 1.0;
+        parts[k].ttl_sec = 2.0 + static_cast<double>(k);
+    }
+
+    wta::proto::PlanResponse out;
+    ASSERT_TRUE(stitch_plans(req, clusters, parts, out));
+    EXPECT_EQ(out.n_platforms, 3u);
+    EXPECT_EQ(out.n_targets, 3u);
+    EXPECT_EQ(out.assignment, (std::vector<uint8_t>{1, 0, 0,
+                                                    0, 1, 0,
+                                                    0, 0, 0}));
+    EXPECT_DOUBLE_EQ(out.best_fitness, 2.0);
+    EXPECT_DOUBLE_EQ(out.ttl_sec, 2.0);
+
+    parts[1].status = "error";
+    EXPECT_FALSE(stitch_plans(req, clusters, parts, out));
+}
+
+TEST(PartitionerTest, CarriesFollowOnsThroughClustersAndCodec) {
+    auto req = make_request();
+    req.max_follow_ons = 2;
+    const auto clusters = partition_world(req);
+    ASSERT_EQ(clusters.size(), 2u);
+
+    std::vector<wta::proto::PlanResponse> parts(2);
+    for (size_t k = 0; k < 2; ++k) {
+        const auto sub = make_cluster_request(req, clusters[k]);
+        EXPECT_EQ(sub.max_follow_ons, 2);
+        parts[k].status = "ok";
+        parts[k].n_platforms = sub.platforms.size();
+        parts[k].n_targets = sub.targets.size();
+        parts[k].assignment.assign(parts[k].n_platforms * parts[k].n_targets, 0);
+    }
+    // 簇 1：平台 2 在当前目标之后先打目标 3，目标 3 被摧毁后再打目标 2（实体 ID）
+    parts[1].follow_ons.push_back({2, {{3, 0}, {2, 3}}});
+
+    wta::proto::PlanResponse out;
+    ASSERT_TRUE(stitch_plans(req, clusters, parts, out));
+    ASSERT_EQ(out.follow_ons.size(), 1u);
+    EXPECT_EQ(out.follow_ons[0].platform_id, 2);
+
+    // 拼接后的方案经录制编解码后后续交战不变
+    std::vector<uint8_t> buf;
+    wta::record::ByteWriter w(buf);
+    wta::record::encode(w, out);
+    wta::record::ByteReader r(buf.data(), buf.size());
+    wta::proto::PlanResponse back;
+    wta::record::decode(r, back);
+    ASSERT_TRUE(r.ok());
+    EXPECT_EQ(r.remaining(), 0u);
+    ASSERT_EQ(back.follow_ons.size(), 1u);
+    EXPECT_EQ(back.follow_ons[0].platform_id, 2);
+    ASSERT_EQ(back.follow_ons[0].steps.size(), 2u);
+    EXPECT_EQ(back.follow_ons[0].steps[1].target_id, 2);
+    EXPECT_EQ(back.follow_ons[0].steps[1].after_target_id, 3);
+}
@@ -0,0 +1,37 @@
+#include <gtest/gtest.h>
+#include "wta/core/pipeline_trace.hpp"
+
+using namespace wta::core;
+
+TEST(PipelineTraceTest, AttributesSkippedStagesToNextReached) {
+    TraceContext ctx;
+    ctx.id = 1;
+    ctx.origin = 10.0;
+    ctx.mark(TraceStage::Pickup, 10.001);
+    ctx.mark(TraceStage::Sample, 10.011);      // Trigger 未经过，10ms 计入 Sample
+    ctx.mark(TraceStage::RoundTrip, 10.211);
+    ctx.mark(TraceStage::FirstCommand, 10.261);
+
+    PipelineTrace trace;
+    trace.record(ctx);
+    EXPECT_EQ(trace.stage(TraceStage::Trigger).count(), 0u);
+    EXPECT_NEAR(static_cast<double>(trace.stage(TraceStage::Sample).max_us()), 10000.0, 2.0);
+    EXPECT_NEAR(static_cast<double>(trace.stage(TraceStage::RoundTrip).max_us()), 200000.0, 2.0);
+    EXPECT_NEAR(static_cast<double>(trace.total().max_us()), 261000.0, 2.0);
+
+    // 未追踪的上下文不计入
+    trace.record(TraceContext{});
+    EXPECT_EQ(trace.total().count(), 1u);
+}
+
+TEST(PipelineTraceTest, ScopeRoutesMarksToCurrentThreadTrace) {
+    TraceContext ctx;
+    ctx.id = 7;
+    trace_mark(TraceStage::Serialize);   // 无当前追踪：空操作
+    {
+        TraceScope scope(&ctx);
+        trace_mark(TraceStage::Serialize);
+    }
+    EXPECT_TRUE(ctx.reached(TraceStage::Serialize));
+    EXPECT_EQ(current_trace(), nullptr);
+}
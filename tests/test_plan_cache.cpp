@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include "wta/orchestrator/plan_cache.hpp"
+
+using namespace wta::orch;
+
+namespace {
+
+wta::proto::PlanRequest make_request(float x) {
+    wta::proto::PlanRequest req;
+    wta::types::PlatformState p;
+    p.id = 1;
+    p.pos = {x, 100.f};
+    p.ammo.missile = 2;
+    wta::types::TargetState t;
+    t.id = 1;
+    t.pos = {1000.f, 1000.f};
+    t.value = 10.f;
+    req.platforms = {p};
+    req.targets = {t};
+    return req;
+}
+
+wta::proto::PlanResponse make_response(double fitness) {
+    wta::proto::PlanResponse resp;
+    resp.status = "ok";
+    resp.best_fitness = fitness;
+    return resp;
+}
+
+} // namespace
+
+TEST(PlanCacheTest, HashIgnoresSubGridMovementOnly) {
+    const auto base = hash_plan_inputs(make_request(10.f), 50.f);
+    EXPECT_EQ(hash_plan_inputs(make_request(40.f), 50.f), base);
+    EXPECT_NE(hash_plan_inputs(make_request(60.f), 50.f), base);
+
+    auto fired = make_request(10.f);
+    fired.platforms[0].ammo.missile = 1;
+    EXPECT_NE(hash_plan_inputs(fired, 50.f), base);
+
+    auto killed = make_request(10.f);
+    killed.targets[0].alive = false;
+    EXPECT_NE(hash_plan_inputs(killed, 50.f), base);
+
+    // 求解预算由调参器事后决定，不影响键
+    auto tuned = make_request(10.f);
+    tuned.config.bpso.n_particles = 100;
+    tuned.config.bpso.n_iterations = 7;
+    EXPECT_EQ(hash_plan_inputs(tuned, 50.f), base);
+
+    auto weighted = make_request(10.f);
+    weighted.config.model.weights.cost += 1.0;
+    EXPECT_NE(hash_plan_inputs(weighted, 50.f), base);
+}
+
+TEST(PlanCacheTest, LruEvictionAndExpiry) {
+    PlanCacheOptions opts;
+    opts.capacity = 2;
+    opts.max_age_sec = 10.0;
+    PlanCache cache(opts);
+    cache.insert(1, make_response(1.0), 0.0);
+    cache.insert(2, make_response(2.0), 0.0);
+    ASSERT_NE(cache.find(1, 1.0), nullptr);   // 1 变为最近使用
+    cache.insert(3, make_response(3.0), 1.0); // 淘汰 2
+    EXPECT_EQ(cache.find(2, 1.0), nullptr);
+    const auto* hit = cache.find(3, 2.0);
+    ASSERT_NE(hit, nullptr);
+    EXPECT_DOUBLE_EQ(hit->best_fitness, 3.0);
+    EXPECT_EQ(cache.find(1, 20.0), nullptr);  // 过期
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT_EQ(cache.hits(), 2u);
+    EXPECT_EQ(cache.misses(), 2u);
+    EXPECT_DOUBLE_EQ(cache.hit_rate(), 0.5);
+}
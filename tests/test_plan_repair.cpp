@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include "wta/orchestrator/plan_repair.hpp"
+
+using wta::orch::PlanRepair;
+
+namespace {
+
+wta::world::WorldSnapshot make_world() {
+    // 平台 1/2 在原点附近；目标 1 在 (500,0)，目标 2 在 (1000,0)，目标 3 远在射程外
+    wta::world::WorldSnapshot w;
+    w.version = 1;
+    for (int i = 1; i <= 2; ++i) {
+        wta::types::PlatformState p;
+        p.id = i;
+        p.hit_prob = 0.8f;
+        p.max_range = 3000.f;
+        w.platforms.push_back(p);
+    }
+    const float xs[] = {500.f, 1000.f, 9000.f};
+    for (int j = 1; j <= 3; ++j) {
+        wta::types::TargetState t;
+        t.id = j;
+        t.value = 10.f;
+        t.pos = {xs[j - 1], 0.f};
+        w.targets.push_back(t);
+    }
+    return w;
+}
+
+// 平台 1 -> 目标 1，平台 2 -> 目标 2
+wta::proto::PlanResponse make_plan() {
+    wta::proto::PlanResponse resp;
+    resp.status = "ok";
+    resp.n_platforms = 2;
+    resp.n_targets = 3;
+    resp.assignment = {1, 0, 0,
+                       0, 1, 0};
+    return resp;
+}
+
+} // namespace
+
+TEST(PlanRepair, ReassignsFreedPlatformToBestReachableTarget) {
+    PlanRepair repair;
+    repair.reset(make_plan(), make_world());
+
+    const auto moves = repair.on_target_killed(1);
+    ASSERT_EQ(moves.size(), 1u);
+    EXPECT_EQ(moves[0].platform, 1);
+    EXPECT_EQ(moves[0].target, 2);   // 目标 3 超出射程
+    EXPECT_GT(moves[0].score, 0.0);
+
+    // 重复的击毁事件不再产生改派
+    EXPECT_TRUE(repair.on_target_killed(1).empty());
+}
+
+TEST(PlanRepair, RespectsPrerequisitesTypesAndFollowOns) {
+    auto world = make_world();
+    world.targets[1].prerequisite_targets = {3};        // 目标 2 需先摧毁目标 3
+    world.targets[2].pos = {800.f, 0.f};
+    world.platforms[1].target_types = {static_cast<int>(wta::types::TargetKind::Armor)};
+
+    auto plan = make_plan();
+    plan.assignment = {1, 0, 0,
+                       1, 0, 0};
+    PlanRepair repair;
+    repair.reset(plan, world);
+    const auto moves = repair.on_target_killed(1);
+    ASSERT_EQ(moves.size(), 1u);                         // 平台 2 只能打装甲目标
+    EXPECT_EQ(moves[0].platform, 1);
+    EXPECT_EQ(moves[0].target, 3);                       // 目标 2 的前置未满足
+
+    // 有后续交战队列的平台由执行器本地推进
+    plan.follow_ons = {{1, {{2, 0}}}};
+    repair.reset(plan, world);
+    EXPECT_TRUE(repair.on_target_killed(1).empty());
+}
+
+TEST(PlanRepair, SkipsDeadPlatforms) {
+    PlanRepair repair;
+    repair.reset(make_plan(), make_world());
+    repair.on_platform_killed(1);
+    EXPECT_TRUE(repair.on_target_killed(1).empty());
+}
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include "wta/orchestrator/plan_validation.hpp"
+
+using wta::orch::validate_plan;
+
+namespace {
+
+wta::world::WorldSnapshot make_world(uint64_t version, int n_plat, int n_tgt) {
+    wta::world::WorldSnapshot w;
+    w.version = version;
+    for (int i = 1; i <= n_plat; ++i) {
+        wta::types::PlatformState p;
+        p.id = i;
+        w.platforms.push_back(p);
+    }
+    for (int j = 1; j <= n_tgt; ++j) {
+        wta::types::TargetState t;
+        t.id = j;
+        w.targets.push_back(t);
+    }
+    return w;
+}
+
+// 3 平台 x 3 目标，对角线分配
+wta::proto::PlanResponse diagonal_plan() {
+    wta::proto::PlanResponse resp;
+    resp.status = "ok";
+    resp.n_platforms = 3;
+    resp.n_targets = 3;
+    resp.assignment = {1, 0, 0,
+                       0, 1, 0,
+                       0, 0, 1};
+    return resp;
+}
+
+} // namespace
+
+TEST(PlanValidation, UnchangedWorldAppliesWholePlan) {
+    auto resp = diagonal_plan();
+    const auto world = make_world(1, 3, 3);
+    const auto v = validate_plan(resp, world, world, {}, {});
+    EXPECT_EQ(v.assigned, 3u);
+    EXPECT_EQ(v.dropped, 0u);
+    EXPECT_FALSE(v.rejected);
+    EXPECT_EQ(resp.assignment, diagonal_plan().assignment);
+}
+
+TEST(PlanValidation, DropsEngagementsOfEntitiesKilledSinceSnapshot) {
+    auto resp = diagonal_plan();
+    const auto planned = make_world(1, 3, 3);
+    auto current = make_world(2, 3, 3);
+    current.targets[1].alive = false;   // 目标 2 在新快照中已死亡
+    const auto v = validate_plan(resp, planned, current, {}, {3}, 1.0);   // 目标 3 的击毁事件
+    EXPECT_EQ(v.dropped, 2u);
+    EXPECT_FALSE(v.rejected);
+    EXPECT_EQ(resp.assignment, (wta::types::AssignmentMatrix{1, 0, 0, 0, 0, 0, 0, 0, 0}));
+}
+
+TEST(PlanValidation, RejectsMostlyStalePlanWithoutModifyingIt) {
+    auto resp = diagonal_plan();
+    const auto world = make_world(1, 3, 3);
+    const auto v = validate_plan(resp, world, world, {1, 2}, {});
+    EXPECT_EQ(v.dropped, 2u);
+    EXPECT_TRUE(v.rejected);
+    EXPECT_EQ(resp.assignment, diagonal_plan().assignment);
+}
+
+TEST(PlanValidation, SameVersionIgnoresSnapshotLiveness) {
+    // 同一快照版本：规划时已看到的状态不算“之后变化”
+    auto resp = diagonal_plan();
+    auto world = make_world(5, 3, 3);
+    world.platforms.pop_back();
+    const auto v = validate_plan(resp, world, world, {}, {});
+    EXPECT_EQ(v.dropped, 0u);
+}
+
+TEST(PlanValidation, PrunesFollowOnsOfDeadEntities) {
+    auto resp = diagonal_plan();
+    resp.follow_ons = {
+        {1, {{2, 0}, {3, 2}}},   // 平台 1：打完 1 后打 2，目标 2 被毁后打 3
+        {2, {{1, 0}}},           // 平台 2 已损失：整条队列剔除
+    };
+    const auto planned = make_world(1, 3, 3);
+    auto current = make_world(2, 3, 3);
+    current.platforms[1].alive = false;
+    const auto v = validate_plan(resp, planned, current, {}, {2}, 1.0);   // 目标 2 的击毁事件
+    EXPECT_FALSE(v.rejected);
+    EXPECT_EQ(v.follow_ons_dropped, 2u);
+    ASSERT_EQ(resp.follow_ons.size(), 1u);
+    ASSERT_EQ(resp.follow_ons[0].steps.size(), 1u);
+    EXPECT_EQ(resp.follow_ons[0].steps[0].target_id, 3);         // 前置已满足的步骤保留
+    EXPECT_EQ(resp.follow_ons[0].steps[0].after_target_id, 2);
+}
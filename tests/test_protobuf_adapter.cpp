@@ -232,6 +232,10 @@ TEST(ProtobufAdapter, PlanRequestSerialization) {
     PlanRequest request;
     request.timestamp = 123456.789;
     request.reason = "event_triggered";
+    request.snapshot_version = 42;
+    request.config.bpso.n_particles = 120;
+    request.config.bpso.n_iterations = 30;
+    request.config.model.enable_distance_constraint = false;
     
     PlatformState platform;
     platform.id = 1;
@@ -253,6 +257,12 @@ TEST(ProtobufAdapter, PlanRequestSerialization) {
     const auto& pb_req = msg.plan_request();
     EXPECT_DOUBLE_EQ(pb_req.timestamp(), 123456.789);
     EXPECT_EQ(pb_req.reason(), "event_triggered");
+    EXPECT_EQ(pb_req.snapshot_version(), 42u);
+    EXPECT_EQ(pb_req.config().bpso().n_particles(), 120);
+    EXPECT_EQ(pb_req.config().bpso().n_iterations(), 30);
+    EXPECT_FALSE(pb_req.config().bpso().has_seed());
+    EXPECT_FALSE(pb_req.config().model().enable_distance_constraint());
+    EXPECT_FLOAT_EQ(pb_req.config().model().weights().value(), 0.7f);
     EXPECT_EQ(pb_req.platforms_size(), 1);
     EXPECT_EQ(pb_req.targets_size(), 1);
 }
@@ -266,6 +276,7 @@ TEST(ProtobufAdapter, PlanResponseDeserialization) {
     pb_resp.set_n_platforms(2);
     pb_resp.set_n_targets(3);
     pb_resp.set_ttl_sec(2.0);
+    pb_resp.set_snapshot_version(42);
     
     (*pb_resp.mutable_assignment())[1] = 10;
     (*pb_resp.mutable_assignment())[2] = 11;
@@ -291,6 +302,7 @@ TEST(ProtobufAdapter, PlanResponseDeserialization) {
     EXPECT_EQ(response.n_platforms, 2);
     EXPECT_EQ(response.n_targets, 3);
     EXPECT_DOUBLE_EQ(response.ttl_sec, 2.0);
+    EXPECT_EQ(response.snapshot_version, 42u);
     EXPECT_EQ(response.assignment.size(), 2);
     EXPECT_EQ(response.assignment[1], 10);
     EXPECT_EQ(response.assignment[2], 11);
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include "wta/orchestrator/replan_trigger.hpp"
+
+#include <cmath>
+
+using namespace wta::orch;
+using wta::events::Event;
+using wta::events::EventType;
+
+namespace {
+
+wta::world::WorldSnapshot make_world() {
+    wta::world::WorldSnapshot w;
+    w.version = 1;
+    wta::types::TargetState infantry;
+    infantry.id = 1;
+    infantry.value = 5.f;
+    infantry.tier = 2;
+    wta::types::TargetState radar;
+    radar.id = 2;
+    radar.value = 100.f;
+    radar.tier = 0;
+    w.targets = {infantry, radar};
+    return w;
+}
+
+Event damage(wta::types::Id id, float dmg, bool platform = false) {
+    return {EventType::HandleDamage, wta::events::DamageEvent{id, dmg, platform}, 0.0};
+}
+
+Event killed(wta::types::Id id, bool platform = false) {
+    return {EventType::EntityKilled, wta::events::EntityKilledEvent{id, platform}, 0.0};
+}
+
+} // namespace
+
+TEST(ReplanTriggerTest, LowValueDamageAccumulatesWithoutTriggering) {
+    const auto world = make_world();
+    ReplanTrigger trig;
+    for (int i = 0; i < 10; ++i) trig.on_event(damage(1, 0.5f), &world, 1.0);
+    EXPECT_FALSE(trig.due(10.0));
+    EXPECT_GT(trig.accumulated(), 0.0);
+
+    // TTL 求解清空累计分数，这些事件都没有单独触发求解
+    trig.on_solve(10.0, false);
+    EXPECT_EQ(trig.accumulated(), 0.0);
+    EXPECT_EQ(trig.stats().absorbed, 10u);
+    EXPECT_EQ(trig.stats().triggered, 0u);
+}
+
+TEST(ReplanTriggerTest, HighValueEventsTriggerAfterDebounce) {
+    const auto world = make_world();
+    ReplanTrigger trig;
+    trig.on_event(killed(2), &world, 1.0);
+    EXPECT_FALSE(trig.due(1.0));
+    // 去抖窗口内的后续事件并入同一批，不推迟触发
+    trig.on_event(killed(7, true), &world, 1.05);
+    EXPECT_DOUBLE_EQ(trig.due_at(), 1.0 + trig.options().debounce_sec);
+    EXPECT_TRUE(trig.due(1.2));
+
+    trig.on_solve(1.2, true);
+    EXPECT_EQ(trig.stats().triggered, 1u);
+    EXPECT_EQ(trig.stats().absorbed, 1u);
+    EXPECT_FALSE(trig.due(100.0));
+}
+
+TEST(ReplanTriggerTest, HysteresisRaisesThresholdAfterTrigger) {
+    const auto world = make_world();
+    ReplanTrigger trig;
+    trig.on_event(killed(7, true), &world, 0.0);
+    trig.on_solve(0.2, true);
+    EXPECT_GT(trig.threshold_at(0.3), trig.options().threshold);
+    EXPECT_DOUBLE_EQ(trig.threshold_at(0.2 + trig.options().hysteresis_sec), trig.options().threshold);
+
+    // 刚触发过：单个平台损失不足以越过上浮的阈值
+    trig.on_event(killed(8, true), &world, 0.3);
+    EXPECT_FALSE(std::isfinite(trig.due_at()));
+
+    // ReplanRequest 不受阈值约束
+    trig.on_event({EventType::ReplanRequest, wta::events::EntityKilledEvent{}, 0.0}, &world, 0.4);
+    EXPECT_TRUE(trig.due(0.4));
+    EXPECT_EQ(trig.stats().forced, 1u);
+}
+
+TEST(ReplanTriggerTest, KeepsCurrentPlanWithoutMinimumImprovement) {
+    ReplanTrigger trig;
+    wta::proto::PlanResponse current;
+    current.n_platforms = 2;
+    current.n_targets = 3;
+    current.best_fitness = 10.0;
+
+    auto candidate = current;
+    candidate.best_fitness = 10.1;   // 提升 1%，低于默认 2%
+    EXPECT_FALSE(trig.should_replace(current, candidate));
+    EXPECT_EQ(trig.stats().kept, 1u);
+
+    candidate.best_fitness = 10.5;
+    EXPECT_TRUE(trig.should_replace(current, candidate));
+
+    // 规模变化（如目标被摧毁）总是替换
+    candidate.best_fitness = 9.0;
+    candidate.n_targets = 2;
+    EXPECT_TRUE(trig.should_replace(current, candidate));
+    EXPECT_EQ(trig.stats().kept, 1u);
+}
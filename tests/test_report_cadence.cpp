@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+#include "wta/orchestrator/report_cadence.hpp"
+
+using namespace std::chrono_literals;
+using wta::orch::CadenceReason;
+using wta::orch::ReportCadence;
+using wta::orch::WorldDelta;
+
+namespace {
+
+wta::world::WorldSnapshot make_world(int n) {
+    wta::world::WorldSnapshot w;
+    for (int i = 1; i <= n; ++i) {
+        wta::types::PlatformState p;
+        p.id = i;
+        p.ammo.missile = 4;
+        w.platforms.push_back(p);
+        wta::types::TargetState t;
+        t.id = i;
+        w.targets.push_back(t);
+    }
+    return w;
+}
+
+} // namespace
+
+TEST(ReportCadence, DiffWorldsCountsMovesDeathsAndAmmo) {
+    const auto prev = make_world(4);
+    auto cur = prev;
+    cur.platforms[0].pos.x += 10.f;        // 移动
+    cur.platforms[1].pos.x += 1.f;         // 小于 epsilon
+    cur.platforms[2].ammo.missile = 3;     // 弹药变化
+    cur.targets[0].alive = false;          // 死亡
+    cur.targets.pop_back();                // 消失
+    const auto d = wta::orch::diff_worlds(prev, cur, 5.f);
+    EXPECT_EQ(d.moved, 1);
+    EXPECT_EQ(d.ammo_changed, 1);
+    EXPECT_EQ(d.died, 2);
+}
+
+TEST(ReportCadence, SlowsDownWhenQuietAndJumpsToFastestInCombat) {
+    ReportCadence cadence;
+    const auto& opts = cadence.options();
+    for (int i = 0; i < 20; ++i) cadence.on_report({}, true, 1ms);
+    EXPECT_EQ(cadence.interval(), opts.max_interval);
+    EXPECT_EQ(cadence.reason(), CadenceReason::Quiet);
+
+    WorldDelta kill;
+    kill.died = 1;
+    EXPECT_EQ(cadence.on_report(kill, true, 1ms), opts.min_interval);
+    EXPECT_EQ(cadence.reason(), CadenceReason::Combat);
+
+    WorldDelta small;
+    small.moved = 1;
+    cadence.on_report({}, true, 1ms);
+    const auto before = cadence.interval();
+    EXPECT_LT(cadence.on_report(small, true, 1ms), before);
+    EXPECT_EQ(cadence.reason(), CadenceReason::Changing);
+}
+
+TEST(ReportCadence, BacksOffOnFailedOrSlowSends) {
+    ReportCadence cadence;
+    cadence.on_engagement_event();
+    const auto fast = cadence.interval();
+    EXPECT_EQ(cadence.on_report({}, false, 1ms), fast * 2);
+    EXPECT_EQ(cadence.reason(), CadenceReason::Backpressure);
+    EXPECT_EQ(cadence.on_report({}, true, 1s), fast * 4);
+    EXPECT_STREQ(wta::orch::to_string(cadence.reason()), "backpressure");
+}
@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+#include "wta/core/runtime_params.hpp"
+
+using namespace wta::core;
+
+TEST(RuntimeParamsTest, SetAndGetAppliesToTunables) {
+    Tunables t;
+    RuntimeParams params(t);
+
+    EXPECT_EQ(params.set("exec.tick_ms", "20", "test"), "");
+    EXPECT_EQ(t.exec_tick_ms.load(), 20);
+    EXPECT_EQ(params.set("sequential_attack_test", "false", "test"), "");
+    EXPECT_FALSE(t.sequential_attack_test.load());
+
+    std::string v;
+    ASSERT_TRUE(params.get("exec.tick_ms", v));
+    EXPECT_EQ(v, "20");
+    EXPECT_EQ(params.execute("get solve.timeout_ms", "test"), "ok solve.timeout_ms=1000");
+}
+
+TEST(RuntimeParamsTest, RejectsUnknownTypeAndRangeErrors) {
+    Tunables t;
+    RuntimeParams params(t);
+
+    EXPECT_NE(params.set("no.such_param", "1", "test"), "");
+    EXPECT_NE(params.set("exec.tick_ms", "fast", "test"), "");
+    EXPECT_NE(params.set("exec.tick_ms", "-5", "test"), "");
+    EXPECT_EQ(t.exec_tick_ms.load(), 50);
+    EXPECT_EQ(params.execute("set exec.tick_ms", "test").rfind("error", 0), 0u);
+    EXPECT_TRUE(params.audit().empty());
+}
+
+TEST(RuntimeParamsTest, AuditsEachChange) {
+    Tunables t;
+    RuntimeParams params(t);
+    int sunk = 0;
+    params.set_audit_sink([&](const ParamChange&) { ++sunk; });
+
+    params.execute("set solve.throttle_ms 250", "tcp://peer");
+    params.execute("set solve.throttle_ms 300", "tcp://peer");
+
+    auto log = params.audit();
+    ASSERT_EQ(log.size(), 2u);
+    EXPECT_EQ(log[0].name, "solve.throttle_ms");
+    EXPECT_EQ(log[0].old_value, "500");
+    EXPECT_EQ(log[0].new_value, "250");
+    EXPECT_EQ(log[1].old_value, "250");
+    EXPECT_EQ(log[1].source, "tcp://peer");
+    EXPECT_EQ(sunk, 2);
+}
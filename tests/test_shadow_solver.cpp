@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include "wta/orchestrator/shadow_solver.hpp"
+
+using namespace wta::orch;
+using namespace std::chrono_literals;
+using std::chrono::milliseconds;
+
+namespace {
+
+wta::proto::PlanResponse make_plan(std::vector<uint8_t> assignment, double fitness) {
+    wta::proto::PlanResponse r;
+    r.status = "ok";
+    r.n_platforms = 2;
+    r.n_targets = 2;
+    r.assignment = std::move(assignment);
+    r.best_fitness = fitness;
+    return r;
+}
+
+// 候选求解器：返回固定方案，release 之前阻塞
+struct FakeSolver final : wta::net::ISolverClient {
+    wta::proto::PlanResponse reply;
+    std::atomic<bool> release{false};
+
+    bool request_plan(const wta::proto::PlanRequest&, wta::proto::PlanResponse& out, milliseconds) override {
+        while (!release) std::this_thread::sleep_for(1ms);
+        out = reply;
+        return true;
+    }
+    bool report_status(const wta::proto::StatusReportEvent&, milliseconds) override { return true; }
+    bool report_killed(const wta::proto::EntityKilledEvent&, milliseconds) override { return true; }
+    bool report_damage(const wta::proto::DamageEvent&, milliseconds) override { return true; }
+    bool report_fired(const wta::proto::FiredEvent&, milliseconds) override { return true; }
+    bool send_log(const wta::proto::LogMessage&, milliseconds) override { return true; }
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+    bool solve(const wta::proto::SolveRequest&, wta::proto::SolveResponse&, milliseconds) override { return false; }
+#pragma GCC diagnostic pop
+};
+
+template <class Pred>
+bool wait_for(Pred pred) {
+    for (int i = 0; i < 2000 && !pred(); ++i) std::this_thread::sleep_for(1ms);
+    return pred();
+}
+
+} // namespace
+
+TEST(ShadowSolver, AgreementComparesFirstTargetPerPlatform) {
+    const auto a = make_plan({1, 0, 0, 1}, 0.0);
+    EXPECT_DOUBLE_EQ(assignment_agreement(a, a), 1.0);
+    EXPECT_DOUBLE_EQ(assignment_agreement(a, make_plan({1, 0, 1, 0}, 0.0)), 0.5);
+    EXPECT_DOUBLE_EQ(assignment_agreement(make_plan({0, 0, 0, 0}, 0.0), make_plan({0, 0, 0, 0}, 0.0)), 1.0);
+    auto other = a;
+    other.n_targets = 1;
+    EXPECT_DOUBLE_EQ(assignment_agreement(a, other), 0.0);
+}
+
+TEST(ShadowSolver, ComparesWithoutBlockingPrimaryAndSkipsWhileBusy) {
+    FakeSolver fake;
+    fake.reply = make_plan({1, 0, 1, 0}, 7.0);
+    std::vector<ShadowComparison> seen;
+    std::mutex m;
+    ShadowSolver shadow(fake, [&](const ShadowComparison& c) {
+        std::lock_guard<std::mutex> lk(m);
+        seen.push_back(c);
+    });
+    shadow.start();
+
+    const uint64_t id = shadow.submit({}, 1000ms);
+    ASSERT_NE(id, 0u);
+    // 主求解先完成：不等待影子
+    shadow.primary_done(id, true, make_plan({1, 0, 0, 1}, 5.0), 0.02);
+    EXPECT_EQ(shadow.compared(), 0u);
+    // 影子在途时的新请求被跳过
+    EXPECT_EQ(shadow.submit({}, 1000ms), 0u);
+    EXPECT_EQ(shadow.skipped(), 1u);
+
+    fake.release = true;
+    ASSERT_TRUE(wait_for([&] { return shadow.compared() == 1; }));
+    shadow.stop();
+
+    ASSERT_EQ(seen.size(), 1u);
+    EXPECT_TRUE(seen[0].primary_ok);
+    EXPECT_TRUE(seen[0].shadow_ok);
+    EXPECT_DOUBLE_EQ(seen[0].agreement, 0.5);
+    EXPECT_DOUBLE_EQ(shadow.mean_fitness_delta(), 2.0);
+    EXPECT_EQ(shadow.primary_latency().count(), 1u);
+    EXPECT_EQ(shadow.shadow_latency().count(), 1u);
+}
@@ -0,0 +1,37 @@
+#include <gtest/gtest.h>
+#include "../src/wta/core/slice_budget.hpp"
+
+using wta::core::SliceBudget;
+using namespace std::chrono_literals;
+
+TEST(SliceBudget, StopsBeforeNextItemWouldExceedBudget) {
+    SliceBudget budget(100us);
+    const auto t0 = SliceBudget::clock::now();
+    budget.begin(t0);
+    int processed = 0;
+    bool more = true;
+    while (more) {
+        ++processed;
+        more = budget.next(t0 + processed * 10us);
+    }
+    // 每项 10us：处理到 90us 时再来一项就会到 100us，仍在预算内；100us 时停止
+    EXPECT_EQ(processed, 10);
+    EXPECT_EQ(budget.items(), 10u);
+    EXPECT_NEAR(budget.estimate_us(), 10.0, 1e-9);
+}
+
+TEST(SliceBudget, ExpensiveItemEndsSliceAndEstimateCarriesOver) {
+    SliceBudget budget(100us);
+    const auto t0 = SliceBudget::clock::now();
+    budget.begin(t0);
+    // 单项 60us：再来一项预计 120us，本片结束
+    EXPECT_FALSE(budget.next(t0 + 60us));
+
+    // 下一片沿用估算：第一项只花 10us，估算平滑回落但仍偏保守
+    const auto t1 = t0 + 1ms;
+    budget.begin(t1);
+    EXPECT_TRUE(budget.next(t1 + 10us));
+    EXPECT_NEAR(budget.estimate_us(), 47.5, 1e-9);
+    EXPECT_FALSE(budget.next(t1 + 60us));
+    EXPECT_EQ(budget.items(), 2u);
+}
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "wta/world/snapshot_service.hpp"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+struct CountingSampler final : wta::world::IWorldSampler {
+    std::atomic<int> calls{0};
+    std::chrono::milliseconds hold{0};
+
+    void sample(wta::proto::SolveRequest& io_req) override {
+        const int n = ++calls;
+        if (hold.count() > 0) std::this_thread::sleep_for(hold);
+        wta::types::PlatformState p;
+        p.id = n;
+        io_req.platforms = {p};
+    }
+
+    wta::world::SamplerStats stats() const override {
+        wta::world::SamplerStats st;
+        st.samples = static_cast<uint64_t>(calls.load());
+        st.cache_hits = 3 * st.samples;
+        st.cache_misses = st.samples;
+        st.engine_calls = 10 * st.samples;
+        return st;
+    }
+};
+
+} // namespace
+
+TEST(SnapshotService, ReusesFreshSnapshotWithinMaxAge) {
+    CountingSampler sampler;
+    wta::world::SnapshotService svc(sampler);
+    EXPECT_EQ(svc.latest()->version, 0u);
+
+    const auto a = svc.acquire(10s);
+    const auto b = svc.acquire(10s);
+    EXPECT_EQ(sampler.calls.load(), 1);
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(a->version, 1u);
+    EXPECT_EQ(svc.reuses(), 1u);
+
+    // 过旧则重新采样，旧快照仍然可用
+    std::this_thread::sleep_for(5ms);
+    const auto c = svc.acquire(1ms);
+    EXPECT_EQ(sampler.calls.load(), 2);
+    EXPECT_EQ(c->version, 2u);
+    EXPECT_EQ(a->platforms[0].id, 1);
+    EXPECT_EQ(svc.latest(), c);
+}
+
+TEST(SnapshotService, NotBeforeForcesSampleAfterEvent) {
+    CountingSampler sampler;
+    wta::world::SnapshotService svc(sampler);
+    const auto a = svc.acquire(10s);
+    const double event_ts = wta::world::SnapshotService::now_sec();
+    const auto b = svc.acquire(10s, event_ts);
+    EXPECT_EQ(sampler.calls.load(), 2);
+    EXPECT_GE(b->timestamp, event_ts);
+    EXPECT_GT(b->version, a->version);
+}
+
+TEST(SnapshotService, AgeCountsFromSampleEnd) {
+    CountingSampler sampler;
+    sampler.hold = 50ms;
+    wta::world::SnapshotService svc(sampler);
+    // 采样本身比 max_age 长：刚完成的快照仍应复用，而不是按开始时刻判为过期
+    const auto a = svc.acquire(40ms);
+    EXPECT_GE(a->end_timestamp - a->timestamp, 0.05);
+    const auto b = svc.acquire(40ms);
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(sampler.calls.load(), 1);
+}
+
+TEST(SnapshotService, ConcurrentRequestsShareOneSample) {
+    CountingSampler sampler;
+    sampler.hold = 20ms;
+    wta::world::SnapshotService svc(sampler);
+
+    std::vector<std::thread> threads;
+    std::vector<uint64_t> versions(4);
+    for (size_t i = 0; i < versions.size(); ++i) {
+        threads.emplace_back([&, i] { versions[i] = svc.acquire(1s)->version; });
+    }
+    for (auto& t : threads) t.join();
+    EXPECT_EQ(sampler.calls.load(), 1);
+    for (auto v : versions) EXPECT_EQ(v, 1u);
+    EXPECT_EQ(svc.sample_time().count(), 1u);
+}
+
+TEST(SnapshotService, ForwardsSamplerCacheStats) {
+    CountingSampler sampler;
+    wta::world::SnapshotService svc(sampler);
+    EXPECT_DOUBLE_EQ(svc.sampler_stats().hit_rate(), 0.0);
+    EXPECT_DOUBLE_EQ(svc.sampler_stats().calls_per_sample(), 0.0);
+
+    svc.refresh();
+    svc.refresh();
+    const auto st = svc.sampler_stats();
+    EXPECT_EQ(st.samples, 2u);
+    EXPECT_DOUBLE_EQ(st.hit_rate(), 0.75);
+    EXPECT_DOUBLE_EQ(st.calls_per_sample(), 10.0);
+}
@@ -0,0 +1,40 @@
+#include <gtest/gtest.h>
+#include "wta/orchestrator/solve_tuner.hpp"
+
+using namespace wta::orch;
+
+TEST(SolveTunerTest, LearnsCostModelFromObservations) {
+    SolveTuner tuner;
+    // 模拟求解器：固定开销 20ms + 每单位 2e-8 s
+    auto solver_time = [](size_t np, size_t nt, int p, int i) {
+        return 0.02 + 2e-8 * static_cast<double>(p) * i * static_cast<double>(np * nt);
+    };
+    tuner.observe(5, 10, 500, 50, solver_time(5, 10, 500, 50));
+    tuner.observe(20, 40, 200, 30, solver_time(20, 40, 200, 30));
+    tuner.observe(50, 80, 100, 20, solver_time(50, 80, 100, 20));
+    EXPECT_NEAR(tuner.intercept(), 0.02, 1e-3);
+    EXPECT_NEAR(tuner.slope(), 2e-8, 1e-10);
+
+    // 小问题预算充足：用满上限
+    const auto small = tuner.tune(5, 10);
+    EXPECT_EQ(small.n_particles, tuner.options().max_particles);
+    EXPECT_EQ(small.n_iterations, tuner.options().max_iterations);
+
+    // 大问题缩小规模，预测耗时不超过截止时间
+    const auto large = tuner.tune(100, 200);
+    EXPECT_LT(large.n_particles, tuner.options().max_particles);
+    EXPECT_LE(large.predicted_sec, tuner.options().deadline_sec + 1e-6);
+    EXPECT_NEAR(solver_time(100, 200, large.n_particles, large.n_iterations), large.predicted_sec, 1e-3);
+}
+
+TEST(SolveTunerTest, ClampsToMinimumWhenBudgetTooSmall) {
+    SolveTunerOptions opts;
+    opts.deadline_sec = 0.01;
+    SolveTuner tuner(opts);
+    wta::config::BPSOConfig bpso;
+    const auto d = tuner.apply(bpso, 500, 500);
+    EXPECT_TRUE(d.clamped);
+    EXPECT_EQ(bpso.n_particles, opts.min_particles);
+    EXPECT_EQ(bpso.n_iterations, opts.min_iterations);
+    EXPECT_FLOAT_EQ(bpso.w_max, wta::config::BPSOConfig{}.w_max);
+}
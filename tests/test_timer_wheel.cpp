@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include "wta/core/timer_wheel.hpp"
+
+#include <atomic>
+#include <future>
+#include <vector>
+
+using wta::core::TimerWheel;
+using wta::core::TimerId;
+using namespace std::chrono_literals;
+
+TEST(TimerWheelTest, OneShotFiresWhenDue) {
+    TimerWheel wheel;
+    const auto t0 = TimerWheel::clock::now();
+    int fired = 0;
+    wheel.schedule_at(t0 + 10ms, [&]{ ++fired; });
+    EXPECT_EQ(wheel.pending(), 1u);
+
+    EXPECT_EQ(wheel.advance_to(t0 + 5ms), 0u);
+    EXPECT_EQ(fired, 0);
+    EXPECT_EQ(wheel.advance_to(t0 + 11ms), 1u);
+    EXPECT_EQ(fired, 1);
+    EXPECT_EQ(wheel.pending(), 0u);
+
+    // 一次性定时器不会再次触发
+    EXPECT_EQ(wheel.advance_to(t0 + 500ms), 0u);
+    EXPECT_EQ(fired, 1);
+}
+
+TEST(TimerWheelTest, FiresInDeadlineOrder) {
+    TimerWheel wheel;
+    const auto t0 = TimerWheel::clock::now();
+    std::vector<int> order;
+    wheel.schedule_at(t0 + 300ms, [&]{ order.push_back(3); });
+    wheel.schedule_at(t0 + 20ms,  [&]{ order.push_back(1); });
+    wheel.schedule_at(t0 + 120ms, [&]{ order.push_back(2); });
+
+    for (int ms = 0; ms <= 400; ms += 10) wheel.advance_to(t0 + std::chrono::milliseconds(ms));
+    EXPECT_EQ(order, (std::vector<int>{1, 2, 3}));
+}
+
+TEST(TimerWheelTest, PeriodicFiresEveryPeriod) {
+    TimerWheel wheel;
+    const auto t0 = TimerWheel::clock::now();
+    int fired = 0;
+    wheel.schedule_every(100ms, [&]{ ++fired; });
+
+    for (int ms = 0; ms <= 1050; ms += 10) wheel.advance_to(t0 + std::chrono::milliseconds(ms));
+    EXPECT_EQ(fired, 10);
+    EXPECT_EQ(wheel.pending(), 1u);
+}
+
+TEST(TimerWheelTest, CancelIsIdempotent) {
+    TimerWheel wheel;
+    const auto t0 = TimerWheel::clock::now();
+    int fired = 0;
+    TimerId id = wheel.schedule_at(t0 + 50ms, [&]{ ++fired; });
+
+    EXPECT_TRUE(wheel.cancel(id));
+    EXPECT_FALSE(wheel.cancel(id));
+    EXPECT_FALSE(wheel.cancel(wta::core::kInvalidTimer));
+    EXPECT_EQ(wheel.pending(), 0u);
+
+    wheel.advance_to(t0 + 100ms);
+    EXPECT_EQ(fired, 0);
+}
+
+TEST(TimerWheelTest, StaleIdDoesNotCancelReusedSlot) {
+    TimerWheel wheel;
+    const auto t0 = TimerWheel::clock::now();
+    int fired = 0;
+    TimerId first = wheel.schedule_at(t0 + 10ms, []{});
+    wheel.advance_to(t0 + 20ms);
+
+    // 节点被复用后旧ID应失效
+    wheel.schedule_at(t0 + 50ms, [&]{ ++fired; });
+    EXPECT_FALSE(wheel.cancel(first));
+    wheel.advance_to(t0 + 60ms);
+    EXPECT_EQ(fired, 1);
+}
+
+TEST(TimerWheelTest, LongDelayCascadesToExactTick) {
+    TimerWheel wheel;
+    const auto t0 = TimerWheel::clock::now();
+    int fired = 0;
+    wheel.schedule_at(t0 + 70s, [&]{ ++fired; });
+
+    wheel.advance_to(t0 + 69999ms);
+    EXPECT_EQ(fired, 0);
+    wheel.advance_to(t0 + 70001ms);
+    EXPECT_EQ(fired, 1);
+}
+
+TEST(TimerWheelTest, CancelFromCallbackStopsPeriodic) {
+    TimerWheel wheel;
+    const auto t0 = TimerWheel::clock::now();
+    int fired = 0;
+    TimerId id = wta::core::kInvalidTimer;
+    id = wheel.schedule_every(10ms, [&]{
+        if (++fired == 3) {
+            EXPECT_TRUE(wheel.cancel(id));
+        }
+    });
+
+    for (int ms = 0; ms <= 200; ms += 5) wheel.advance_to(t0 + std::chrono::milliseconds(ms));
+    EXPECT_EQ(fired, 3);
+    EXPECT_EQ(wheel.pending(), 0u);
+}
+
+TEST(TimerWheelTest, PublishAfterDeliversToBus) {
+    struct FakeBus {
+        std::vector<int> published;
+        void publish(int v) { published.push_back(v); }
+    } bus;
+
+    TimerWheel wheel;
+    const auto t0 = TimerWheel::clock::now();
+    wheel.publish_after(0ms, bus, 42);
+    wheel.advance_to(t0 + 5ms);
+    EXPECT_EQ(bus.published, (std::vector<int>{42}));
+}
+
+TEST(TimerWheelTest, NextWakeupTracksEarliestTimer) {
+    TimerWheel wheel;
+    EXPECT_EQ(wheel.next_wakeup(), TimerWheel::clock::time_point::max());
+
+    const auto t0 = TimerWheel::clock::now();
+    wheel.advance_to(t0);
+    wheel.schedule_at(t0 + 30ms, []{});
+    const auto wake = wheel.next_wakeup();
+    EXPECT_LE(wake, t0 + 31ms);
+    EXPECT_GE(wake + 1ms, t0 + 30ms);
+}
+
+TEST(TimerWheelTest, BackgroundThreadFiresCallbacks) {
+    TimerWheel wheel;
+    wheel.start();
+
+    std::promise<void> done;
+    auto fut = done.get_future();
+    std::atomic<int> ticks{0};
+    wheel.schedule_every(5ms, [&]{
+        if (++ticks == 3) done.set_value();
+    });
+
+    ASSERT_EQ(fut.wait_for(2s), std::future_status::ready);
+    wheel.stop();
+    EXPECT_GE(ticks.load(), 3);
+}